@@ -0,0 +1,590 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <initializer_list>
+#include <miniSTL/vector.hpp>
+
+// One node of a CompactList. A free slot is marked by m_prev == free_mark and holds no value; its
+// m_next chains the free list. Moving a slot moves its value only when it is live, which lets the
+// arena Vector relocate slots as it grows. The allocator-extended constructors are picked by
+// uses-allocator construction, so an arena allocator that supports it, such as a pmr one, rebuilds
+// the value through its own construct().
+template <class T>
+struct CompactListSlot
+{
+    static constexpr uint32_t npos = UINT32_MAX;
+    static constexpr uint32_t free_mark = UINT32_MAX - 1;
+
+    uint32_t m_next;
+    uint32_t m_prev;
+    union
+    {
+        T m_value;
+    };
+
+    CompactListSlot() noexcept : m_next(npos), m_prev(free_mark)
+    {
+    }
+
+    template <class A>
+    CompactListSlot(std::allocator_arg_t, A const &) noexcept : CompactListSlot()
+    {
+    }
+
+    template <class A>
+    CompactListSlot(std::allocator_arg_t, A const &alloc, CompactListSlot &&that)
+        : m_next(that.m_next), m_prev(that.m_prev)
+    {
+        if (that.is_live())
+        {
+            A a(alloc);
+            std::allocator_traits<A>::construct(a, &m_value, std::move(that.m_value));
+        }
+    }
+
+    CompactListSlot(CompactListSlot &&that) noexcept(std::is_nothrow_move_constructible_v<T>)
+        : m_next(that.m_next), m_prev(that.m_prev)
+    {
+        if (that.is_live())
+        {
+            std::construct_at(&m_value, std::move(that.m_value));
+        }
+    }
+
+    ~CompactListSlot()
+    {
+        if (is_live())
+        {
+            std::destroy_at(&m_value);
+        }
+    }
+
+    [[nodiscard]] bool is_live() const noexcept
+    {
+        return m_prev != free_mark;
+    }
+};
+
+namespace std
+{
+template <class T, class A>
+struct uses_allocator<CompactListSlot<T>, A> : true_type
+{
+};
+} // namespace std
+
+// Doubly linked list whose nodes live in one Vector and link to each other by 32-bit index rather
+// than by pointer. Erased slots are recycled through a free list, and compact() rewrites the arena
+// in traversal order. Since links are positions, the arena can be relocated or written out as a
+// whole without fixing anything up. Iterators hold an index, so they survive arena growth but not
+// compact().
+template <class T, class Alloc = std::allocator<T>>
+struct CompactList
+{
+    using value_type = T;
+    using allocator_type = Alloc;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using pointer = T *;
+    using const_pointer = T const *;
+    using reference = T &;
+    using const_reference = T const &;
+
+private:
+    using Slot = CompactListSlot<T>;
+    using AllocSlot = typename std::allocator_traits<Alloc>::template rebind_alloc<Slot>;
+    using AllocSlotTraits = std::allocator_traits<AllocSlot>;
+
+    static constexpr uint32_t npos = Slot::npos;
+
+    Vector<Slot, AllocSlot> m_slots;
+    uint32_t m_head;
+    uint32_t m_tail;
+    uint32_t m_free;
+    uint32_t m_size;
+
+    Slot &slot(uint32_t idx) noexcept
+    {
+        return m_slots[idx];
+    }
+
+    Slot const &slot(uint32_t idx) const noexcept
+    {
+        return m_slots[idx];
+    }
+
+    template <class... Args>
+    uint32_t new_slot(Args &&...args)
+    {
+        uint32_t idx;
+        if (m_free != npos)
+        {
+            idx = m_free;
+            m_free = slot(idx).m_next;
+        }
+        else
+        {
+            if (m_slots.size() >= Slot::free_mark)
+            {
+                throw std::length_error("CompactList index space exhausted");
+            }
+            idx = static_cast<uint32_t>(m_slots.size());
+            m_slots.emplace_back();
+        }
+        try
+        {
+            AllocSlot alloc = m_slots.get_allocator();
+            AllocSlotTraits::construct(alloc, &slot(idx).m_value, std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            slot(idx).m_next = m_free;
+            m_free = idx;
+            throw;
+        }
+        return idx;
+    }
+
+    // links slot idx in front of next, where next == npos means the end
+    void link_before(uint32_t next, uint32_t idx) noexcept
+    {
+        uint32_t prev = next == npos ? m_tail : slot(next).m_prev;
+        slot(idx).m_prev = prev;
+        slot(idx).m_next = next;
+        (prev == npos ? m_head : slot(prev).m_next) = idx;
+        (next == npos ? m_tail : slot(next).m_prev) = idx;
+        ++m_size;
+    }
+
+public:
+    struct iterator
+    {
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = ptrdiff_t;
+        using pointer = T *;
+        using reference = T &;
+
+    private:
+        CompactList *m_list;
+        uint32_t m_index;
+
+        friend CompactList;
+
+        iterator(CompactList *list, uint32_t index) noexcept : m_list(list), m_index(index) {}
+
+    public:
+        iterator() = default;
+
+        iterator &operator++() noexcept
+        {
+            m_index = m_list->slot(m_index).m_next;
+            return *this;
+        }
+
+        iterator operator++(int) noexcept
+        {
+            auto ret = *this;
+            ++*this;
+            return ret;
+        }
+
+        iterator &operator--() noexcept
+        {
+            m_index = m_index == npos ? m_list->m_tail : m_list->slot(m_index).m_prev;
+            return *this;
+        }
+
+        iterator operator--(int) noexcept
+        {
+            auto ret = *this;
+            --*this;
+            return ret;
+        }
+
+        T &operator*() const noexcept
+        {
+            return m_list->slot(m_index).m_value;
+        }
+
+        T *operator->() const noexcept
+        {
+            return &m_list->slot(m_index).m_value;
+        }
+
+        bool operator!=(iterator const &that) const noexcept
+        {
+            return !(*this == that);
+        }
+
+        bool operator==(iterator const &that) const noexcept
+        {
+            return m_index == that.m_index;
+        }
+    };
+
+    struct const_iterator
+    {
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = ptrdiff_t;
+        using pointer = T const *;
+        using reference = T const &;
+
+    private:
+        CompactList const *m_list;
+        uint32_t m_index;
+
+        friend CompactList;
+
+        const_iterator(CompactList const *list, uint32_t index) noexcept : m_list(list), m_index(index) {}
+
+    public:
+        const_iterator() = default;
+
+        const_iterator(iterator that) noexcept : m_list(that.m_list), m_index(that.m_index) {}
+
+        const_iterator &operator++() noexcept
+        {
+            m_index = m_list->slot(m_index).m_next;
+            return *this;
+        }
+
+        const_iterator operator++(int) noexcept
+        {
+            auto ret = *this;
+            ++*this;
+            return ret;
+        }
+
+        const_iterator &operator--() noexcept
+        {
+            m_index = m_index == npos ? m_list->m_tail : m_list->slot(m_index).m_prev;
+            return *this;
+        }
+
+        const_iterator operator--(int) noexcept
+        {
+            auto ret = *this;
+            --*this;
+            return ret;
+        }
+
+        T const &operator*() const noexcept
+        {
+            return m_list->slot(m_index).m_value;
+        }
+
+        T const *operator->() const noexcept
+        {
+            return &m_list->slot(m_index).m_value;
+        }
+
+        bool operator!=(const_iterator const &that) const noexcept
+        {
+            return !(*this == that);
+        }
+
+        bool operator==(const_iterator const &that) const noexcept
+        {
+            return m_index == that.m_index;
+        }
+    };
+
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using reverse_const_iterator = std::reverse_iterator<const_iterator>;
+
+    CompactList() : CompactList(Alloc())
+    {
+    }
+
+    explicit CompactList(Alloc const &alloc) noexcept
+        : m_slots(AllocSlot(alloc)), m_head(npos), m_tail(npos), m_free(npos), m_size(0)
+    {
+    }
+
+    template <std::input_iterator InputIt>
+    CompactList(InputIt first, InputIt last, Alloc const &alloc = Alloc()) : CompactList(alloc)
+    {
+        for (; first != last; ++first)
+        {
+            emplace_back(*first);
+        }
+    }
+
+    CompactList(std::initializer_list<T> ilist, Alloc const &alloc = Alloc())
+        : CompactList(ilist.begin(), ilist.end(), alloc)
+    {
+    }
+
+    CompactList(CompactList const &that)
+        : CompactList(that.cbegin(), that.cend(),
+                      std::allocator_traits<Alloc>::select_on_container_copy_construction(that.get_allocator()))
+    {
+    }
+
+    CompactList(CompactList &&that) noexcept
+        : m_slots(std::move(that.m_slots)), m_head(that.m_head), m_tail(that.m_tail), m_free(that.m_free),
+          m_size(that.m_size)
+    {
+        that.m_head = that.m_tail = that.m_free = npos;
+        that.m_size = 0;
+    }
+
+    CompactList &operator=(CompactList const &that)
+    {
+        if (this == &that)
+            return *this;
+        clear();
+        for (auto const &val : that)
+        {
+            emplace_back(val);
+        }
+        return *this;
+    }
+
+    CompactList &operator=(CompactList &&that) noexcept
+    {
+        if (this == &that)
+            return *this;
+        m_slots = std::move(that.m_slots);
+        m_head = that.m_head;
+        m_tail = that.m_tail;
+        m_free = that.m_free;
+        m_size = that.m_size;
+        that.m_head = that.m_tail = that.m_free = npos;
+        that.m_size = 0;
+        return *this;
+    }
+
+    Alloc get_allocator() const noexcept
+    {
+        return Alloc(m_slots.get_allocator());
+    }
+
+    [[nodiscard]] size_t size() const noexcept
+    {
+        return m_size;
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return m_size == 0;
+    }
+
+    // number of slots in the arena, live or free
+    [[nodiscard]] size_t arena_size() const noexcept
+    {
+        return m_slots.size();
+    }
+
+    void reserve(size_t n)
+    {
+        m_slots.reserve(n);
+    }
+
+    T &front() noexcept
+    {
+        return slot(m_head).m_value;
+    }
+
+    T const &front() const noexcept
+    {
+        return slot(m_head).m_value;
+    }
+
+    T &back() noexcept
+    {
+        return slot(m_tail).m_value;
+    }
+
+    T const &back() const noexcept
+    {
+        return slot(m_tail).m_value;
+    }
+
+    iterator begin() noexcept
+    {
+        return iterator{this, m_head};
+    }
+
+    iterator end() noexcept
+    {
+        return iterator{this, npos};
+    }
+
+    const_iterator cbegin() const noexcept
+    {
+        return const_iterator{this, m_head};
+    }
+
+    const_iterator cend() const noexcept
+    {
+        return const_iterator{this, npos};
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return cbegin();
+    }
+
+    const_iterator end() const noexcept
+    {
+        return cend();
+    }
+
+    reverse_iterator rbegin() noexcept
+    {
+        return std::make_reverse_iterator(end());
+    }
+
+    reverse_iterator rend() noexcept
+    {
+        return std::make_reverse_iterator(begin());
+    }
+
+    reverse_const_iterator crbegin() const noexcept
+    {
+        return std::make_reverse_iterator(cend());
+    }
+
+    reverse_const_iterator crend() const noexcept
+    {
+        return std::make_reverse_iterator(cbegin());
+    }
+
+    void clear() noexcept
+    {
+        m_slots.clear();
+        m_head = m_tail = m_free = npos;
+        m_size = 0;
+    }
+
+    template <class... Args>
+    iterator emplace(const_iterator pos, Args &&...args)
+    {
+        uint32_t idx = new_slot(std::forward<Args>(args)...);
+        link_before(pos.m_index, idx);
+        return iterator{this, idx};
+    }
+
+    template <class... Args>
+    T &emplace_back(Args &&...args)
+    {
+        return *emplace(cend(), std::forward<Args>(args)...);
+    }
+
+    template <class... Args>
+    T &emplace_front(Args &&...args)
+    {
+        return *emplace(cbegin(), std::forward<Args>(args)...);
+    }
+
+    void push_back(T const &val)
+    {
+        emplace_back(val);
+    }
+
+    void push_back(T &&val)
+    {
+        emplace_back(std::move(val));
+    }
+
+    void push_front(T const &val)
+    {
+        emplace_front(val);
+    }
+
+    void push_front(T &&val)
+    {
+        emplace_front(std::move(val));
+    }
+
+    iterator insert(const_iterator pos, T const &val)
+    {
+        return emplace(pos, val);
+    }
+
+    iterator insert(const_iterator pos, T &&val)
+    {
+        return emplace(pos, std::move(val));
+    }
+
+    iterator erase(const_iterator pos) noexcept
+    {
+        uint32_t idx = pos.m_index;
+        Slot &node = slot(idx);
+        uint32_t prev = node.m_prev;
+        uint32_t next = node.m_next;
+        (prev == npos ? m_head : slot(prev).m_next) = next;
+        (next == npos ? m_tail : slot(next).m_prev) = prev;
+
+        AllocSlot alloc = m_slots.get_allocator();
+        AllocSlotTraits::destroy(alloc, &node.m_value);
+        node.m_prev = Slot::free_mark;
+        node.m_next = m_free;
+        m_free = idx;
+        --m_size;
+        return iterator{this, next};
+    }
+
+    iterator erase(const_iterator first, const_iterator last) noexcept
+    {
+        while (first != last)
+        {
+            first = erase(first);
+        }
+        return iterator{this, first.m_index};
+    }
+
+    void pop_front() noexcept
+    {
+        erase(cbegin());
+    }
+
+    void pop_back() noexcept
+    {
+        erase(const_iterator{this, m_tail});
+    }
+
+    // Rewrites the arena so slot i holds the i-th element, dropping free slots. Invalidates
+    // iterators.
+    void compact()
+    {
+        AllocSlot alloc = m_slots.get_allocator();
+        Vector<Slot, AllocSlot> slots(alloc);
+        slots.reserve(m_size);
+        uint32_t i = 0;
+        for (uint32_t cur = m_head; cur != npos; cur = slot(cur).m_next, ++i)
+        {
+            Slot &dst = slots.emplace_back();
+            AllocSlotTraits::construct(alloc, &dst.m_value, std::move(slot(cur).m_value));
+            dst.m_prev = i == 0 ? npos : i - 1;
+            dst.m_next = i + 1 == m_size ? npos : i + 1;
+        }
+        m_slots = std::move(slots);
+        m_head = m_size ? 0 : npos;
+        m_tail = m_size ? m_size - 1 : npos;
+        m_free = npos;
+    }
+
+    bool operator==(CompactList const &that) const noexcept
+    {
+        if (m_size != that.m_size)
+            return false;
+        auto it = cbegin();
+        for (auto const &val : that)
+        {
+            if (!(*it == val))
+                return false;
+            ++it;
+        }
+        return true;
+    }
+};
@@ -0,0 +1,485 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <shared_mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <miniSTL/hash.hpp>
+#include <miniSTL/hash_table.hpp>
+
+#if defined(__SANITIZE_THREAD__)
+#define MINISTL_TSAN 1
+#elif defined(__has_feature)
+#if __has_feature(thread_sanitizer)
+#define MINISTL_TSAN 1
+#endif
+#endif
+
+// Blocks given back to a RetiringAllocator, kept until this list is destroyed. Each one holds its
+// own link, so retiring never allocates.
+struct RetiredBlocks
+{
+    struct Block
+    {
+        Block *m_next;
+        size_t m_bytes;
+        size_t m_align;
+    };
+
+    Block *m_head = nullptr;
+
+    RetiredBlocks() = default;
+    RetiredBlocks(RetiredBlocks const &) = delete;
+    RetiredBlocks &operator=(RetiredBlocks const &) = delete;
+
+    ~RetiredBlocks()
+    {
+        while (m_head)
+        {
+            Block *next = m_head->m_next;
+            ::operator delete(m_head, m_head->m_bytes, std::align_val_t(m_head->m_align));
+            m_head = next;
+        }
+    }
+
+    void retire(void *p, size_t bytes, size_t align) noexcept
+    {
+        m_head = ::new (p) Block{m_head, bytes, align};
+    }
+};
+
+// Allocator whose deallocate() only retires the block, for tables that lock-free readers may still
+// be probing after a writer has outgrown them. A map that only grows keeps less than its live
+// tables again in retired ones.
+template <class T>
+struct RetiringAllocator
+{
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    RetiredBlocks *m_retired;
+
+    explicit RetiringAllocator(RetiredBlocks *retired) noexcept : m_retired(retired)
+    {
+    }
+
+    template <class U>
+    RetiringAllocator(RetiringAllocator<U> const &that) noexcept : m_retired(that.m_retired)
+    {
+    }
+
+    static constexpr size_t align = std::max(alignof(T), alignof(RetiredBlocks::Block));
+
+    static size_t bytes_for(size_t n) noexcept
+    {
+        return std::max(n * sizeof(T), sizeof(RetiredBlocks::Block));
+    }
+
+    T *allocate(size_t n)
+    {
+        return static_cast<T *>(::operator new(bytes_for(n), std::align_val_t(align)));
+    }
+
+    void deallocate(T *p, size_t n) noexcept
+    {
+        m_retired->retire(p, bytes_for(n), align);
+    }
+
+    template <class U>
+    bool operator==(RetiringAllocator<U> const &that) const noexcept
+    {
+        return m_retired == that.m_retired;
+    }
+};
+
+// Hash map that many threads may use at once. Keys are spread over a power-of-two number of
+// shards, each a HashMap behind its own reader/writer lock, so threads touching different shards
+// never wait for each other and readers of one shard share its lock. A shard grows inside its own
+// lock: a resize stalls only the keys of that shard, never the whole table.
+//
+// Since another thread may erase or move an element at any time, lookups hand out copies (find)
+// or run a callback under the shard lock (visit, update); no reference into the map escapes.
+// Callbacks must not call back into the same map.
+//
+// When K and V are trivially copyable, find(), contains() and the hit path of compute_if_absent()
+// take no lock at all: each shard also keeps a seqlock, a version counter that writers make odd
+// for the length of every change, and a reader probes the table optimistically and keeps the
+// result only if the version was even and unchanged throughout. A reader that meets a writer
+// falls back to the shared lock. Tables a shard outgrows stay allocated until the map is
+// destroyed, since a reader may still be probing them. Built with ThreadSanitizer, which would
+// flag the deliberate races, every read takes the lock.
+template <class K, class V, class Hash = FastHash<K>, class Eq = std::equal_to<K>>
+struct ConcurrentHashMap
+{
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = std::pair<K const, V>;
+    using hasher = Hash;
+    using key_equal = Eq;
+    using size_type = size_t;
+
+private:
+#ifdef MINISTL_TSAN
+    static constexpr bool optimistic_reads = false;
+#else
+    static constexpr bool optimistic_reads = std::is_trivially_copyable_v<K> && std::is_trivially_copyable_v<V>;
+#endif
+
+    using Alloc = std::conditional_t<optimistic_reads, RetiringAllocator<value_type>, std::allocator<value_type>>;
+    using Map = HashMap<K, V, Hash, Eq, Alloc>;
+
+    struct alignas(64) Shard
+    {
+        mutable std::shared_mutex m_mutex;
+        std::atomic<uint64_t> m_version = 0;
+        RetiredBlocks m_retired;
+        Map m_map;
+
+        Shard() : m_map(0, Hash(), Eq(), allocator())
+        {
+        }
+
+        Alloc allocator() noexcept
+        {
+            if constexpr (optimistic_reads)
+            {
+                return Alloc(&m_retired);
+            }
+            else
+            {
+                return Alloc();
+            }
+        }
+    };
+
+    // The exclusive lock of a shard; the seqlock version is odd while it is held.
+    struct WriteLock
+    {
+        Shard &m_shard;
+        std::unique_lock<std::shared_mutex> m_lock;
+
+        explicit WriteLock(Shard &shard) : m_shard(shard), m_lock(shard.m_mutex)
+        {
+            if constexpr (optimistic_reads)
+            {
+                m_shard.m_version.store(m_shard.m_version.load(std::memory_order_relaxed) + 1,
+                                        std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_release);
+            }
+        }
+
+        WriteLock(WriteLock const &) = delete;
+        WriteLock &operator=(WriteLock const &) = delete;
+
+        ~WriteLock()
+        {
+            if constexpr (optimistic_reads)
+            {
+                m_shard.m_version.store(m_shard.m_version.load(std::memory_order_relaxed) + 1,
+                                        std::memory_order_release);
+            }
+        }
+    };
+
+    std::unique_ptr<Shard[]> m_shards;
+    size_t m_shard_count;
+    unsigned m_shift;
+    [[no_unique_address]] Hash m_hash;
+
+    // Fibonacci hashing picks the shard from the top bits of the mixed hash, which stay
+    // independent of the low bits each shard's HashMap uses for its own slots.
+    template <class Key>
+    Shard &shard_of(Key const &key) const noexcept
+    {
+        uint64_t mixed = static_cast<uint64_t>(m_hash(key)) * 0x9e3779b97f4a7c15ull;
+        return m_shards[m_shift == 64 ? 0 : mixed >> m_shift];
+    }
+
+    // The seqlock read: whether key is present, passing its value to found(V const &), or nothing
+    // if a writer got in the way twice. found() may see a torn value, but a later call overwrites
+    // whatever it made of it, and only the result of a clean attempt is returned.
+    template <class Key, class F>
+    std::optional<bool> find_optimistic(Shard const &shard, Key const &key, F found) const
+    {
+        for (int attempt = 0; attempt < 2; attempt++)
+        {
+            uint64_t version = shard.m_version.load(std::memory_order_acquire);
+            if (version & 1)
+                return std::nullopt;
+            auto unchanged = [&] {
+                std::atomic_thread_fence(std::memory_order_acquire);
+                return shard.m_version.load(std::memory_order_relaxed) == version;
+            };
+            bool present = shard.m_map.find_racy(key, unchanged, found);
+            if (unchanged())
+                return present;
+        }
+        return std::nullopt;
+    }
+
+    template <class Key>
+    std::optional<V> find_value(Key const &key) const
+    {
+        Shard &shard = shard_of(key);
+        if constexpr (optimistic_reads)
+        {
+            std::optional<V> val;
+            if (auto present = find_optimistic(shard, key, [&](V const &v) { val = v; }))
+                return *present ? val : std::nullopt;
+        }
+        std::shared_lock lock(shard.m_mutex);
+        auto it = shard.m_map.find(key);
+        if (it == shard.m_map.end())
+            return std::nullopt;
+        return it->second;
+    }
+
+    template <class Key>
+    bool contains_key(Key const &key) const
+    {
+        Shard &shard = shard_of(key);
+        if constexpr (optimistic_reads)
+        {
+            if (auto present = find_optimistic(shard, key, [](V const &) {}))
+                return *present;
+        }
+        std::shared_lock lock(shard.m_mutex);
+        return shard.m_map.contains(key);
+    }
+
+public:
+    // four shards per hardware thread keeps two threads on one shard rare
+    static size_t default_shard_count() noexcept
+    {
+        return std::clamp<size_t>(std::bit_ceil(4 * std::max(1u, std::thread::hardware_concurrency())), 1, 1024);
+    }
+
+    explicit ConcurrentHashMap(size_t shard_count = default_shard_count(), Hash const &hash = Hash(),
+                               Eq const &eq = Eq())
+        : m_shard_count(std::bit_ceil(std::max<size_t>(shard_count, 1))),
+          m_shift(64 - std::countr_zero(m_shard_count)), m_hash(hash)
+    {
+        m_shards = std::make_unique<Shard[]>(m_shard_count);
+        for (size_t i = 0; i < m_shard_count; i++)
+        {
+            m_shards[i].m_map = Map(0, hash, eq, m_shards[i].allocator());
+        }
+    }
+
+    ConcurrentHashMap(ConcurrentHashMap const &) = delete;
+    ConcurrentHashMap &operator=(ConcurrentHashMap const &) = delete;
+
+    [[nodiscard]] size_t shard_count() const noexcept
+    {
+        return m_shard_count;
+    }
+
+    // a snapshot that other threads may already have changed
+    [[nodiscard]] size_t size() const
+    {
+        size_t n = 0;
+        for (size_t i = 0; i < m_shard_count; i++)
+        {
+            std::shared_lock lock(m_shards[i].m_mutex);
+            n += m_shards[i].m_map.size();
+        }
+        return n;
+    }
+
+    [[nodiscard]] bool empty() const
+    {
+        return size() == 0;
+    }
+
+    // spreads room for n elements evenly over the shards
+    void reserve(size_t n)
+    {
+        size_t per_shard = (n + m_shard_count - 1) / m_shard_count;
+        for (size_t i = 0; i < m_shard_count; i++)
+        {
+            WriteLock lock(m_shards[i]);
+            m_shards[i].m_map.reserve(per_shard + per_shard / 8);
+        }
+    }
+
+    void clear()
+    {
+        for (size_t i = 0; i < m_shard_count; i++)
+        {
+            WriteLock lock(m_shards[i]);
+            m_shards[i].m_map.clear();
+        }
+    }
+
+    [[nodiscard]] std::optional<V> find(K const &key) const
+    {
+        return find_value(key);
+    }
+
+    template <class Key>
+        requires TransparentHashEq<Hash, Eq>
+    [[nodiscard]] std::optional<V> find(Key const &key) const
+    {
+        return find_value(key);
+    }
+
+    [[nodiscard]] bool contains(K const &key) const
+    {
+        return contains_key(key);
+    }
+
+    template <class Key>
+        requires TransparentHashEq<Hash, Eq>
+    [[nodiscard]] bool contains(Key const &key) const
+    {
+        return contains_key(key);
+    }
+
+    [[nodiscard]] size_t count(K const &key) const
+    {
+        return contains(key) ? 1 : 0;
+    }
+
+    template <class Key>
+        requires TransparentHashEq<Hash, Eq>
+    [[nodiscard]] size_t count(Key const &key) const
+    {
+        return contains(key) ? 1 : 0;
+    }
+
+    // Calls f(V const &) under the shard's shared lock if key is present, without copying the value.
+    template <class F>
+    bool visit(K const &key, F f) const
+    {
+        Shard &shard = shard_of(key);
+        std::shared_lock lock(shard.m_mutex);
+        auto it = shard.m_map.find(key);
+        if (it == shard.m_map.end())
+            return false;
+        f(std::as_const(it->second));
+        return true;
+    }
+
+    template <class Key, class F>
+        requires TransparentHashEq<Hash, Eq>
+    bool visit(Key const &key, F f) const
+    {
+        Shard &shard = shard_of(key);
+        std::shared_lock lock(shard.m_mutex);
+        auto it = shard.m_map.find(key);
+        if (it == shard.m_map.end())
+            return false;
+        f(std::as_const(it->second));
+        return true;
+    }
+
+    // Calls f(V &) under the shard's exclusive lock if key is present; a read-modify-write that no
+    // other thread can interleave with.
+    template <class F>
+    bool update(K const &key, F f)
+    {
+        Shard &shard = shard_of(key);
+        WriteLock lock(shard);
+        auto it = shard.m_map.find(key);
+        if (it == shard.m_map.end())
+            return false;
+        f(it->second);
+        return true;
+    }
+
+    template <class Key, class F>
+        requires TransparentHashEq<Hash, Eq>
+    bool update(Key const &key, F f)
+    {
+        Shard &shard = shard_of(key);
+        WriteLock lock(shard);
+        auto it = shard.m_map.find(key);
+        if (it == shard.m_map.end())
+            return false;
+        f(it->second);
+        return true;
+    }
+
+    // returns true if key was new
+    template <class... Args>
+    bool try_emplace(K const &key, Args &&...args)
+    {
+        Shard &shard = shard_of(key);
+        WriteLock lock(shard);
+        return shard.m_map.try_emplace(key, std::forward<Args>(args)...).second;
+    }
+
+    bool insert(value_type const &val)
+    {
+        return try_emplace(val.first, val.second);
+    }
+
+    template <class M>
+    bool insert_or_assign(K const &key, M &&obj)
+    {
+        Shard &shard = shard_of(key);
+        WriteLock lock(shard);
+        return shard.m_map.insert_or_assign(key, std::forward<M>(obj)).second;
+    }
+
+    // Returns a copy of the value for key, creating it from make() first if it is absent. A shared
+    // lookup runs first so hits never take the exclusive lock; make() runs at most once per key
+    // even when several threads race to create it.
+    template <class F>
+    V compute_if_absent(K const &key, F make)
+    {
+        Shard &shard = shard_of(key);
+        if (std::optional<V> val = find_value(key))
+            return *val;
+        WriteLock lock(shard);
+        auto it = shard.m_map.find(key);
+        if (it == shard.m_map.end())
+        {
+            it = shard.m_map.try_emplace(key, make()).first;
+        }
+        return it->second;
+    }
+
+    size_t erase(K const &key)
+    {
+        Shard &shard = shard_of(key);
+        WriteLock lock(shard);
+        return shard.m_map.erase(key);
+    }
+
+    template <class Key>
+        requires TransparentHashEq<Hash, Eq>
+    size_t erase(Key const &key)
+    {
+        Shard &shard = shard_of(key);
+        WriteLock lock(shard);
+        return shard.m_map.erase(key);
+    }
+
+    // Calls f(K const &, V const &) for every element, one shard at a time under its shared lock.
+    // Elements added or removed meanwhile in shards not yet visited may or may not be seen.
+    template <class F>
+    void for_each(F f) const
+    {
+        for (size_t i = 0; i < m_shard_count; i++)
+        {
+            std::shared_lock lock(m_shards[i].m_mutex);
+            for (auto const &[key, val] : m_shards[i].m_map)
+            {
+                f(key, val);
+            }
+        }
+    }
+};
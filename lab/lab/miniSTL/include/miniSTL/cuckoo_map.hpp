@@ -0,0 +1,987 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <miniSTL/hash.hpp>
+#include <miniSTL/hash_table.hpp>
+
+// Bucketized cuckoo hash map: every key may live in one of four slots of its primary bucket or of
+// its alternate bucket, or in a small stash. A lookup therefore reads at most two buckets, whose
+// one-byte tags are compared four at a time in a 32-bit word, plus the stash when it is not empty;
+// that bound holds however full the table is.
+//
+// The alternate bucket is derived from the primary one and the tag alone (partial-key cuckoo
+// hashing), so making room can walk chains of evictions without rehashing any key. An insert into
+// two full buckets runs a breadth-first search for the shortest such chain that ends in a free
+// slot, then shifts the elements along it. When the search fails, the element goes to the stash;
+// when the stash is full too, the table doubles. Doubling cannot separate keys with equal hashes,
+// so at most 2 * bucket_width + stash_capacity of them fit: once the table is under 1/16 full, an
+// insert that finds no room throws std::length_error instead. Inserting and erasing move elements
+// and invalidate iterators and references.
+template <class K, class V, class Hash = FastHash<K>, class Eq = std::equal_to<K>,
+          class Alloc = std::allocator<std::pair<K const, V>>>
+struct CuckooMap
+{
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = std::pair<K const, V>;
+    using hasher = Hash;
+    using key_equal = Eq;
+    using allocator_type = Alloc;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using pointer = value_type *;
+    using const_pointer = value_type const *;
+    using reference = value_type &;
+    using const_reference = value_type const &;
+
+    static constexpr size_t bucket_width = 4;
+    static constexpr size_t stash_capacity = 8;
+
+private:
+    using AllocTraits = std::allocator_traits<Alloc>;
+    using AllocTag = AllocTraits::template rebind_alloc<uint8_t>;
+    using AllocTagTraits = std::allocator_traits<AllocTag>;
+
+    static constexpr size_t min_buckets = 2;
+    static constexpr size_t max_search = 256;
+    // an insert that finds no room in a table less than 1/min_load_divisor full throws rather than
+    // doubling it again, like libcuckoo's minimum load factor
+    static constexpr size_t min_load_divisor = 16;
+
+    // m_tags and m_slots have bucket_width slots per bucket followed by the stash; tag 0 marks a
+    // free slot
+    uint8_t *m_tags;
+    value_type *m_slots;
+    size_t m_bucket_count;
+    size_t m_size;
+    size_t m_stash_size;
+    [[no_unique_address]] Hash m_hash;
+    [[no_unique_address]] Eq m_eq;
+    [[no_unique_address]] Alloc m_alloc;
+
+    struct Hashed
+    {
+        size_t m_bucket;
+        uint8_t m_tag;
+    };
+
+    static K &mutable_key(value_type &val) noexcept
+    {
+        return const_cast<K &>(val.first);
+    }
+
+    size_t slot_count() const noexcept
+    {
+        return m_bucket_count * bucket_width + stash_capacity;
+    }
+
+    size_t stash_begin() const noexcept
+    {
+        return m_bucket_count * bucket_width;
+    }
+
+    template <class Key>
+    Hashed hash_of(Key const &key) const
+    {
+        uint64_t x = static_cast<uint64_t>(m_hash(key));
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdull;
+        x ^= x >> 33;
+        uint8_t tag = static_cast<uint8_t>(x >> 56);
+        return {static_cast<size_t>(x) & (m_bucket_count - 1), tag ? tag : uint8_t(1)};
+    }
+
+    // An odd xor keeps the two buckets apart, and applying it twice leads back, so either bucket
+    // finds the other from the tag alone.
+    size_t alt_bucket(size_t bucket, uint8_t tag) const noexcept
+    {
+        return (bucket ^ ((tag * size_t(0x5bd1e995)) | 1)) & (m_bucket_count - 1);
+    }
+
+    // bit 8 * i + 7 is set for each slot i of the bucket whose tag may equal `tag`; false positives
+    // only occur above a true match and are weeded out by the key compare
+    uint32_t match(size_t bucket, uint8_t tag) const noexcept
+    {
+        uint32_t word;
+        std::memcpy(&word, m_tags + bucket * bucket_width, sizeof(word));
+        word ^= tag * 0x01010101u;
+        return (word - 0x01010101u) & ~word & 0x80808080u;
+    }
+
+    int free_slot(size_t bucket) const noexcept
+    {
+        for (size_t i = 0; i < bucket_width; i++)
+        {
+            if (m_tags[bucket * bucket_width + i] == 0)
+                return static_cast<int>(i);
+        }
+        return -1;
+    }
+
+    template <class Key>
+    size_t find_index(Key const &key) const
+    {
+        if (m_size == 0)
+            return slot_count();
+        return find_index(key, hash_of(key));
+    }
+
+    template <class Key>
+    size_t find_index(Key const &key, Hashed h) const
+    {
+        size_t buckets[2] = {h.m_bucket, alt_bucket(h.m_bucket, h.m_tag)};
+        for (size_t bucket : buckets)
+        {
+            for (uint32_t bits = match(bucket, h.m_tag); bits; bits &= bits - 1)
+            {
+                size_t idx = bucket * bucket_width + std::countr_zero(bits) / 8;
+                if (m_tags[idx] == h.m_tag && m_eq(m_slots[idx].first, key))
+                    return idx;
+            }
+        }
+        if (m_stash_size)
+        {
+            for (size_t idx = stash_begin(); idx < slot_count(); idx++)
+            {
+                if (m_tags[idx] == h.m_tag && m_eq(m_slots[idx].first, key))
+                    return idx;
+            }
+        }
+        return slot_count();
+    }
+
+    // calls f(i, index of keys[i]) in order, after hashing a batch and prefetching both buckets of
+    // each key
+    template <class F>
+    void lookup_many(std::span<K const> keys, F f) const
+    {
+        Hashed hashes[lookup_batch];
+        for (size_t first = 0; first < keys.size(); first += lookup_batch)
+        {
+            size_t n = std::min(lookup_batch, keys.size() - first);
+            if (m_size == 0)
+            {
+                for (size_t i = 0; i < n; i++)
+                {
+                    f(first + i, slot_count());
+                }
+                continue;
+            }
+            for (size_t i = 0; i < n; i++)
+            {
+                hashes[i] = hash_of(keys[first + i]);
+                size_t alt = alt_bucket(hashes[i].m_bucket, hashes[i].m_tag);
+                prefetch_read(m_tags + hashes[i].m_bucket * bucket_width);
+                prefetch_read(m_slots + hashes[i].m_bucket * bucket_width);
+                prefetch_read(m_tags + alt * bucket_width);
+                prefetch_read(m_slots + alt * bucket_width);
+            }
+            for (size_t i = 0; i < n; i++)
+            {
+                f(first + i, find_index(keys[first + i], hashes[i]));
+            }
+        }
+    }
+
+    void allocate_table(size_t bucket_count)
+    {
+        size_t slots = bucket_count * bucket_width + stash_capacity;
+        AllocTag tag_alloc{m_alloc};
+        uint8_t *tags = AllocTagTraits::allocate(tag_alloc, slots);
+        try
+        {
+            m_slots = AllocTraits::allocate(m_alloc, slots);
+        }
+        catch (...)
+        {
+            AllocTagTraits::deallocate(tag_alloc, tags, slots);
+            throw;
+        }
+        m_tags = tags;
+        std::memset(m_tags, 0, slots);
+        m_bucket_count = bucket_count;
+        m_stash_size = 0;
+    }
+
+    void deallocate_table() noexcept
+    {
+        if (m_bucket_count == 0)
+            return;
+        AllocTag tag_alloc{m_alloc};
+        AllocTagTraits::deallocate(tag_alloc, m_tags, slot_count());
+        AllocTraits::deallocate(m_alloc, m_slots, slot_count());
+        m_tags = nullptr;
+        m_slots = nullptr;
+        m_bucket_count = 0;
+    }
+
+    void destroy_all() noexcept
+    {
+        if (m_bucket_count == 0)
+            return;
+        for (size_t i = 0; i < slot_count(); i++)
+        {
+            if (m_tags[i])
+            {
+                AllocTraits::destroy(m_alloc, &m_slots[i]);
+            }
+        }
+    }
+
+    void move_slot(size_t from, size_t to)
+    {
+        AllocTraits::construct(m_alloc, &m_slots[to], std::move(mutable_key(m_slots[from])),
+                               std::move(m_slots[from].second));
+        AllocTraits::destroy(m_alloc, &m_slots[from]);
+        m_tags[to] = m_tags[from];
+        m_tags[from] = 0;
+    }
+
+    // Breadth-first search over eviction chains starting at both candidate buckets. On success the
+    // residents along the shortest chain are shifted one step each and the freed slot in one of
+    // the candidate buckets is returned; otherwise slot_count().
+    size_t make_room(Hashed h)
+    {
+        struct Step
+        {
+            size_t m_bucket;
+            int m_parent;
+            int m_slot;
+        };
+        Step steps[max_search];
+        size_t count = 0;
+        steps[count++] = {h.m_bucket, -1, -1};
+        steps[count++] = {alt_bucket(h.m_bucket, h.m_tag), -1, -1};
+        for (size_t at = 0; at < count; at++)
+        {
+            int slot = free_slot(steps[at].m_bucket);
+            if (slot >= 0)
+            {
+                Step *cur = &steps[at];
+                while (cur->m_parent >= 0)
+                {
+                    Step *parent = &steps[cur->m_parent];
+                    move_slot(parent->m_bucket * bucket_width + cur->m_slot, cur->m_bucket * bucket_width + slot);
+                    slot = cur->m_slot;
+                    cur = parent;
+                }
+                return cur->m_bucket * bucket_width + slot;
+            }
+            for (size_t i = 0; i < bucket_width && count < max_search; i++)
+            {
+                uint8_t tag = m_tags[steps[at].m_bucket * bucket_width + i];
+                steps[count++] = {alt_bucket(steps[at].m_bucket, tag), static_cast<int>(at), static_cast<int>(i)};
+            }
+        }
+        return slot_count();
+    }
+
+    size_t stash_slot() const noexcept
+    {
+        for (size_t idx = stash_begin(); idx < slot_count(); idx++)
+        {
+            if (m_tags[idx] == 0)
+                return idx;
+        }
+        return slot_count();
+    }
+
+    // a free slot for a key known to be absent, placed without moving anything if possible
+    size_t place(Hashed h)
+    {
+        size_t alt = alt_bucket(h.m_bucket, h.m_tag);
+        for (size_t bucket : {h.m_bucket, alt})
+        {
+            int slot = free_slot(bucket);
+            if (slot >= 0)
+                return bucket * bucket_width + slot;
+        }
+        size_t idx = make_room(h);
+        if (idx != slot_count())
+            return idx;
+        idx = stash_slot();
+        if (idx != slot_count())
+        {
+            ++m_stash_size;
+        }
+        return idx;
+    }
+
+    void resize(size_t bucket_count)
+    {
+        uint8_t *old_tags = m_tags;
+        value_type *old_slots = m_slots;
+        size_t old_slot_count = m_bucket_count ? slot_count() : 0;
+        for (;;)
+        {
+            allocate_table(bucket_count);
+            bool placed_all = true;
+            for (size_t i = 0; i < old_slot_count && placed_all; i++)
+            {
+                if (!old_tags[i])
+                    continue;
+                size_t idx = place(hash_of(old_slots[i].first));
+                if (idx == slot_count())
+                {
+                    placed_all = false;
+                    break;
+                }
+                AllocTraits::construct(m_alloc, &m_slots[idx], std::move(mutable_key(old_slots[i])),
+                                       std::move(old_slots[i].second));
+                AllocTraits::destroy(m_alloc, &old_slots[i]);
+                m_tags[idx] = std::exchange(old_tags[i], 0);
+            }
+            if (placed_all)
+                break;
+            // very unlucky: move what was placed back out and try a table twice as large
+            for (size_t i = 0, j = 0; i < slot_count(); i++)
+            {
+                if (!m_tags[i])
+                    continue;
+                while (old_tags[j])
+                {
+                    j++;
+                }
+                AllocTraits::construct(m_alloc, &old_slots[j], std::move(mutable_key(m_slots[i])),
+                                       std::move(m_slots[i].second));
+                AllocTraits::destroy(m_alloc, &m_slots[i]);
+                old_tags[j] = m_tags[i];
+            }
+            deallocate_table();
+            bucket_count *= 2;
+        }
+        if (old_slot_count)
+        {
+            AllocTag tag_alloc{m_alloc};
+            AllocTagTraits::deallocate(tag_alloc, old_tags, old_slot_count);
+            AllocTraits::deallocate(m_alloc, old_slots, old_slot_count);
+        }
+    }
+
+    template <class Key, class... Args>
+    std::pair<size_t, bool> try_emplace_index(Key &&key, Args &&...args)
+    {
+        size_t idx = find_index(key);
+        if (idx != slot_count())
+            return {idx, false};
+        if (m_bucket_count == 0)
+        {
+            resize(min_buckets);
+        }
+        Hashed h = hash_of(key);
+        for (;;)
+        {
+            idx = place(h);
+            if (idx != slot_count())
+                break;
+            // under the minimum load, only keys hashing alike can crowd both buckets and the stash
+            if (m_size < m_bucket_count * bucket_width / min_load_divisor)
+                throw std::length_error("CuckooMap: too many keys share the same buckets, the hash "
+                                        "function is degenerate");
+            resize(m_bucket_count * 2);
+            h = hash_of(key);
+        }
+        try
+        {
+            AllocTraits::construct(m_alloc, &m_slots[idx], std::piecewise_construct,
+                                   std::forward_as_tuple(std::forward<Key>(key)),
+                                   std::forward_as_tuple(std::forward<Args>(args)...));
+        }
+        catch (...)
+        {
+            if (idx >= stash_begin())
+            {
+                --m_stash_size;
+            }
+            throw;
+        }
+        m_tags[idx] = h.m_tag;
+        ++m_size;
+        return {idx, true};
+    }
+
+    void erase_at(size_t idx) noexcept
+    {
+        AllocTraits::destroy(m_alloc, &m_slots[idx]);
+        m_tags[idx] = 0;
+        --m_size;
+        if (idx >= stash_begin())
+        {
+            --m_stash_size;
+        }
+    }
+
+    void copy_from(CuckooMap const &that)
+    {
+        if (that.m_size == 0)
+            return;
+        reserve(that.m_size);
+        for (auto const &item : that)
+        {
+            try_emplace_index(item.first, item.second);
+        }
+    }
+
+    void steal(CuckooMap &that) noexcept
+    {
+        m_tags = std::exchange(that.m_tags, nullptr);
+        m_slots = std::exchange(that.m_slots, nullptr);
+        m_bucket_count = std::exchange(that.m_bucket_count, 0);
+        m_size = std::exchange(that.m_size, 0);
+        m_stash_size = std::exchange(that.m_stash_size, 0);
+    }
+
+    void move_elements_from(CuckooMap &that)
+    {
+        reserve(that.m_size);
+        for (auto &item : that)
+        {
+            try_emplace_index(std::move(mutable_key(item)), std::move(item.second));
+        }
+        that.clear();
+    }
+
+public:
+    template <bool Const>
+    struct basic_iterator
+    {
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = CuckooMap::value_type;
+        using difference_type = ptrdiff_t;
+        using pointer = std::conditional_t<Const, value_type const *, value_type *>;
+        using reference = std::conditional_t<Const, value_type const &, value_type &>;
+
+    private:
+        uint8_t const *m_tag;
+        uint8_t const *m_end;
+        value_type *m_slot;
+
+        friend CuckooMap;
+
+        basic_iterator(uint8_t const *tag, uint8_t const *end, value_type *slot) noexcept
+            : m_tag(tag), m_end(end), m_slot(slot)
+        {
+        }
+
+        void skip_free() noexcept
+        {
+            while (m_tag != m_end && *m_tag == 0)
+            {
+                ++m_tag;
+                ++m_slot;
+            }
+        }
+
+    public:
+        basic_iterator() = default;
+
+        template <bool WasConst>
+            requires(Const && !WasConst)
+        basic_iterator(basic_iterator<WasConst> that) noexcept : m_tag(that.m_tag), m_end(that.m_end), m_slot(that.m_slot)
+        {
+        }
+
+        basic_iterator &operator++() noexcept
+        {
+            ++m_tag;
+            ++m_slot;
+            skip_free();
+            return *this;
+        }
+
+        basic_iterator operator++(int) noexcept
+        {
+            auto ret = *this;
+            ++*this;
+            return ret;
+        }
+
+        reference operator*() const noexcept
+        {
+            return *m_slot;
+        }
+
+        pointer operator->() const noexcept
+        {
+            return m_slot;
+        }
+
+        bool operator==(basic_iterator const &that) const noexcept
+        {
+            return m_tag == that.m_tag;
+        }
+
+        bool operator!=(basic_iterator const &that) const noexcept
+        {
+            return !(*this == that);
+        }
+
+        template <bool>
+        friend struct basic_iterator;
+    };
+
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+private:
+    iterator iterator_at(size_t idx) const noexcept
+    {
+        size_t end = m_bucket_count ? slot_count() : 0;
+        return iterator{m_tags + idx, m_tags + end, m_slots + idx};
+    }
+
+    size_t end_index() const noexcept
+    {
+        return m_bucket_count ? slot_count() : 0;
+    }
+
+public:
+    CuckooMap() : CuckooMap(0)
+    {
+    }
+
+    explicit CuckooMap(size_t bucket_count, Hash const &hash = Hash(), Eq const &eq = Eq(),
+                       Alloc const &alloc = Alloc())
+        : m_tags(nullptr), m_slots(nullptr), m_bucket_count(0), m_size(0), m_stash_size(0), m_hash(hash), m_eq(eq),
+          m_alloc(alloc)
+    {
+        if (bucket_count)
+        {
+            reserve(bucket_count);
+        }
+    }
+
+    explicit CuckooMap(Alloc const &alloc) : CuckooMap(0, Hash(), Eq(), alloc)
+    {
+    }
+
+    template <std::input_iterator InputIt>
+    CuckooMap(InputIt first, InputIt last, size_t bucket_count = 0, Hash const &hash = Hash(), Eq const &eq = Eq(),
+              Alloc const &alloc = Alloc())
+        : CuckooMap(bucket_count, hash, eq, alloc)
+    {
+        insert(first, last);
+    }
+
+    CuckooMap(std::initializer_list<value_type> ilist, size_t bucket_count = 0, Hash const &hash = Hash(),
+              Eq const &eq = Eq(), Alloc const &alloc = Alloc())
+        : CuckooMap(ilist.begin(), ilist.end(), bucket_count, hash, eq, alloc)
+    {
+    }
+
+    CuckooMap(CuckooMap const &that)
+        : CuckooMap(0, that.m_hash, that.m_eq, AllocTraits::select_on_container_copy_construction(that.m_alloc))
+    {
+        copy_from(that);
+    }
+
+    CuckooMap(CuckooMap const &that, Alloc const &alloc) : CuckooMap(0, that.m_hash, that.m_eq, alloc)
+    {
+        copy_from(that);
+    }
+
+    CuckooMap(CuckooMap &&that) noexcept : CuckooMap(0, that.m_hash, that.m_eq, std::move(that.m_alloc))
+    {
+        steal(that);
+    }
+
+    CuckooMap(CuckooMap &&that, Alloc const &alloc) : CuckooMap(0, that.m_hash, that.m_eq, alloc)
+    {
+        if (m_alloc == that.m_alloc)
+        {
+            steal(that);
+        }
+        else
+        {
+            move_elements_from(that);
+        }
+    }
+
+    CuckooMap &operator=(CuckooMap const &that)
+    {
+        if (this == &that)
+            return *this;
+        destroy_all();
+        deallocate_table();
+        m_size = 0;
+        m_stash_size = 0;
+        if constexpr (AllocTraits::propagate_on_container_copy_assignment::value)
+        {
+            m_alloc = that.m_alloc;
+        }
+        m_hash = that.m_hash;
+        m_eq = that.m_eq;
+        copy_from(that);
+        return *this;
+    }
+
+    CuckooMap &operator=(CuckooMap &&that) noexcept(AllocTraits::propagate_on_container_move_assignment::value ||
+                                                     AllocTraits::is_always_equal::value)
+    {
+        if (this == &that)
+            return *this;
+        destroy_all();
+        deallocate_table();
+        m_size = 0;
+        m_stash_size = 0;
+        m_hash = that.m_hash;
+        m_eq = that.m_eq;
+        if constexpr (AllocTraits::propagate_on_container_move_assignment::value)
+        {
+            m_alloc = std::move(that.m_alloc);
+            steal(that);
+        }
+        else if (m_alloc == that.m_alloc)
+        {
+            steal(that);
+        }
+        else
+        {
+            move_elements_from(that);
+        }
+        return *this;
+    }
+
+    ~CuckooMap()
+    {
+        destroy_all();
+        deallocate_table();
+    }
+
+    void swap(CuckooMap &that) noexcept
+    {
+        if constexpr (AllocTraits::propagate_on_container_swap::value)
+        {
+            std::swap(m_alloc, that.m_alloc);
+        }
+        std::swap(m_tags, that.m_tags);
+        std::swap(m_slots, that.m_slots);
+        std::swap(m_bucket_count, that.m_bucket_count);
+        std::swap(m_size, that.m_size);
+        std::swap(m_stash_size, that.m_stash_size);
+        std::swap(m_hash, that.m_hash);
+        std::swap(m_eq, that.m_eq);
+    }
+
+    Alloc get_allocator() const noexcept
+    {
+        return m_alloc;
+    }
+
+    hasher hash_function() const
+    {
+        return m_hash;
+    }
+
+    key_equal key_eq() const
+    {
+        return m_eq;
+    }
+
+    [[nodiscard]] size_t size() const noexcept
+    {
+        return m_size;
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return m_size == 0;
+    }
+
+    [[nodiscard]] size_t bucket_count() const noexcept
+    {
+        return m_bucket_count;
+    }
+
+    [[nodiscard]] size_t capacity() const noexcept
+    {
+        return m_bucket_count * bucket_width;
+    }
+
+    [[nodiscard]] size_t stash_size() const noexcept
+    {
+        return m_stash_size;
+    }
+
+    [[nodiscard]] float load_factor() const noexcept
+    {
+        return m_bucket_count ? float(m_size) / float(capacity()) : 0.0f;
+    }
+
+    void clear() noexcept
+    {
+        destroy_all();
+        m_size = 0;
+        m_stash_size = 0;
+        if (m_bucket_count)
+        {
+            std::memset(m_tags, 0, slot_count());
+        }
+    }
+
+    // sizes the table so n elements fit at a load of at most 0.9
+    void reserve(size_t n)
+    {
+        size_t buckets = min_buckets;
+        while (buckets * bucket_width * 9 / 10 < n)
+        {
+            buckets *= 2;
+        }
+        if (buckets > m_bucket_count)
+        {
+            resize(buckets);
+        }
+    }
+
+    iterator begin() noexcept
+    {
+        iterator it = iterator_at(0);
+        it.skip_free();
+        return it;
+    }
+
+    iterator end() noexcept
+    {
+        return iterator_at(end_index());
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return const_cast<CuckooMap *>(this)->begin();
+    }
+
+    const_iterator end() const noexcept
+    {
+        return const_cast<CuckooMap *>(this)->end();
+    }
+
+    const_iterator cbegin() const noexcept
+    {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept
+    {
+        return end();
+    }
+
+    iterator find(K const &key)
+    {
+        size_t idx = find_index(key);
+        return iterator_at(idx == slot_count() ? end_index() : idx);
+    }
+
+    template <class Key>
+        requires TransparentHashEq<Hash, Eq>
+    iterator find(Key const &key)
+    {
+        size_t idx = find_index(key);
+        return iterator_at(idx == slot_count() ? end_index() : idx);
+    }
+
+    const_iterator find(K const &key) const
+    {
+        return const_cast<CuckooMap *>(this)->find(key);
+    }
+
+    template <class Key>
+        requires TransparentHashEq<Hash, Eq>
+    const_iterator find(Key const &key) const
+    {
+        return const_cast<CuckooMap *>(this)->find(key);
+    }
+
+    [[nodiscard]] bool contains(K const &key) const
+    {
+        return m_bucket_count && find_index(key) != slot_count();
+    }
+
+    template <class Key>
+        requires TransparentHashEq<Hash, Eq>
+    [[nodiscard]] bool contains(Key const &key) const
+    {
+        return m_bucket_count && find_index(key) != slot_count();
+    }
+
+    [[nodiscard]] size_t count(K const &key) const
+    {
+        return contains(key) ? 1 : 0;
+    }
+
+    template <class Key>
+        requires TransparentHashEq<Hash, Eq>
+    [[nodiscard]] size_t count(Key const &key) const
+    {
+        return contains(key) ? 1 : 0;
+    }
+
+    V &at(K const &key)
+    {
+        auto it = find(key);
+        if (it == end())
+            throw std::out_of_range("CuckooMap::at");
+        return it->second;
+    }
+
+    V const &at(K const &key) const
+    {
+        return const_cast<CuckooMap *>(this)->at(key);
+    }
+
+    V &operator[](K const &key)
+    {
+        size_t idx = try_emplace_index(key).first;
+        return m_slots[idx].second;
+    }
+
+    V &operator[](K &&key)
+    {
+        size_t idx = try_emplace_index(std::move(key)).first;
+        return m_slots[idx].second;
+    }
+
+    template <class... Args>
+    std::pair<iterator, bool> try_emplace(K const &key, Args &&...args)
+    {
+        auto [idx, inserted] = try_emplace_index(key, std::forward<Args>(args)...);
+        return {iterator_at(idx), inserted};
+    }
+
+    template <class... Args>
+    std::pair<iterator, bool> try_emplace(K &&key, Args &&...args)
+    {
+        auto [idx, inserted] = try_emplace_index(std::move(key), std::forward<Args>(args)...);
+        return {iterator_at(idx), inserted};
+    }
+
+    template <class... Args>
+    std::pair<iterator, bool> emplace(Args &&...args)
+    {
+        value_type val(std::forward<Args>(args)...);
+        return try_emplace(std::move(mutable_key(val)), std::move(val.second));
+    }
+
+    std::pair<iterator, bool> insert(value_type const &val)
+    {
+        return try_emplace(val.first, val.second);
+    }
+
+    std::pair<iterator, bool> insert(value_type &&val)
+    {
+        return try_emplace(std::move(mutable_key(val)), std::move(val.second));
+    }
+
+    template <std::input_iterator InputIt>
+    void insert(InputIt first, InputIt last)
+    {
+        for (; first != last; ++first)
+        {
+            insert(*first);
+        }
+    }
+
+    void insert(std::initializer_list<value_type> ilist)
+    {
+        insert(ilist.begin(), ilist.end());
+    }
+
+    template <class M>
+    std::pair<iterator, bool> insert_or_assign(K const &key, M &&obj)
+    {
+        auto [idx, inserted] = try_emplace_index(key, std::forward<M>(obj));
+        if (!inserted)
+        {
+            m_slots[idx].second = std::forward<M>(obj);
+        }
+        return {iterator_at(idx), inserted};
+    }
+
+    size_t erase(K const &key)
+    {
+        size_t idx = find_index(key);
+        if (idx == slot_count())
+            return 0;
+        erase_at(idx);
+        return 1;
+    }
+
+    template <class Key>
+        requires(TransparentHashEq<Hash, Eq> && !std::is_convertible_v<Key const &, const_iterator>)
+    size_t erase(Key const &key)
+    {
+        size_t idx = find_index(key);
+        if (idx == slot_count())
+            return 0;
+        erase_at(idx);
+        return 1;
+    }
+
+    // erasing never moves other elements
+    iterator erase(const_iterator pos) noexcept
+    {
+        size_t idx = pos.m_slot - m_slots;
+        erase_at(idx);
+        iterator it = iterator_at(idx);
+        it.skip_free();
+        return it;
+    }
+
+    iterator erase(iterator pos) noexcept
+    {
+        return erase(const_iterator(pos));
+    }
+
+    // Looks up every key of keys, storing a pointer to its value in out, or null if it is absent.
+    void find_many(std::span<K const> keys, std::span<V *> out)
+    {
+        if (out.size() < keys.size())
+            throw std::invalid_argument("CuckooMap::find_many: out is shorter than keys");
+        lookup_many(keys, [&](size_t i, size_t idx) { out[i] = idx == slot_count() ? nullptr : &m_slots[idx].second; });
+    }
+
+    void find_many(std::span<K const> keys, std::span<V const *> out) const
+    {
+        if (out.size() < keys.size())
+            throw std::invalid_argument("CuckooMap::find_many: out is shorter than keys");
+        lookup_many(keys, [&](size_t i, size_t idx) { out[i] = idx == slot_count() ? nullptr : &m_slots[idx].second; });
+    }
+
+    // as HashMap::contains_many()
+    template <std::output_iterator<bool> OutputIt>
+    size_t contains_many(std::span<K const> keys, OutputIt out) const
+    {
+        size_t found = 0;
+        lookup_many(keys, [&](size_t, size_t idx) {
+            bool present = idx != slot_count();
+            *out = present;
+            ++out;
+            found += present;
+        });
+        return found;
+    }
+
+    bool operator==(CuckooMap const &that) const
+    {
+        if (m_size != that.m_size)
+            return false;
+        for (auto const &item : *this)
+        {
+            auto it = that.find(item.first);
+            if (it == that.end() || !(it->second == item.second))
+                return false;
+        }
+        return true;
+    }
+};
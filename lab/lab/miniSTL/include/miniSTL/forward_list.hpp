@@ -0,0 +1,542 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <initializer_list>
+
+template <class T>
+struct ForwardListBaseNode
+{
+    ForwardListBaseNode *m_next;
+
+    inline T &value();
+
+    inline T const &value() const;
+};
+template <class T>
+struct ForwardListValueNode : ForwardListBaseNode<T>
+{
+    union
+    {
+        T m_value;
+    };
+};
+template <class T>
+inline T &ForwardListBaseNode<T>::value()
+{
+    return static_cast<ForwardListValueNode<T> &>(*this).m_value;
+}
+template <class T>
+inline T const &ForwardListBaseNode<T>::value() const
+{
+    return static_cast<ForwardListValueNode<T> const &>(*this).m_value;
+}
+
+// Singly linked counterpart of List: one link per node and no cached size. Nodes are smaller than
+// ListValueNode<T>, so a NodePool sized for List nodes of the same T can serve both containers.
+template <class T, class Alloc = std::allocator<T>>
+struct ForwardList
+{
+    using value_type = T;
+    using allocator_type = Alloc;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using pointer = T *;
+    using const_pointer = T const *;
+    using reference = T &;
+    using const_reference = T const &;
+
+private:
+    using ListNode = ForwardListBaseNode<T>;
+    using AllocNode = std::allocator_traits<Alloc>::template rebind_alloc<ForwardListValueNode<T>>;
+    using AllocTraits = std::allocator_traits<Alloc>;
+    using AllocNodeTraits = std::allocator_traits<AllocNode>;
+
+    ListNode m_head;
+    [[no_unique_address]] Alloc m_alloc;
+
+    template <class... Args>
+    ListNode *new_node(Args &&...args)
+    {
+        AllocNode alloc{m_alloc};
+        ForwardListValueNode<T> *node = AllocNodeTraits::allocate(alloc, 1);
+        try
+        {
+            AllocNodeTraits::construct(alloc, &node->m_value, std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            AllocNodeTraits::deallocate(alloc, node, 1);
+            throw;
+        }
+        return node;
+    }
+
+    void delete_node(ListNode *node) noexcept
+    {
+        AllocNode alloc{m_alloc};
+        auto *value_node = static_cast<ForwardListValueNode<T> *>(node);
+        AllocNodeTraits::destroy(alloc, &value_node->m_value);
+        AllocNodeTraits::deallocate(alloc, value_node, 1);
+    }
+
+    // appends [first, last) to an empty list; each node is terminated as it is linked, so the
+    // list stays walkable for clear() if a constructor throws
+    template <std::input_iterator InputIt>
+    void init_move(InputIt first, InputIt last)
+    {
+        ListNode *prev = &m_head;
+        for (; first != last; ++first)
+        {
+            ListNode *node = new_node(*first);
+            node->m_next = nullptr;
+            prev->m_next = node;
+            prev = node;
+        }
+    }
+
+public:
+    struct iterator
+    {
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = ptrdiff_t;
+        using pointer = T *;
+        using reference = T &;
+
+    private:
+        ListNode *m_curr;
+
+        friend ForwardList;
+
+        explicit iterator(ListNode *curr) noexcept : m_curr(curr) {}
+
+    public:
+        iterator() = default;
+
+        iterator &operator++() noexcept
+        {
+            m_curr = m_curr->m_next;
+            return *this;
+        }
+
+        iterator operator++(int) noexcept
+        {
+            auto ret = *this;
+            m_curr = m_curr->m_next;
+            return ret;
+        }
+
+        T &operator*() const noexcept
+        {
+            return m_curr->value();
+        }
+
+        T *operator->() const noexcept
+        {
+            return &m_curr->value();
+        }
+
+        bool operator!=(iterator const &that) const noexcept
+        {
+            return !(*this == that);
+        }
+
+        bool operator==(iterator const &that) const noexcept
+        {
+            return m_curr == that.m_curr;
+        }
+    };
+
+    struct const_iterator
+    {
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = ptrdiff_t;
+        using pointer = T const *;
+        using reference = T const &;
+
+    private:
+        ListNode const *m_curr;
+
+        friend ForwardList;
+
+        explicit const_iterator(ListNode const *curr) noexcept : m_curr(curr) {}
+
+    public:
+        const_iterator() = default;
+
+        const_iterator(iterator that) noexcept : m_curr(that.m_curr) {}
+
+        explicit operator iterator() noexcept
+        {
+            return iterator{const_cast<ListNode *>(m_curr)};
+        }
+
+        const_iterator &operator++() noexcept
+        {
+            m_curr = m_curr->m_next;
+            return *this;
+        }
+
+        const_iterator operator++(int) noexcept
+        {
+            auto ret = *this;
+            m_curr = m_curr->m_next;
+            return ret;
+        }
+
+        T const &operator*() const noexcept
+        {
+            return m_curr->value();
+        }
+
+        T const *operator->() const noexcept
+        {
+            return &m_curr->value();
+        }
+
+        bool operator!=(const_iterator const &that) const noexcept
+        {
+            return !(*this == that);
+        }
+
+        bool operator==(const_iterator const &that) const noexcept
+        {
+            return m_curr == that.m_curr;
+        }
+    };
+
+    ForwardList() : ForwardList(Alloc())
+    {
+    }
+
+    explicit ForwardList(Alloc const &alloc) noexcept : m_alloc(alloc)
+    {
+        m_head.m_next = nullptr;
+    }
+
+    ForwardList(size_t n, T const &val, Alloc const &alloc = Alloc()) : ForwardList(alloc)
+    {
+        ListNode *prev = &m_head;
+        while (n--)
+        {
+            ListNode *node = new_node(val);
+            node->m_next = nullptr;
+            prev->m_next = node;
+            prev = node;
+        }
+    }
+
+    template <std::input_iterator InputIt>
+    ForwardList(InputIt first, InputIt last, Alloc const &alloc = Alloc()) : ForwardList(alloc)
+    {
+        init_move(first, last);
+    }
+
+    ForwardList(std::initializer_list<T> ilist, Alloc const &alloc = Alloc())
+        : ForwardList(ilist.begin(), ilist.end(), alloc)
+    {
+    }
+
+    ForwardList(ForwardList const &that)
+        : ForwardList(that.cbegin(), that.cend(), AllocTraits::select_on_container_copy_construction(that.m_alloc))
+    {
+    }
+
+    ForwardList(ForwardList &&that) noexcept : m_alloc(std::move(that.m_alloc))
+    {
+        m_head.m_next = that.m_head.m_next;
+        that.m_head.m_next = nullptr;
+    }
+
+    ForwardList &operator=(ForwardList const &that)
+    {
+        if (this == &that)
+            return *this;
+        clear();
+        if constexpr (AllocTraits::propagate_on_container_copy_assignment::value)
+        {
+            m_alloc = that.m_alloc;
+        }
+        init_move(that.cbegin(), that.cend());
+        return *this;
+    }
+
+    ForwardList &operator=(ForwardList &&that) noexcept(AllocTraits::propagate_on_container_move_assignment::value ||
+                                                        AllocTraits::is_always_equal::value)
+    {
+        if (this == &that)
+            return *this;
+        clear();
+        if constexpr (!AllocTraits::propagate_on_container_move_assignment::value &&
+                      !AllocTraits::is_always_equal::value)
+        {
+            if (m_alloc != that.m_alloc)
+            {
+                init_move(std::make_move_iterator(that.begin()), std::make_move_iterator(that.end()));
+                that.clear();
+                return *this;
+            }
+        }
+        if constexpr (AllocTraits::propagate_on_container_move_assignment::value)
+        {
+            m_alloc = std::move(that.m_alloc);
+        }
+        m_head.m_next = that.m_head.m_next;
+        that.m_head.m_next = nullptr;
+        return *this;
+    }
+
+    ~ForwardList()
+    {
+        clear();
+    }
+
+    void swap(ForwardList &that) noexcept
+    {
+        std::swap(m_head.m_next, that.m_head.m_next);
+        if constexpr (AllocTraits::propagate_on_container_swap::value)
+        {
+            std::swap(m_alloc, that.m_alloc);
+        }
+    }
+
+    Alloc get_allocator() const noexcept
+    {
+        return m_alloc;
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return m_head.m_next == nullptr;
+    }
+
+    T &front() noexcept
+    {
+        return m_head.m_next->value();
+    }
+
+    T const &front() const noexcept
+    {
+        return m_head.m_next->value();
+    }
+
+    iterator before_begin() noexcept
+    {
+        return iterator{&m_head};
+    }
+
+    const_iterator cbefore_begin() const noexcept
+    {
+        return const_iterator{&m_head};
+    }
+
+    const_iterator before_begin() const noexcept
+    {
+        return cbefore_begin();
+    }
+
+    iterator begin() noexcept
+    {
+        return iterator{m_head.m_next};
+    }
+
+    iterator end() noexcept
+    {
+        return iterator{nullptr};
+    }
+
+    const_iterator cbegin() const noexcept
+    {
+        return const_iterator{m_head.m_next};
+    }
+
+    const_iterator cend() const noexcept
+    {
+        return const_iterator{nullptr};
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return cbegin();
+    }
+
+    const_iterator end() const noexcept
+    {
+        return cend();
+    }
+
+    void clear() noexcept
+    {
+        ListNode *cur = m_head.m_next;
+        while (cur)
+        {
+            ListNode *next = cur->m_next;
+            delete_node(cur);
+            cur = next;
+        }
+        m_head.m_next = nullptr;
+    }
+
+    template <class... Args>
+    iterator emplace_after(const_iterator pos, Args &&...args)
+    {
+        auto *prev = const_cast<ListNode *>(pos.m_curr);
+        ListNode *node = new_node(std::forward<Args>(args)...);
+        node->m_next = prev->m_next;
+        prev->m_next = node;
+        return iterator{node};
+    }
+
+    template <class... Args>
+    T &emplace_front(Args &&...args)
+    {
+        return *emplace_after(cbefore_begin(), std::forward<Args>(args)...);
+    }
+
+    void push_front(T const &val)
+    {
+        emplace_front(val);
+    }
+
+    void push_front(T &&val)
+    {
+        emplace_front(std::move(val));
+    }
+
+    iterator insert_after(const_iterator pos, T const &val)
+    {
+        return emplace_after(pos, val);
+    }
+
+    iterator insert_after(const_iterator pos, T &&val)
+    {
+        return emplace_after(pos, std::move(val));
+    }
+
+    iterator insert_after(const_iterator pos, size_t n, T const &val)
+    {
+        auto *prev = const_cast<ListNode *>(pos.m_curr);
+        while (n--)
+        {
+            prev = emplace_after(const_iterator{prev}, val).m_curr;
+        }
+        return iterator{prev};
+    }
+
+    template <std::input_iterator InputIt>
+    iterator insert_after(const_iterator pos, InputIt first, InputIt last)
+    {
+        auto *prev = const_cast<ListNode *>(pos.m_curr);
+        for (; first != last; ++first)
+        {
+            prev = emplace_after(const_iterator{prev}, *first).m_curr;
+        }
+        return iterator{prev};
+    }
+
+    iterator insert_after(const_iterator pos, std::initializer_list<T> ilist)
+    {
+        return insert_after(pos, ilist.begin(), ilist.end());
+    }
+
+    iterator erase_after(const_iterator pos) noexcept
+    {
+        auto *prev = const_cast<ListNode *>(pos.m_curr);
+        ListNode *node = prev->m_next;
+        prev->m_next = node->m_next;
+        delete_node(node);
+        return iterator{prev->m_next};
+    }
+
+    // erases the open range (pos, last)
+    iterator erase_after(const_iterator pos, const_iterator last) noexcept
+    {
+        auto *prev = const_cast<ListNode *>(pos.m_curr);
+        auto *end = const_cast<ListNode *>(last.m_curr);
+        ListNode *cur = prev->m_next;
+        while (cur != end)
+        {
+            ListNode *next = cur->m_next;
+            delete_node(cur);
+            cur = next;
+        }
+        prev->m_next = end;
+        return iterator{end};
+    }
+
+    void pop_front() noexcept
+    {
+        erase_after(cbefore_begin());
+    }
+
+    // moves all of other's nodes after pos
+    void splice_after(const_iterator pos, ForwardList &other) noexcept
+    {
+        splice_after(pos, other, other.cbefore_begin(), other.cend());
+    }
+
+    void splice_after(const_iterator pos, ForwardList &&other) noexcept
+    {
+        splice_after(pos, other);
+    }
+
+    // moves the node following it after pos
+    void splice_after(const_iterator pos, ForwardList &other, const_iterator it) noexcept
+    {
+        auto *prev = const_cast<ListNode *>(pos.m_curr);
+        auto *before = const_cast<ListNode *>(it.m_curr);
+        ListNode *node = before->m_next;
+        if (prev == before || prev == node)
+            return;
+        before->m_next = node->m_next;
+        node->m_next = prev->m_next;
+        prev->m_next = node;
+        (void)other;
+    }
+
+    void splice_after(const_iterator pos, ForwardList &&other, const_iterator it) noexcept
+    {
+        splice_after(pos, other, it);
+    }
+
+    // moves the open range (first, last) after pos; linear only in the walk to the range's tail
+    void splice_after(const_iterator pos, ForwardList &other, const_iterator first, const_iterator last) noexcept
+    {
+        auto *prev = const_cast<ListNode *>(pos.m_curr);
+        auto *before = const_cast<ListNode *>(first.m_curr);
+        auto *end = const_cast<ListNode *>(last.m_curr);
+        if (before->m_next == end)
+            return;
+        ListNode *tail = before->m_next;
+        while (tail->m_next != end)
+        {
+            tail = tail->m_next;
+        }
+        ListNode *head = before->m_next;
+        before->m_next = end;
+        tail->m_next = prev->m_next;
+        prev->m_next = head;
+        (void)other;
+    }
+
+    void splice_after(const_iterator pos, ForwardList &&other, const_iterator first, const_iterator last) noexcept
+    {
+        splice_after(pos, other, first, last);
+    }
+
+    bool operator==(ForwardList const &that) const noexcept
+    {
+        auto it = cbegin();
+        auto that_it = that.cbegin();
+        for (; it != cend() && that_it != that.cend(); ++it, ++that_it)
+        {
+            if (!(*it == *that_it))
+                return false;
+        }
+        return it == cend() && that_it == that.cend();
+    }
+};
@@ -0,0 +1,254 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Non-cryptographic hashing for the miniSTL hash containers. Every function here is built on one
+// primitive, the folded multiply: the 128-bit product of two 64-bit words with its halves xored
+// together, which mixes every input bit into every output bit in a few cycles.
+//
+// hash_bytes() follows wyhash (final version 4): short inputs are read in two overlapping loads,
+// long ones 48 bytes per round in three independent lanes so the multiplies overlap. hash_int()
+// is two folded multiplies, enough to spread sequential or strided integers over the low bits that
+// power-of-two tables index with, which std::hash's identity for integers does not. Seeds change
+// every hash; a seed from random_hash_seed() keeps an attacker from crafting colliding keys.
+// Hashes are stable within a build on one platform but are no file format.
+
+inline constexpr uint64_t hash_secret[4] = {0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull,
+                                            0x4d5a2da51de1aa47ull};
+
+// the 128-bit product of a and b, low half in a and high half in b
+inline void hash_multiply(uint64_t &a, uint64_t &b) noexcept
+{
+#if defined(__SIZEOF_INT128__)
+    __uint128_t r = static_cast<__uint128_t>(a) * b;
+    a = static_cast<uint64_t>(r);
+    b = static_cast<uint64_t>(r >> 64);
+#else
+    uint64_t ha = a >> 32, hb = b >> 32, la = static_cast<uint32_t>(a), lb = static_cast<uint32_t>(b);
+    uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    uint64_t t = rl + (rm0 << 32);
+    uint64_t carry = t < rl;
+    uint64_t lo = t + (rm1 << 32);
+    carry += lo < t;
+    a = lo;
+    b = rh + (rm0 >> 32) + (rm1 >> 32) + carry;
+#endif
+}
+
+inline uint64_t hash_mix(uint64_t a, uint64_t b) noexcept
+{
+    hash_multiply(a, b);
+    return a ^ b;
+}
+
+inline uint64_t hash_read8(unsigned char const *p) noexcept
+{
+    uint64_t v;
+    std::memcpy(&v, p, 8);
+    return v;
+}
+
+inline uint64_t hash_read4(unsigned char const *p) noexcept
+{
+    uint32_t v;
+    std::memcpy(&v, p, 4);
+    return v;
+}
+
+// one to three bytes, each read exactly once or twice
+inline uint64_t hash_read3(unsigned char const *p, size_t len) noexcept
+{
+    return (uint64_t(p[0]) << 16) | (uint64_t(p[len >> 1]) << 8) | p[len - 1];
+}
+
+inline uint64_t hash_bytes(void const *data, size_t len, uint64_t seed = 0) noexcept
+{
+    auto const *p = static_cast<unsigned char const *>(data);
+    seed ^= hash_mix(seed ^ hash_secret[0], hash_secret[1]);
+    uint64_t a, b;
+    if (len <= 16)
+    {
+        if (len >= 4)
+        {
+            size_t mid = (len >> 3) << 2;
+            a = (hash_read4(p) << 32) | hash_read4(p + mid);
+            b = (hash_read4(p + len - 4) << 32) | hash_read4(p + len - 4 - mid);
+        }
+        else if (len > 0)
+        {
+            a = hash_read3(p, len);
+            b = 0;
+        }
+        else
+        {
+            a = b = 0;
+        }
+    }
+    else
+    {
+        size_t i = len;
+        if (i >= 48)
+        {
+            uint64_t see1 = seed, see2 = seed;
+            do
+            {
+                seed = hash_mix(hash_read8(p) ^ hash_secret[1], hash_read8(p + 8) ^ seed);
+                see1 = hash_mix(hash_read8(p + 16) ^ hash_secret[2], hash_read8(p + 24) ^ see1);
+                see2 = hash_mix(hash_read8(p + 32) ^ hash_secret[3], hash_read8(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i >= 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16)
+        {
+            seed = hash_mix(hash_read8(p) ^ hash_secret[1], hash_read8(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        // the last 16 bytes, overlapping what came before if need be
+        a = hash_read8(p + i - 16);
+        b = hash_read8(p + i - 8);
+    }
+    a ^= hash_secret[1];
+    b ^= seed;
+    hash_multiply(a, b);
+    return hash_mix(a ^ hash_secret[0] ^ len, b ^ hash_secret[1]);
+}
+
+// One folded multiply leaves the output bits of nearby inputs correlated (about 35 of 64 bits flip
+// per flipped input bit); a second one brings that to the ideal 32.
+inline uint64_t hash_int(uint64_t x, uint64_t seed = 0) noexcept
+{
+    return hash_mix(hash_mix(x ^ seed ^ hash_secret[0], hash_secret[1]), hash_secret[2]);
+}
+
+// Folds the hash of one more value into h; the order of the values matters.
+inline uint64_t hash_combine(uint64_t h, uint64_t value_hash) noexcept
+{
+    return hash_mix(h ^ hash_secret[2], value_hash ^ hash_secret[3]);
+}
+
+// A seed drawn once per process, so hashes differ from run to run and cannot be predicted.
+inline uint64_t random_hash_seed() noexcept
+{
+    static uint64_t const seed = [] {
+        std::random_device rd;
+        uint64_t s = (uint64_t(rd()) << 32) ^ rd();
+        return hash_int(s ^ reinterpret_cast<uintptr_t>(&rd));
+    }();
+    return seed;
+}
+
+template <class T>
+inline constexpr bool is_hash_tuple_like = requires { std::tuple_size<T>::value; };
+
+template <class T>
+uint64_t hash_value(T const &val, uint64_t seed = 0);
+
+// Hashes several values as one, e.g. the members of a struct:
+//     size_t operator()(Point p) const { return hash_values(0, p.x, p.y); }
+template <class... Ts>
+uint64_t hash_values(uint64_t seed, Ts const &...vals)
+{
+    uint64_t h = hash_int(sizeof...(Ts), seed);
+    ((h = hash_combine(h, hash_value(vals, seed))), ...);
+    return h;
+}
+
+// Integers, enums, pointers, floating point numbers, strings and tuple-likes (std::pair,
+// std::tuple, std::array) of those are hashed here; anything else goes through std::hash and one
+// more mixing step.
+template <class T>
+uint64_t hash_value(T const &val, uint64_t seed)
+{
+    if constexpr (std::is_integral_v<T> || std::is_enum_v<T>)
+    {
+        return hash_int(static_cast<uint64_t>(val), seed);
+    }
+    else if constexpr (std::is_pointer_v<T>)
+    {
+        return hash_int(reinterpret_cast<uintptr_t>(val), seed);
+    }
+    else if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>)
+    {
+        // +0 and -0 compare equal, so they must hash equal
+        using Bits = std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>;
+        return hash_int(val == T(0) ? 0 : std::bit_cast<Bits>(val), seed);
+    }
+    else if constexpr (std::is_convertible_v<T const &, std::string_view>)
+    {
+        std::string_view str = val;
+        return hash_bytes(str.data(), str.size(), seed);
+    }
+    else if constexpr (is_hash_tuple_like<T>)
+    {
+        return std::apply([seed](auto const &...elems) { return hash_values(seed, elems...); }, val);
+    }
+    else
+    {
+        return hash_int(std::hash<T>{}(val), seed);
+    }
+}
+
+// Hash functor for the miniSTL containers and their default. The seed is zero unless given, so
+// hashes are reproducible; pass random_hash_seed() where keys may come from an adversary.
+template <class T>
+struct FastHash
+{
+    uint64_t m_seed = 0;
+
+    FastHash() = default;
+
+    explicit FastHash(uint64_t seed) noexcept : m_seed(seed)
+    {
+    }
+
+    size_t operator()(T const &val) const
+    {
+        return static_cast<size_t>(hash_value(val, m_seed));
+    }
+};
+
+// Hashes every string type through its characters, so std::string, std::string_view and C strings
+// with equal contents hash alike; with std::equal_to<> as Eq a map of std::string then finds keys
+// by std::string_view or const char * without building a std::string.
+struct FastStringHash
+{
+    using is_transparent = void;
+
+    uint64_t m_seed = 0;
+
+    FastStringHash() = default;
+
+    explicit FastStringHash(uint64_t seed) noexcept : m_seed(seed)
+    {
+    }
+
+    size_t operator()(std::string_view str) const noexcept
+    {
+        return static_cast<size_t>(hash_bytes(str.data(), str.size(), m_seed));
+    }
+};
+
+template <>
+struct FastHash<std::string> : FastStringHash
+{
+    using FastStringHash::FastStringHash;
+};
+
+template <>
+struct FastHash<std::string_view> : FastStringHash
+{
+    using FastStringHash::FastStringHash;
+};
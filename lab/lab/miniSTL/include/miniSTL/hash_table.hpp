@@ -0,0 +1,3541 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <miniSTL/forward_list.hpp>
+#include <miniSTL/hash.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MINISTL_HAS_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// Asks for the cache line holding addr to be loaded ahead of a read; a no-op where no prefetch
+// instruction is available.
+inline void prefetch_read(void const *addr) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(addr, 0, 3);
+#elif defined(MINISTL_HAS_SSE2)
+    _mm_prefetch(static_cast<char const *>(addr), _MM_HINT_T0);
+#endif
+}
+
+// Keys hashed and prefetched ahead of probing by the find_many() of the hash maps: enough misses
+// in flight to cover DRAM latency, few enough that the prefetched lines are still cached when
+// their probe comes.
+inline constexpr size_t lookup_batch = 16;
+
+// Lookups (find, contains, count, erase) also take any Key that Hash and Eq accept when both
+// declare is_transparent, as with std::unordered_map, so a std::string_view finds a std::string
+// key without building a std::string. Hash must give equal keys equal hashes across the types.
+template <class Hash, class Eq>
+concept TransparentHashEq = requires {
+    typename Hash::is_transparent;
+    typename Eq::is_transparent;
+};
+
+// Control bytes of an open-addressing table: one per slot, EMPTY or DELETED (sign bit set) or the
+// low 7 bits of the hash of a full slot.
+enum class Ctrl : int8_t
+{
+    Empty = -128,
+    Deleted = -2,
+};
+
+// Bit i of a GroupMask stands for byte i of the group it was computed from.
+struct GroupMask
+{
+    uint32_t m_bits;
+
+    explicit operator bool() const noexcept
+    {
+        return m_bits != 0;
+    }
+
+    unsigned lowest() const noexcept
+    {
+        return std::countr_zero(m_bits);
+    }
+
+    unsigned leading_zeros() const noexcept
+    {
+        return std::countl_zero(m_bits) - 16;
+    }
+
+    unsigned trailing_zeros() const noexcept
+    {
+        return std::countr_zero(m_bits);
+    }
+
+    GroupMask &operator++() noexcept
+    {
+        m_bits &= m_bits - 1;
+        return *this;
+    }
+
+    unsigned operator*() const noexcept
+    {
+        return lowest();
+    }
+
+    GroupMask begin() const noexcept
+    {
+        return *this;
+    }
+
+    GroupMask end() const noexcept
+    {
+        return GroupMask{0};
+    }
+
+    bool operator!=(GroupMask const &that) const noexcept
+    {
+        return m_bits != that.m_bits;
+    }
+};
+
+// Sixteen control bytes compared at once: with SSE2 one load and one compare per query, otherwise
+// a plain byte loop the compiler can still vectorise.
+struct CtrlGroup
+{
+    static constexpr size_t width = 16;
+
+#ifdef MINISTL_HAS_SSE2
+    __m128i m_ctrl;
+
+    explicit CtrlGroup(int8_t const *ctrl) noexcept : m_ctrl(_mm_loadu_si128(reinterpret_cast<__m128i const *>(ctrl)))
+    {
+    }
+
+    GroupMask match(int8_t h2) const noexcept
+    {
+        return GroupMask{static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), m_ctrl)))};
+    }
+
+    GroupMask match_empty() const noexcept
+    {
+        return match(static_cast<int8_t>(Ctrl::Empty));
+    }
+
+    // empty and deleted are the only control bytes with the sign bit set
+    GroupMask match_empty_or_deleted() const noexcept
+    {
+        return GroupMask{static_cast<uint32_t>(_mm_movemask_epi8(m_ctrl))};
+    }
+#else
+    int8_t m_ctrl[width];
+
+    explicit CtrlGroup(int8_t const *ctrl) noexcept
+    {
+        std::memcpy(m_ctrl, ctrl, width);
+    }
+
+    GroupMask match(int8_t h2) const noexcept
+    {
+        uint32_t bits = 0;
+        for (size_t i = 0; i < width; i++)
+        {
+            bits |= uint32_t(m_ctrl[i] == h2) << i;
+        }
+        return GroupMask{bits};
+    }
+
+    GroupMask match_empty() const noexcept
+    {
+        return match(static_cast<int8_t>(Ctrl::Empty));
+    }
+
+    GroupMask match_empty_or_deleted() const noexcept
+    {
+        uint32_t bits = 0;
+        for (size_t i = 0; i < width; i++)
+        {
+            bits |= uint32_t(m_ctrl[i] < 0) << i;
+        }
+        return GroupMask{bits};
+    }
+#endif
+};
+
+// Flat hash map in the SwissTable layout: slots hold the pairs themselves, next to an array of one
+// control byte per slot. A lookup hashes once, starts at H1 (the high bits) and compares H2 (the low
+// 7 bits) against a whole group of control bytes, touching slots only on a 7-bit match; it stops at
+// the first group with an empty byte. Groups are probed triangularly, which visits every group of
+// the power-of-two table.
+//
+// The first group of control bytes is mirrored past the end so a group can start at any slot.
+// Erased slots become DELETED only if some probe could have passed through them; together with
+// full slots they count against the 7/8 maximum load. When that is reached with live elements
+// filling no more than 25/32 of the slots, the table is rehashed in place instead of grown.
+//
+// The hash is mixed once more before H1 and H2 are split off, so Hash need not spread its bits;
+// std::hash on integers, which returns the key itself, works as well as the default FastHash.
+//
+// Inserting may move elements and invalidates iterators and references on a rehash.
+template <class K, class V, class Hash = FastHash<K>, class Eq = std::equal_to<K>,
+          class Alloc = std::allocator<std::pair<K const, V>>>
+struct HashMap
+{
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = std::pair<K const, V>;
+    using hasher = Hash;
+    using key_equal = Eq;
+    using allocator_type = Alloc;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using pointer = value_type *;
+    using const_pointer = value_type const *;
+    using reference = value_type &;
+    using const_reference = value_type const &;
+
+private:
+    using AllocTraits = std::allocator_traits<Alloc>;
+    using AllocCtrl = AllocTraits::template rebind_alloc<int8_t>;
+    using AllocCtrlTraits = std::allocator_traits<AllocCtrl>;
+
+    static constexpr size_t group_width = CtrlGroup::width;
+    static constexpr size_t min_capacity = group_width;
+
+    int8_t *m_ctrl;
+    value_type *m_slots;
+    size_t m_capacity;
+    size_t m_size;
+    size_t m_growth_left;
+    [[no_unique_address]] Hash m_hash;
+    [[no_unique_address]] Eq m_eq;
+    [[no_unique_address]] Alloc m_alloc;
+
+    // one folded multiply, which carries every bit of m_hash's result into both halves of the word
+    template <class Key>
+    size_t hash_of(Key const &key) const
+    {
+        return static_cast<size_t>(hash_mix(static_cast<uint64_t>(m_hash(key)), 0x9e3779b97f4a7c15ull));
+    }
+
+    static size_t h1(size_t hash) noexcept
+    {
+        return hash >> 7;
+    }
+
+    static int8_t h2(size_t hash) noexcept
+    {
+        return static_cast<int8_t>(hash & 0x7f);
+    }
+
+    static size_t max_load(size_t capacity) noexcept
+    {
+        return capacity - capacity / 8;
+    }
+
+    // smallest power-of-two capacity whose 7/8 load holds n elements
+    static size_t capacity_for(size_t n) noexcept
+    {
+        size_t capacity = min_capacity;
+        while (max_load(capacity) < n)
+        {
+            capacity *= 2;
+        }
+        return capacity;
+    }
+
+    static bool is_full(int8_t ctrl) noexcept
+    {
+        return ctrl >= 0;
+    }
+
+    static K &mutable_key(value_type &val) noexcept
+    {
+        return const_cast<K &>(val.first);
+    }
+
+    // writes a control byte and its mirror past the end
+    void set_ctrl(size_t i, int8_t ctrl) noexcept
+    {
+        m_ctrl[i] = ctrl;
+        if (i < group_width)
+        {
+            m_ctrl[m_capacity + i] = ctrl;
+        }
+    }
+
+    void set_ctrl(size_t i, Ctrl ctrl) noexcept
+    {
+        set_ctrl(i, static_cast<int8_t>(ctrl));
+    }
+
+    // first empty or deleted slot on the probe sequence of hash
+    size_t find_first_non_full(size_t hash) const noexcept
+    {
+        size_t mask = m_capacity - 1;
+        size_t offset = h1(hash) & mask;
+        for (size_t step = group_width;; step += group_width)
+        {
+            GroupMask free = CtrlGroup(m_ctrl + offset).match_empty_or_deleted();
+            if (free)
+                return (offset + free.lowest()) & mask;
+            offset = (offset + step) & mask;
+        }
+    }
+
+    template <class Key>
+    size_t find_index(Key const &key, size_t hash) const
+    {
+        if (m_capacity == 0)
+            return m_capacity;
+        size_t mask = m_capacity - 1;
+        size_t offset = h1(hash) & mask;
+        for (size_t step = group_width;; step += group_width)
+        {
+            CtrlGroup group(m_ctrl + offset);
+            for (unsigned i : group.match(h2(hash)))
+            {
+                size_t idx = (offset + i) & mask;
+                if (m_eq(m_slots[idx].first, key))
+                    return idx;
+            }
+            if (group.match_empty())
+                return m_capacity;
+            offset = (offset + step) & mask;
+        }
+    }
+
+    void allocate_table(size_t capacity)
+    {
+        AllocCtrl ctrl_alloc{m_alloc};
+        int8_t *ctrl = AllocCtrlTraits::allocate(ctrl_alloc, capacity + group_width);
+        try
+        {
+            m_slots = AllocTraits::allocate(m_alloc, capacity);
+        }
+        catch (...)
+        {
+            AllocCtrlTraits::deallocate(ctrl_alloc, ctrl, capacity + group_width);
+            throw;
+        }
+        m_ctrl = ctrl;
+        std::memset(m_ctrl, static_cast<int8_t>(Ctrl::Empty), capacity + group_width);
+        m_capacity = capacity;
+        m_growth_left = max_load(capacity) - m_size;
+    }
+
+    void deallocate_table() noexcept
+    {
+        if (m_capacity == 0)
+            return;
+        AllocCtrl ctrl_alloc{m_alloc};
+        AllocCtrlTraits::deallocate(ctrl_alloc, m_ctrl, m_capacity + group_width);
+        AllocTraits::deallocate(m_alloc, m_slots, m_capacity);
+        m_ctrl = nullptr;
+        m_slots = nullptr;
+        m_capacity = 0;
+        m_growth_left = 0;
+    }
+
+    void destroy_all() noexcept
+    {
+        for (size_t i = 0; i < m_capacity; i++)
+        {
+            if (is_full(m_ctrl[i]))
+            {
+                AllocTraits::destroy(m_alloc, &m_slots[i]);
+            }
+        }
+    }
+
+    // Moves every element into a fresh table of new_capacity slots. Nothing can compare equal, so
+    // each element goes straight to the first free slot of its probe sequence.
+    void resize(size_t new_capacity)
+    {
+        int8_t *old_ctrl = m_ctrl;
+        value_type *old_slots = m_slots;
+        size_t old_capacity = m_capacity;
+        allocate_table(new_capacity);
+        for (size_t i = 0; i < old_capacity; i++)
+        {
+            if (!is_full(old_ctrl[i]))
+                continue;
+            size_t hash = hash_of(old_slots[i].first);
+            size_t target = find_first_non_full(hash);
+            set_ctrl(target, h2(hash));
+            AllocTraits::construct(m_alloc, &m_slots[target], std::move(mutable_key(old_slots[i])),
+                                   std::move(old_slots[i].second));
+            AllocTraits::destroy(m_alloc, &old_slots[i]);
+        }
+        if (old_capacity)
+        {
+            AllocCtrl ctrl_alloc{m_alloc};
+            AllocCtrlTraits::deallocate(ctrl_alloc, old_ctrl, old_capacity + group_width);
+            AllocTraits::deallocate(m_alloc, old_slots, old_capacity);
+        }
+    }
+
+    void move_slot(size_t from, size_t to)
+    {
+        AllocTraits::construct(m_alloc, &m_slots[to], std::move(mutable_key(m_slots[from])),
+                               std::move(m_slots[from].second));
+        AllocTraits::destroy(m_alloc, &m_slots[from]);
+    }
+
+    // Clears out tombstones without reallocating. Every full slot is first marked DELETED and every
+    // DELETED one EMPTY; then each marked element is put back on the first free slot of its probe
+    // sequence, staying where it is when that lies in the same group, and trading places with a
+    // still-marked element when the free slot is one of those.
+    void drop_deletes_without_resize()
+    {
+        for (size_t i = 0; i < m_capacity; i++)
+        {
+            m_ctrl[i] = static_cast<int8_t>(is_full(m_ctrl[i]) ? Ctrl::Deleted : Ctrl::Empty);
+        }
+        std::memcpy(m_ctrl + m_capacity, m_ctrl, group_width);
+
+        size_t mask = m_capacity - 1;
+        alignas(value_type) std::byte tmp_storage[sizeof(value_type)];
+        auto *tmp = reinterpret_cast<value_type *>(tmp_storage);
+        for (size_t i = 0; i < m_capacity; i++)
+        {
+            if (m_ctrl[i] != static_cast<int8_t>(Ctrl::Deleted))
+                continue;
+            size_t hash = hash_of(m_slots[i].first);
+            size_t target = find_first_non_full(hash);
+            size_t probe_start = h1(hash) & mask;
+            if ((((i - probe_start) & mask) / group_width) == (((target - probe_start) & mask) / group_width))
+            {
+                set_ctrl(i, h2(hash));
+                continue;
+            }
+            if (m_ctrl[target] == static_cast<int8_t>(Ctrl::Empty))
+            {
+                set_ctrl(target, h2(hash));
+                move_slot(i, target);
+                set_ctrl(i, Ctrl::Empty);
+            }
+            else
+            {
+                set_ctrl(target, h2(hash));
+                AllocTraits::construct(m_alloc, tmp, std::move(mutable_key(m_slots[target])),
+                                       std::move(m_slots[target].second));
+                AllocTraits::destroy(m_alloc, &m_slots[target]);
+                move_slot(i, target);
+                AllocTraits::construct(m_alloc, &m_slots[i], std::move(mutable_key(*tmp)), std::move(tmp->second));
+                AllocTraits::destroy(m_alloc, tmp);
+                --i;
+            }
+        }
+        m_growth_left = max_load(m_capacity) - m_size;
+    }
+
+    void rehash_and_grow_if_necessary()
+    {
+        if (m_capacity > group_width && m_size * 32 <= m_capacity * 25)
+        {
+            drop_deletes_without_resize();
+        }
+        else
+        {
+            resize(m_capacity ? m_capacity * 2 : min_capacity);
+        }
+    }
+
+    // claims the slot a new element with this hash goes to; the caller constructs it
+    size_t prepare_insert(size_t hash)
+    {
+        size_t target = m_capacity ? find_first_non_full(hash) : 0;
+        if (m_growth_left == 0 && (m_capacity == 0 || m_ctrl[target] != static_cast<int8_t>(Ctrl::Deleted)))
+        {
+            rehash_and_grow_if_necessary();
+            target = find_first_non_full(hash);
+        }
+        if (m_ctrl[target] == static_cast<int8_t>(Ctrl::Empty))
+        {
+            --m_growth_left;
+        }
+        set_ctrl(target, h2(hash));
+        ++m_size;
+        return target;
+    }
+
+    // undoes prepare_insert when the element's constructor throws
+    void abandon_insert(size_t idx) noexcept
+    {
+        set_ctrl(idx, Ctrl::Deleted);
+        --m_size;
+    }
+
+    template <class... Args>
+    size_t construct_at_new_slot(size_t hash, Args &&...args)
+    {
+        size_t idx = prepare_insert(hash);
+        try
+        {
+            AllocTraits::construct(m_alloc, &m_slots[idx], std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            abandon_insert(idx);
+            throw;
+        }
+        return idx;
+    }
+
+    // An erased slot may only go back to EMPTY if no probe ever saw a full group around it:
+    // that holds when the empty bytes just before and just after it leave a gap under one group.
+    void erase_at(size_t idx) noexcept
+    {
+        AllocTraits::destroy(m_alloc, &m_slots[idx]);
+        --m_size;
+        size_t before = (idx - group_width) & (m_capacity - 1);
+        GroupMask empty_after = CtrlGroup(m_ctrl + idx).match_empty();
+        GroupMask empty_before = CtrlGroup(m_ctrl + before).match_empty();
+        bool was_never_full = empty_before && empty_after &&
+                              empty_after.trailing_zeros() + empty_before.leading_zeros() < group_width;
+        if (was_never_full)
+        {
+            set_ctrl(idx, Ctrl::Empty);
+            ++m_growth_left;
+        }
+        else
+        {
+            set_ctrl(idx, Ctrl::Deleted);
+        }
+    }
+
+    void copy_from(HashMap const &that)
+    {
+        if (that.m_size == 0)
+            return;
+        allocate_table(capacity_for(that.m_size));
+        for (auto const &item : that)
+        {
+            construct_at_new_slot(hash_of(item.first), item);
+        }
+    }
+
+    void steal(HashMap &that) noexcept
+    {
+        m_ctrl = std::exchange(that.m_ctrl, nullptr);
+        m_slots = std::exchange(that.m_slots, nullptr);
+        m_capacity = std::exchange(that.m_capacity, 0);
+        m_size = std::exchange(that.m_size, 0);
+        m_growth_left = std::exchange(that.m_growth_left, 0);
+    }
+
+    void move_elements_from(HashMap &that)
+    {
+        reserve(that.m_size);
+        for (auto &item : that)
+        {
+            construct_at_new_slot(hash_of(item.first), std::move(mutable_key(item)), std::move(item.second));
+        }
+        that.clear();
+    }
+
+    template <class Key, class... Args>
+    std::pair<size_t, bool> try_emplace_index(Key &&key, Args &&...args)
+    {
+        size_t hash = hash_of(key);
+        size_t idx = find_index(key, hash);
+        if (idx != m_capacity)
+            return {idx, false};
+        idx = construct_at_new_slot(hash, std::piecewise_construct, std::forward_as_tuple(std::forward<Key>(key)),
+                                    std::forward_as_tuple(std::forward<Args>(args)...));
+        return {idx, true};
+    }
+
+    // calls f(i, index of keys[i]) in order, a batch of hashes and prefetches ahead
+    template <class F>
+    void lookup_many(std::span<K const> keys, F f) const
+    {
+        size_t hashes[lookup_batch];
+        for (size_t first = 0; first < keys.size(); first += lookup_batch)
+        {
+            size_t n = std::min(lookup_batch, keys.size() - first);
+            for (size_t i = 0; i < n; i++)
+            {
+                hashes[i] = hash_of(keys[first + i]);
+                if (m_capacity)
+                {
+                    size_t offset = h1(hashes[i]) & (m_capacity - 1);
+                    prefetch_read(m_ctrl + offset);
+                    prefetch_read(m_slots + offset);
+                }
+            }
+            for (size_t i = 0; i < n; i++)
+            {
+                f(first + i, find_index(keys[first + i], hashes[i]));
+            }
+        }
+    }
+
+public:
+    template <bool Const>
+    struct basic_iterator
+    {
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = HashMap::value_type;
+        using difference_type = ptrdiff_t;
+        using pointer = std::conditional_t<Const, value_type const *, value_type *>;
+        using reference = std::conditional_t<Const, value_type const &, value_type &>;
+
+    private:
+        int8_t const *m_ctrl;
+        int8_t const *m_end;
+        value_type *m_slot;
+
+        friend HashMap;
+
+        basic_iterator(int8_t const *ctrl, int8_t const *end, value_type *slot) noexcept
+            : m_ctrl(ctrl), m_end(end), m_slot(slot)
+        {
+        }
+
+        void skip_free() noexcept
+        {
+            while (m_ctrl != m_end && !is_full(*m_ctrl))
+            {
+                ++m_ctrl;
+                ++m_slot;
+            }
+        }
+
+    public:
+        basic_iterator() = default;
+
+        template <bool WasConst>
+            requires(Const && !WasConst)
+        basic_iterator(basic_iterator<WasConst> that) noexcept : m_ctrl(that.m_ctrl), m_end(that.m_end), m_slot(that.m_slot)
+        {
+        }
+
+        basic_iterator &operator++() noexcept
+        {
+            ++m_ctrl;
+            ++m_slot;
+            skip_free();
+            return *this;
+        }
+
+        basic_iterator operator++(int) noexcept
+        {
+            auto ret = *this;
+            ++*this;
+            return ret;
+        }
+
+        reference operator*() const noexcept
+        {
+            return *m_slot;
+        }
+
+        pointer operator->() const noexcept
+        {
+            return m_slot;
+        }
+
+        bool operator==(basic_iterator const &that) const noexcept
+        {
+            return m_ctrl == that.m_ctrl;
+        }
+
+        bool operator!=(basic_iterator const &that) const noexcept
+        {
+            return !(*this == that);
+        }
+
+        template <bool>
+        friend struct basic_iterator;
+    };
+
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+private:
+    iterator iterator_at(size_t idx) const noexcept
+    {
+        return iterator{m_ctrl + idx, m_ctrl + m_capacity, m_slots + idx};
+    }
+
+public:
+    HashMap() : HashMap(0)
+    {
+    }
+
+    explicit HashMap(size_t bucket_count, Hash const &hash = Hash(), Eq const &eq = Eq(), Alloc const &alloc = Alloc())
+        : m_ctrl(nullptr), m_slots(nullptr), m_capacity(0), m_size(0), m_growth_left(0), m_hash(hash), m_eq(eq),
+          m_alloc(alloc)
+    {
+        if (bucket_count)
+        {
+            allocate_table(capacity_for(bucket_count));
+        }
+    }
+
+    explicit HashMap(Alloc const &alloc) : HashMap(0, Hash(), Eq(), alloc)
+    {
+    }
+
+    template <std::input_iterator InputIt>
+    HashMap(InputIt first, InputIt last, size_t bucket_count = 0, Hash const &hash = Hash(), Eq const &eq = Eq(),
+            Alloc const &alloc = Alloc())
+        : HashMap(bucket_count, hash, eq, alloc)
+    {
+        insert(first, last);
+    }
+
+    HashMap(std::initializer_list<value_type> ilist, size_t bucket_count = 0, Hash const &hash = Hash(),
+            Eq const &eq = Eq(), Alloc const &alloc = Alloc())
+        : HashMap(ilist.begin(), ilist.end(), bucket_count, hash, eq, alloc)
+    {
+    }
+
+    HashMap(HashMap const &that)
+        : HashMap(0, that.m_hash, that.m_eq, AllocTraits::select_on_container_copy_construction(that.m_alloc))
+    {
+        copy_from(that);
+    }
+
+    HashMap(HashMap const &that, Alloc const &alloc) : HashMap(0, that.m_hash, that.m_eq, alloc)
+    {
+        copy_from(that);
+    }
+
+    HashMap(HashMap &&that) noexcept : HashMap(0, that.m_hash, that.m_eq, std::move(that.m_alloc))
+    {
+        steal(that);
+    }
+
+    HashMap(HashMap &&that, Alloc const &alloc) : HashMap(0, that.m_hash, that.m_eq, alloc)
+    {
+        if (m_alloc == that.m_alloc)
+        {
+            steal(that);
+        }
+        else
+        {
+            move_elements_from(that);
+        }
+    }
+
+    HashMap &operator=(HashMap const &that)
+    {
+        if (this == &that)
+            return *this;
+        destroy_all();
+        deallocate_table();
+        m_size = 0;
+        if constexpr (AllocTraits::propagate_on_container_copy_assignment::value)
+        {
+            m_alloc = that.m_alloc;
+        }
+        m_hash = that.m_hash;
+        m_eq = that.m_eq;
+        copy_from(that);
+        return *this;
+    }
+
+    HashMap &operator=(HashMap &&that) noexcept(AllocTraits::propagate_on_container_move_assignment::value ||
+                                                 AllocTraits::is_always_equal::value)
+    {
+        if (this == &that)
+            return *this;
+        destroy_all();
+        deallocate_table();
+        m_size = 0;
+        m_hash = that.m_hash;
+        m_eq = that.m_eq;
+        if constexpr (AllocTraits::propagate_on_container_move_assignment::value)
+        {
+            m_alloc = std::move(that.m_alloc);
+            steal(that);
+        }
+        else if (m_alloc == that.m_alloc)
+        {
+            steal(that);
+        }
+        else
+        {
+            move_elements_from(that);
+        }
+        return *this;
+    }
+
+    ~HashMap()
+    {
+        destroy_all();
+        deallocate_table();
+    }
+
+    void swap(HashMap &that) noexcept
+    {
+        if constexpr (AllocTraits::propagate_on_container_swap::value)
+        {
+            std::swap(m_alloc, that.m_alloc);
+        }
+        std::swap(m_ctrl, that.m_ctrl);
+        std::swap(m_slots, that.m_slots);
+        std::swap(m_capacity, that.m_capacity);
+        std::swap(m_size, that.m_size);
+        std::swap(m_growth_left, that.m_growth_left);
+        std::swap(m_hash, that.m_hash);
+        std::swap(m_eq, that.m_eq);
+    }
+
+    Alloc get_allocator() const noexcept
+    {
+        return m_alloc;
+    }
+
+    hasher hash_function() const
+    {
+        return m_hash;
+    }
+
+    key_equal key_eq() const
+    {
+        return m_eq;
+    }
+
+    [[nodiscard]] size_t size() const noexcept
+    {
+        return m_size;
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return m_size == 0;
+    }
+
+    [[nodiscard]] size_t capacity() const noexcept
+    {
+        return m_capacity;
+    }
+
+    // inserts left before the table rehashes; tombstones keep using it up
+    [[nodiscard]] size_t growth_left() const noexcept
+    {
+        return m_growth_left;
+    }
+
+    [[nodiscard]] float load_factor() const noexcept
+    {
+        return m_capacity ? float(m_size) / float(m_capacity) : 0.0f;
+    }
+
+    [[nodiscard]] static constexpr float max_load_factor() noexcept
+    {
+        return 0.875f;
+    }
+
+    // keeps the table, so refilling it to the same size allocates nothing
+    void clear() noexcept
+    {
+        destroy_all();
+        m_size = 0;
+        if (m_capacity)
+        {
+            std::memset(m_ctrl, static_cast<int8_t>(Ctrl::Empty), m_capacity + group_width);
+            m_growth_left = max_load(m_capacity);
+        }
+    }
+
+    // makes room for n elements in total without another rehash
+    void reserve(size_t n)
+    {
+        if (n > m_size + m_growth_left || m_capacity == 0)
+        {
+            size_t capacity = capacity_for(n);
+            if (capacity > m_capacity || m_capacity == 0)
+            {
+                resize(capacity);
+            }
+            else
+            {
+                drop_deletes_without_resize();
+            }
+        }
+    }
+
+    void rehash(size_t n)
+    {
+        size_t capacity = capacity_for(std::max(n, m_size));
+        if (capacity != m_capacity)
+        {
+            resize(capacity);
+        }
+    }
+
+    iterator begin() noexcept
+    {
+        iterator it = iterator_at(0);
+        it.skip_free();
+        return it;
+    }
+
+    iterator end() noexcept
+    {
+        return iterator_at(m_capacity);
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return const_cast<HashMap *>(this)->begin();
+    }
+
+    const_iterator end() const noexcept
+    {
+        return const_cast<HashMap *>(this)->end();
+    }
+
+    const_iterator cbegin() const noexcept
+    {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept
+    {
+        return end();
+    }
+
+    iterator find(K const &key)
+    {
+        return iterator_at(find_index(key, hash_of(key)));
+    }
+
+    template <class Key>
+        requires TransparentHashEq<Hash, Eq>
+    iterator find(Key const &key)
+    {
+        return iterator_at(find_index(key, hash_of(key)));
+    }
+
+    const_iterator find(K const &key) const
+    {
+        return iterator_at(find_index(key, hash_of(key)));
+    }
+
+    template <class Key>
+        requires TransparentHashEq<Hash, Eq>
+    const_iterator find(Key const &key) const
+    {
+        return iterator_at(find_index(key, hash_of(key)));
+    }
+
+    [[nodiscard]] bool contains(K const &key) const
+    {
+        return find_index(key, hash_of(key)) != m_capacity;
+    }
+
+    template <class Key>
+        requires TransparentHashEq<Hash, Eq>
+    [[nodiscard]] bool contains(Key const &key) const
+    {
+        return find_index(key, hash_of(key)) != m_capacity;
+    }
+
+    [[nodiscard]] size_t count(K const &key) const
+    {
+        return contains(key) ? 1 : 0;
+    }
+
+    template <class Key>
+        requires TransparentHashEq<Hash, Eq>
+    [[nodiscard]] size_t count(Key const &key) const
+    {
+        return contains(key) ? 1 : 0;
+    }
+
+    V &at(K const &key)
+    {
+        size_t idx = find_index(key, hash_of(key));
+        if (idx == m_capacity)
+            throw std::out_of_range("HashMap::at");
+        return m_slots[idx].second;
+    }
+
+    V const &at(K const &key) const
+    {
+        return const_cast<HashMap *>(this)->at(key);
+    }
+
+    // the index has to be known before m_slots is read, since inserting may reallocate it
+    V &operator[](K const &key)
+    {
+        size_t idx = try_emplace_index(key).first;
+        return m_slots[idx].second;
+    }
+
+    V &operator[](K &&key)
+    {
+        size_t idx = try_emplace_index(std::move(key)).first;
+        return m_slots[idx].second;
+    }
+
+    template <class... Args>
+    std::pair<iterator, bool> try_emplace(K const &key, Args &&...args)
+    {
+        auto [idx, inserted] = try_emplace_index(key, std::forward<Args>(args)...);
+        return {iterator_at(idx), inserted};
+    }
+
+    template <class... Args>
+    std::pair<iterator, bool> try_emplace(K &&key, Args &&...args)
+    {
+        auto [idx, inserted] = try_emplace_index(std::move(key), std::forward<Args>(args)...);
+        return {iterator_at(idx), inserted};
+    }
+
+    // The key is only known once the pair exists, so it is built on the stack and moved into place.
+    template <class... Args>
+    std::pair<iterator, bool> emplace(Args &&...args)
+    {
+        value_type val(std::forward<Args>(args)...);
+        return try_emplace(std::move(mutable_key(val)), std::move(val.second));
+    }
+
+    std::pair<iterator, bool> insert(value_type const &val)
+    {
+        return try_emplace(val.first, val.second);
+    }
+
+    std::pair<iterator, bool> insert(value_type &&val)
+    {
+        return try_emplace(std::move(mutable_key(val)), std::move(val.second));
+    }
+
+    template <std::input_iterator InputIt>
+    void insert(InputIt first, InputIt last)
+    {
+        if constexpr (std::forward_iterator<InputIt>)
+        {
+            reserve(m_size + std::distance(first, last));
+        }
+        for (; first != last; ++first)
+        {
+            insert(*first);
+        }
+    }
+
+    void insert(std::initializer_list<value_type> ilist)
+    {
+        insert(ilist.begin(), ilist.end());
+    }
+
+    template <class M>
+    std::pair<iterator, bool> insert_or_assign(K const &key, M &&obj)
+    {
+        auto [idx, inserted] = try_emplace_index(key, std::forward<M>(obj));
+        if (!inserted)
+        {
+            m_slots[idx].second = std::forward<M>(obj);
+        }
+        return {iterator_at(idx), inserted};
+    }
+
+    template <class M>
+    std::pair<iterator, bool> insert_or_assign(K &&key, M &&obj)
+    {
+        auto [idx, inserted] = try_emplace_index(std::move(key), std::forward<M>(obj));
+        if (!inserted)
+        {
+            m_slots[idx].second = std::forward<M>(obj);
+        }
+        return {iterator_at(idx), inserted};
+    }
+
+    size_t erase(K const &key)
+    {
+        size_t idx = find_index(key, hash_of(key));
+        if (idx == m_capacity)
+            return 0;
+        erase_at(idx);
+        return 1;
+    }
+
+    template <class Key>
+        requires(TransparentHashEq<Hash, Eq> && !std::is_convertible_v<Key const &, const_iterator>)
+    size_t erase(Key const &key)
+    {
+        size_t idx = find_index(key, hash_of(key));
+        if (idx == m_capacity)
+            return 0;
+        erase_at(idx);
+        return 1;
+    }
+
+    // erasing never moves other elements, so the iterator just steps past the freed slot
+    iterator erase(const_iterator pos) noexcept
+    {
+        size_t idx = pos.m_slot - m_slots;
+        erase_at(idx);
+        iterator it = iterator_at(idx);
+        it.skip_free();
+        return it;
+    }
+
+    iterator erase(iterator pos) noexcept
+    {
+        return erase(const_iterator(pos));
+    }
+
+    // Looks up every key of keys, storing a pointer to its value in out, or null if it is absent.
+    // Keys are hashed a batch at a time and the first control group and slot of each are prefetched
+    // before any of them is probed, so the cache misses of a batch overlap.
+    void find_many(std::span<K const> keys, std::span<V *> out)
+    {
+        if (out.size() < keys.size())
+            throw std::invalid_argument("HashMap::find_many: out is shorter than keys");
+        lookup_many(keys, [&](size_t i, size_t idx) { out[i] = idx == m_capacity ? nullptr : &m_slots[idx].second; });
+    }
+
+    void find_many(std::span<K const> keys, std::span<V const *> out) const
+    {
+        if (out.size() < keys.size())
+            throw std::invalid_argument("HashMap::find_many: out is shorter than keys");
+        lookup_many(keys, [&](size_t i, size_t idx) { out[i] = idx == m_capacity ? nullptr : &m_slots[idx].second; });
+    }
+
+    // Writes whether each of keys is present to out, in order, and returns how many are. out may be
+    // any output iterator, std::vector<bool>::iterator or std::back_inserter included.
+    template <std::output_iterator<bool> OutputIt>
+    size_t contains_many(std::span<K const> keys, OutputIt out) const
+    {
+        size_t found = 0;
+        lookup_many(keys, [&](size_t, size_t idx) {
+            bool present = idx != m_capacity;
+            *out = present;
+            ++out;
+            found += present;
+        });
+        return found;
+    }
+
+    // Lookup for seqlock readers such as ConcurrentHashMap's, for trivially copyable K and V: runs
+    // while a writer may be changing the map. The table pointers are read first, then stable() must
+    // confirm that no write has begun since the caller read its version counter; from there every
+    // read stays inside that table, which the caller keeps allocated, and each group is probed at
+    // most once. found(V const &) gets the value of a match. Both the answer and the value count
+    // only if the caller's version is still unchanged afterwards.
+    template <class Key, class Stable, class F>
+    bool find_racy(Key const &key, Stable stable, F found) const
+    {
+        static_assert(std::is_trivially_copyable_v<K> && std::is_trivially_copyable_v<V>);
+        size_t hash = hash_of(key);
+        int8_t const *ctrl = std::atomic_ref(const_cast<int8_t *&>(m_ctrl)).load(std::memory_order_relaxed);
+        value_type const *slots =
+            std::atomic_ref(const_cast<value_type *&>(m_slots)).load(std::memory_order_relaxed);
+        size_t capacity = std::atomic_ref(const_cast<size_t &>(m_capacity)).load(std::memory_order_relaxed);
+        if (!stable() || capacity == 0)
+            return false;
+        size_t mask = capacity - 1;
+        size_t offset = h1(hash) & mask;
+        size_t step = group_width;
+        for (size_t groups = capacity / group_width; groups; --groups, step += group_width)
+        {
+            CtrlGroup group(ctrl + offset);
+            for (unsigned i : group.match(h2(hash)))
+            {
+                size_t idx = (offset + i) & mask;
+                K candidate = slots[idx].first;
+                if (m_eq(candidate, key))
+                {
+                    found(slots[idx].second);
+                    return true;
+                }
+            }
+            if (group.match_empty())
+                return false;
+            offset = (offset + step) & mask;
+        }
+        return false;
+    }
+
+    bool operator==(HashMap const &that) const
+    {
+        if (m_size != that.m_size)
+            return false;
+        for (auto const &item : *this)
+        {
+            auto it = that.find(item.first);
+            if (it == that.end() || !(it->second == item.second))
+                return false;
+        }
+        return true;
+    }
+};
+
+// Open-addressing map with Robin Hood linear probing. Each slot records its element's probe length
+// (distance from the home slot, plus one; zero marks a free slot), and an insertion takes the slot
+// of any element that sits closer to its own home, so within a run elements stay ordered by home
+// slot. A lookup can therefore stop as soon as it meets an element closer to home than it has
+// walked, and misses cost about as much as hits. erase() shifts the rest of the run back one slot
+// instead of leaving a tombstone, so heavy deletes never degrade probing and the table can run at
+// a 7/8 load factor.
+//
+// Home slots come from Fibonacci hashing of the user hash, which spreads even identity hashes over
+// the power-of-two table. Probe lengths are kept under 255; a run that would grow longer forces the
+// table to double, unless it is under 1/8 full, in which case the hash is degenerate (hundreds of
+// keys hashing alike) and the insert throws std::length_error instead. Insertions and erasures
+// move elements and invalidate iterators and references.
+template <class K, class V, class Hash = FastHash<K>, class Eq = std::equal_to<K>,
+          class Alloc = std::allocator<std::pair<K const, V>>>
+struct RobinHoodMap
+{
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = std::pair<K const, V>;
+    using hasher = Hash;
+    using key_equal = Eq;
+    using allocator_type = Alloc;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using pointer = value_type *;
+    using const_pointer = value_type const *;
+    using reference = value_type &;
+    using const_reference = value_type const &;
+
+private:
+    using AllocTraits = std::allocator_traits<Alloc>;
+    using AllocDist = AllocTraits::template rebind_alloc<uint8_t>;
+    using AllocDistTraits = std::allocator_traits<AllocDist>;
+
+    static constexpr size_t min_capacity = 8;
+    static constexpr uint8_t max_dist = 255;
+
+    uint8_t *m_dist;
+    value_type *m_slots;
+    size_t m_capacity;
+    size_t m_size;
+    unsigned m_shift;
+    [[no_unique_address]] Hash m_hash;
+    [[no_unique_address]] Eq m_eq;
+    [[no_unique_address]] Alloc m_alloc;
+
+    // 7/8 of the slots, which always leaves at least one free since capacity >= min_capacity
+    static size_t max_load(size_t capacity) noexcept
+    {
+        return capacity / 8 * 7;
+    }
+
+    static size_t capacity_for(size_t n) noexcept
+    {
+        size_t capacity = min_capacity;
+        while (max_load(capacity) < n)
+        {
+            capacity *= 2;
+        }
+        return capacity;
+    }
+
+    static K &mutable_key(value_type &val) noexcept
+    {
+        return const_cast<K &>(val.first);
+    }
+
+    size_t home_of(size_t hash) const noexcept
+    {
+        return static_cast<size_t>((static_cast<uint64_t>(hash) * 0x9e3779b97f4a7c15ull) >> m_shift);
+    }
+
+    template <class Key>
+    size_t find_index(Key const &key) const
+    {
+        if (m_size == 0)
+            return m_capacity;
+        return find_index(key, m_hash(key));
+    }
+
+    template <class Key>
+    size_t find_index(Key const &key, size_t hash) const
+    {
+        if (m_size == 0)
+            return m_capacity;
+        size_t mask = m_capacity - 1;
+        size_t idx = home_of(hash);
+        for (unsigned dist = 1; m_dist[idx] >= dist; dist++)
+        {
+            if (m_dist[idx] == dist && m_eq(m_slots[idx].first, key))
+                return idx;
+            idx = (idx + 1) & mask;
+        }
+        return m_capacity;
+    }
+
+    void allocate_table(size_t capacity)
+    {
+        AllocDist dist_alloc{m_alloc};
+        uint8_t *dist = AllocDistTraits::allocate(dist_alloc, capacity);
+        try
+        {
+            m_slots = AllocTraits::allocate(m_alloc, capacity);
+        }
+        catch (...)
+        {
+            AllocDistTraits::deallocate(dist_alloc, dist, capacity);
+            throw;
+        }
+        m_dist = dist;
+        std::memset(m_dist, 0, capacity);
+        m_capacity = capacity;
+        m_shift = 64 - std::countr_zero(capacity);
+    }
+
+    void deallocate_table() noexcept
+    {
+        if (m_capacity == 0)
+            return;
+        AllocDist dist_alloc{m_alloc};
+        AllocDistTraits::deallocate(dist_alloc, m_dist, m_capacity);
+        AllocTraits::deallocate(m_alloc, m_slots, m_capacity);
+        m_dist = nullptr;
+        m_slots = nullptr;
+        m_capacity = 0;
+    }
+
+    void destroy_all() noexcept
+    {
+        for (size_t i = 0; i < m_capacity; i++)
+        {
+            if (m_dist[i])
+            {
+                AllocTraits::destroy(m_alloc, &m_slots[i]);
+            }
+        }
+    }
+
+    void move_slot(size_t from, size_t to)
+    {
+        AllocTraits::construct(m_alloc, &m_slots[to], std::move(mutable_key(m_slots[from])),
+                               std::move(m_slots[from].second));
+        AllocTraits::destroy(m_alloc, &m_slots[from]);
+    }
+
+    // Finds where a key that is not in the table belongs and opens that slot: the rest of the run
+    // up to the next free slot moves one step further from home. Returns m_capacity, changing
+    // nothing, if some probe length would pass max_dist. With move_slots false only the probe
+    // lengths shift, which lets resize() lay out a table before it moves anything into it.
+    size_t open_slot(size_t hash, bool move_slots = true)
+    {
+        size_t mask = m_capacity - 1;
+        size_t idx = home_of(hash);
+        unsigned dist = 1;
+        while (m_dist[idx] >= dist)
+        {
+            idx = (idx + 1) & mask;
+            ++dist;
+        }
+        if (dist > max_dist)
+            return m_capacity;
+        size_t free = idx;
+        while (m_dist[free] != 0)
+        {
+            if (m_dist[free] == max_dist)
+                return m_capacity;
+            free = (free + 1) & mask;
+        }
+        for (size_t j = free; j != idx; j = (j - 1) & mask)
+        {
+            size_t prev = (j - 1) & mask;
+            if (move_slots)
+                move_slot(prev, j);
+            m_dist[j] = m_dist[prev] + 1;
+        }
+        m_dist[idx] = static_cast<uint8_t>(dist);
+        return idx;
+    }
+
+    // Moves every element to a table of new_capacity, or returns false and changes nothing if some
+    // run would pass max_dist there. Growing never lengthens a run, since each home slot splits in
+    // two or more and no stretch of slots gains keys faster than it gains length; a shrink can, so
+    // it is first laid out on the probe lengths alone.
+    bool resize(size_t new_capacity)
+    {
+        uint8_t *old_dist = m_dist;
+        value_type *old_slots = m_slots;
+        size_t old_capacity = m_capacity;
+        allocate_table(new_capacity);
+        if (new_capacity < old_capacity)
+        {
+            for (size_t i = 0; i < old_capacity; i++)
+            {
+                if (old_dist[i] && open_slot(m_hash(old_slots[i].first), false) == m_capacity)
+                {
+                    deallocate_table();
+                    m_dist = old_dist;
+                    m_slots = old_slots;
+                    m_capacity = old_capacity;
+                    m_shift = 64 - std::countr_zero(old_capacity);
+                    return false;
+                }
+            }
+            // the same inserts in the same order land exactly where the dry run put them
+            std::memset(m_dist, 0, m_capacity);
+        }
+        for (size_t i = 0; i < old_capacity; i++)
+        {
+            if (!old_dist[i])
+                continue;
+            size_t idx = open_slot(m_hash(old_slots[i].first));
+            AllocTraits::construct(m_alloc, &m_slots[idx], std::move(mutable_key(old_slots[i])),
+                                   std::move(old_slots[i].second));
+            AllocTraits::destroy(m_alloc, &old_slots[i]);
+        }
+        if (old_capacity)
+        {
+            AllocDist dist_alloc{m_alloc};
+            AllocDistTraits::deallocate(dist_alloc, old_dist, old_capacity);
+            AllocTraits::deallocate(m_alloc, old_slots, old_capacity);
+        }
+        return true;
+    }
+
+    [[noreturn]] static void throw_degenerate_hash()
+    {
+        throw std::length_error("RobinHoodMap: more than 255 keys crowd the same home slots, "
+                                "the hash function is degenerate");
+    }
+
+    // Opens the slot a new element with this hash goes to, growing the table first if needed. A run
+    // too long for max_dist doubles the table, but only while it is at least 1/8 full: past that,
+    // the keys share so few home slots that doubling again would not help.
+    size_t prepare_insert(size_t hash)
+    {
+        if (m_size + 1 > max_load(m_capacity) || m_capacity == 0)
+        {
+            resize(m_capacity ? m_capacity * 2 : min_capacity);
+        }
+        size_t idx = open_slot(hash);
+        while (idx == m_capacity)
+        {
+            if (m_size < m_capacity / 8)
+                throw_degenerate_hash();
+            resize(m_capacity * 2);
+            idx = open_slot(hash);
+        }
+        return idx;
+    }
+
+    template <class... Args>
+    size_t construct_at_new_slot(size_t hash, Args &&...args)
+    {
+        size_t idx = prepare_insert(hash);
+        try
+        {
+            AllocTraits::construct(m_alloc, &m_slots[idx], std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            m_dist[idx] = 0;
+            shift_back(idx);
+            throw;
+        }
+        ++m_size;
+        return idx;
+    }
+
+    // pulls the elements after a freed slot one step closer to home, up to the end of the run
+    void shift_back(size_t idx) noexcept
+    {
+        size_t mask = m_capacity - 1;
+        size_t next = (idx + 1) & mask;
+        while (m_dist[next] > 1)
+        {
+            move_slot(next, idx);
+            m_dist[idx] = m_dist[next] - 1;
+            idx = next;
+            next = (next + 1) & mask;
+        }
+        m_dist[idx] = 0;
+    }
+
+    void erase_at(size_t idx) noexcept
+    {
+        AllocTraits::destroy(m_alloc, &m_slots[idx]);
+        --m_size;
+        shift_back(idx);
+    }
+
+    void copy_from(RobinHoodMap const &that)
+    {
+        if (that.m_size == 0)
+            return;
+        allocate_table(capacity_for(that.m_size));
+        for (auto const &item : that)
+        {
+            construct_at_new_slot(m_hash(item.first), item);
+        }
+    }
+
+    void steal(RobinHoodMap &that) noexcept
+    {
+        m_dist = std::exchange(that.m_dist, nullptr);
+        m_slots = std::exchange(that.m_slots, nullptr);
+        m_capacity = std::exchange(that.m_capacity, 0);
+        m_size = std::exchange(that.m_size, 0);
+        m_shift = that.m_shift;
+    }
+
+    void move_elements_from(RobinHoodMap &that)
+    {
+        reserve(that.m_size);
+        for (auto &item : that)
+        {
+            construct_at_new_slot(m_hash(item.first), std::move(mutable_key(item)), std::move(item.second));
+        }
+        that.clear();
+    }
+
+    template <class Key, class... Args>
+    std::pair<size_t, bool> try_emplace_index(Key &&key, Args &&...args)
+    {
+        size_t idx = find_index(key);
+        if (idx != m_capacity)
+            return {idx, false};
+        idx = construct_at_new_slot(m_hash(key), std::piecewise_construct,
+                                    std::forward_as_tuple(std::forward<Key>(key)),
+                                    std::forward_as_tuple(std::forward<Args>(args)...));
+        return {idx, true};
+    }
+
+    // calls f(i, index of keys[i]) in order, a batch of hashes and prefetches ahead
+    template <class F>
+    void lookup_many(std::span<K const> keys, F f) const
+    {
+        size_t hashes[lookup_batch];
+        for (size_t first = 0; first < keys.size(); first += lookup_batch)
+        {
+            size_t n = std::min(lookup_batch, keys.size() - first);
+            for (size_t i = 0; i < n; i++)
+            {
+                hashes[i] = m_hash(keys[first + i]);
+                if (m_size)
+                {
+                    size_t home = home_of(hashes[i]);
+                    prefetch_read(m_dist + home);
+                    prefetch_read(m_slots + home);
+                }
+            }
+            for (size_t i = 0; i < n; i++)
+            {
+                f(first + i, find_index(keys[first + i], hashes[i]));
+            }
+        }
+    }
+
+public:
+    template <bool Const>
+    struct basic_iterator
+    {
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = RobinHoodMap::value_type;
+        using difference_type = ptrdiff_t;
+        using pointer = std::conditional_t<Const, value_type const *, value_type *>;
+        using reference = std::conditional_t<Const, value_type const &, value_type &>;
+
+    private:
+        uint8_t const *m_dist;
+        uint8_t const *m_end;
+        value_type *m_slot;
+
+        friend RobinHoodMap;
+
+        basic_iterator(uint8_t const *dist, uint8_t const *end, value_type *slot) noexcept
+            : m_dist(dist), m_end(end), m_slot(slot)
+        {
+        }
+
+        void skip_free() noexcept
+        {
+            while (m_dist != m_end && *m_dist == 0)
+            {
+                ++m_dist;
+                ++m_slot;
+            }
+        }
+
+    public:
+        basic_iterator() = default;
+
+        template <bool WasConst>
+            requires(Const && !WasConst)
+        basic_iterator(basic_iterator<WasConst> that) noexcept : m_dist(that.m_dist), m_end(that.m_end), m_slot(that.m_slot)
+        {
+        }
+
+        basic_iterator &operator++() noexcept
+        {
+            ++m_dist;
+            ++m_slot;
+            skip_free();
+            return *this;
+        }
+
+        basic_iterator operator++(int) noexcept
+        {
+            auto ret = *this;
+            ++*this;
+            return ret;
+        }
+
+        reference operator*() const noexcept
+        {
+            return *m_slot;
+        }
+
+        pointer operator->() const noexcept
+        {
+            return m_slot;
+        }
+
+        bool operator==(basic_iterator const &that) const noexcept
+        {
+            return m_dist == that.m_dist;
+        }
+
+        bool operator!=(basic_iterator const &that) const noexcept
+        {
+            return !(*this == that);
+        }
+
+        template <bool>
+        friend struct basic_iterator;
+    };
+
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+private:
+    iterator iterator_at(size_t idx) const noexcept
+    {
+        return iterator{m_dist + idx, m_dist + m_capacity, m_slots + idx};
+    }
+
+public:
+    RobinHoodMap() : RobinHoodMap(0)
+    {
+    }
+
+    explicit RobinHoodMap(size_t bucket_count, Hash const &hash = Hash(), Eq const &eq = Eq(),
+                          Alloc const &alloc = Alloc())
+        : m_dist(nullptr), m_slots(nullptr), m_capacity(0), m_size(0), m_shift(64), m_hash(hash), m_eq(eq),
+          m_alloc(alloc)
+    {
+        if (bucket_count)
+        {
+            allocate_table(capacity_for(bucket_count));
+        }
+    }
+
+    explicit RobinHoodMap(Alloc const &alloc) : RobinHoodMap(0, Hash(), Eq(), alloc)
+    {
+    }
+
+    template <std::input_iterator InputIt>
+    RobinHoodMap(InputIt first, InputIt last, size_t bucket_count = 0, Hash const &hash = Hash(), Eq const &eq = Eq(),
+                 Alloc const &alloc = Alloc())
+        : RobinHoodMap(bucket_count, hash, eq, alloc)
+    {
+        insert(first, last);
+    }
+
+    RobinHoodMap(std::initializer_list<value_type> ilist, size_t bucket_count = 0, Hash const &hash = Hash(),
+                 Eq const &eq = Eq(), Alloc const &alloc = Alloc())
+        : RobinHoodMap(ilist.begin(), ilist.end(), bucket_count, hash, eq, alloc)
+    {
+    }
+
+    RobinHoodMap(RobinHoodMap const &that)
+        : RobinHoodMap(0, that.m_hash, that.m_eq, AllocTraits::select_on_container_copy_construction(that.m_alloc))
+    {
+        copy_from(that);
+    }
+
+    RobinHoodMap(RobinHoodMap const &that, Alloc const &alloc) : RobinHoodMap(0, that.m_hash, that.m_eq, alloc)
+    {
+        copy_from(that);
+    }
+
+    RobinHoodMap(RobinHoodMap &&that) noexcept : RobinHoodMap(0, that.m_hash, that.m_eq, std::move(that.m_alloc))
+    {
+        steal(that);
+    }
+
+    RobinHoodMap(RobinHoodMap &&that, Alloc const &alloc) : RobinHoodMap(0, that.m_hash, that.m_eq, alloc)
+    {
+        if (m_alloc == that.m_alloc)
+        {
+            steal(that);
+        }
+        else
+        {
+            move_elements_from(that);
+        }
+    }
+
+    RobinHoodMap &operator=(RobinHoodMap const &that)
+    {
+        if (this == &that)
+            return *this;
+        destroy_all();
+        deallocate_table();
+        m_size = 0;
+        if constexpr (AllocTraits::propagate_on_container_copy_assignment::value)
+        {
+            m_alloc = that.m_alloc;
+        }
+        m_hash = that.m_hash;
+        m_eq = that.m_eq;
+        copy_from(that);
+        return *this;
+    }
+
+    RobinHoodMap &operator=(RobinHoodMap &&that) noexcept(AllocTraits::propagate_on_container_move_assignment::value ||
+                                                           AllocTraits::is_always_equal::value)
+    {
+        if (this == &that)
+            return *this;
+        destroy_all();
+        deallocate_table();
+        m_size = 0;
+        m_hash = that.m_hash;
+        m_eq = that.m_eq;
+        if constexpr (AllocTraits::propagate_on_container_move_assignment::value)
+        {
+            m_alloc = std::move(that.m_alloc);
+            steal(that);
+        }
+        else if (m_alloc == that.m_alloc)
+        {
+            steal(that);
+        }
+        else
+        {
+            move_elements_from(that);
+        }
+        return *this;
+    }
+
+    ~RobinHoodMap()
+    {
+        destroy_all();
+        deallocate_table();
+    }
+
+    void swap(RobinHoodMap &that) noexcept
+    {
+        if constexpr (AllocTraits::propagate_on_container_swap::value)
+        {
+            std::swap(m_alloc, that.m_alloc);
+        }
+        std::swap(m_dist, that.m_dist);
+        std::swap(m_slots, that.m_slots);
+        std::swap(m_capacity, that.m_capacity);
+        std::swap(m_size, that.m_size);
+        std::swap(m_shift, that.m_shift);
+        std::swap(m_hash, that.m_hash);
+        std::swap(m_eq, that.m_eq);
+    }
+
+    Alloc get_allocator() const noexcept
+    {
+        return m_alloc;
+    }
+
+    hasher hash_function() const
+    {
+        return m_hash;
+    }
+
+    key_equal key_eq() const
+    {
+        return m_eq;
+    }
+
+    [[nodiscard]] size_t size() const noexcept
+    {
+        return m_size;
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return m_size == 0;
+    }
+
+    [[nodiscard]] size_t capacity() const noexcept
+    {
+        return m_capacity;
+    }
+
+    [[nodiscard]] float load_factor() const noexcept
+    {
+        return m_capacity ? float(m_size) / float(m_capacity) : 0.0f;
+    }
+
+    [[nodiscard]] static constexpr float max_load_factor() noexcept
+    {
+        return 0.875f;
+    }
+
+    // longest probe any lookup can take right now
+    [[nodiscard]] size_t max_probe_length() const noexcept
+    {
+        uint8_t longest = 0;
+        for (size_t i = 0; i < m_capacity; i++)
+        {
+            longest = std::max(longest, m_dist[i]);
+        }
+        return longest;
+    }
+
+    void clear() noexcept
+    {
+        destroy_all();
+        m_size = 0;
+        if (m_capacity)
+        {
+            std::memset(m_dist, 0, m_capacity);
+        }
+    }
+
+    void reserve(size_t n)
+    {
+        size_t capacity = capacity_for(n);
+        if (capacity > m_capacity)
+        {
+            resize(capacity);
+        }
+    }
+
+    // shrinking can crowd runs past max_dist; it then stops at the smallest size that still fits
+    void rehash(size_t n)
+    {
+        size_t capacity = capacity_for(std::max(n, m_size));
+        while (capacity < m_capacity && !resize(capacity))
+        {
+            capacity *= 2;
+        }
+        if (capacity > m_capacity)
+        {
+            resize(capacity);
+        }
+    }
+
+    iterator begin() noexcept
+    {
+        iterator it = iterator_at(0);
+        it.skip_free();
+        return it;
+    }
+
+    iterator end() noexcept
+    {
+        return iterator_at(m_capacity);
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return const_cast<RobinHoodMap *>(this)->begin();
+    }
+
+    const_iterator end() const noexcept
+    {
+        return const_cast<RobinHoodMap *>(this)->end();
+    }
+
+    const_iterator cbegin() const noexcept
+    {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept
+    {
+        return end();
+    }
+
+    iterator find(K const &key)
+    {
+        return iterator_at(find_index(key));
+    }
+
+    template <class Key>
+        requires TransparentHashEq<Hash, Eq>
+    iterator find(Key const &key)
+    {
+        return iterator_at(find_index(key));
+    }
+
+    const_iterator find(K const &key) const
+    {
+        return iterator_at(find_index(key));
+    }
+
+    template <class Key>
+        requires TransparentHashEq<Hash, Eq>
+    const_iterator find(Key const &key) const
+    {
+        return iterator_at(find_index(key));
+    }
+
+    [[nodiscard]] bool contains(K const &key) const
+    {
+        return find_index(key) != m_capacity;
+    }
+
+    template <class Key>
+        requires TransparentHashEq<Hash, Eq>
+    [[nodiscard]] bool contains(Key const &key) const
+    {
+        return find_index(key) != m_capacity;
+    }
+
+    [[nodiscard]] size_t count(K const &key) const
+    {
+        return contains(key) ? 1 : 0;
+    }
+
+    template <class Key>
+        requires TransparentHashEq<Hash, Eq>
+    [[nodiscard]] size_t count(Key const &key) const
+    {
+        return contains(key) ? 1 : 0;
+    }
+
+    V &at(K const &key)
+    {
+        size_t idx = find_index(key);
+        if (idx == m_capacity)
+            throw std::out_of_range("RobinHoodMap::at");
+        return m_slots[idx].second;
+    }
+
+    V const &at(K const &key) const
+    {
+        return const_cast<RobinHoodMap *>(this)->at(key);
+    }
+
+    V &operator[](K const &key)
+    {
+        size_t idx = try_emplace_index(key).first;
+        return m_slots[idx].second;
+    }
+
+    V &operator[](K &&key)
+    {
+        size_t idx = try_emplace_index(std::move(key)).first;
+        return m_slots[idx].second;
+    }
+
+    template <class... Args>
+    std::pair<iterator, bool> try_emplace(K const &key, Args &&...args)
+    {
+        auto [idx, inserted] = try_emplace_index(key, std::forward<Args>(args)...);
+        return {iterator_at(idx), inserted};
+    }
+
+    template <class... Args>
+    std::pair<iterator, bool> try_emplace(K &&key, Args &&...args)
+    {
+        auto [idx, inserted] = try_emplace_index(std::move(key), std::forward<Args>(args)...);
+        return {iterator_at(idx), inserted};
+    }
+
+    template <class... Args>
+    std::pair<iterator, bool> emplace(Args &&...args)
+    {
+        value_type val(std::forward<Args>(args)...);
+        return try_emplace(std::move(mutable_key(val)), std::move(val.second));
+    }
+
+    std::pair<iterator, bool> insert(value_type const &val)
+    {
+        return try_emplace(val.first, val.second);
+    }
+
+    std::pair<iterator, bool> insert(value_type &&val)
+    {
+        return try_emplace(std::move(mutable_key(val)), std::move(val.second));
+    }
+
+    template <std::input_iterator InputIt>
+    void insert(InputIt first, InputIt last)
+    {
+        if constexpr (std::forward_iterator<InputIt>)
+        {
+            reserve(m_size + std::distance(first, last));
+        }
+        for (; first != last; ++first)
+        {
+            insert(*first);
+        }
+    }
+
+    void insert(std::initializer_list<value_type> ilist)
+    {
+        insert(ilist.begin(), ilist.end());
+    }
+
+    template <class M>
+    std::pair<iterator, bool> insert_or_assign(K const &key, M &&obj)
+    {
+        auto [idx, inserted] = try_emplace_index(key, std::forward<M>(obj));
+        if (!inserted)
+        {
+            m_slots[idx].second = std::forward<M>(obj);
+        }
+        return {iterator_at(idx), inserted};
+    }
+
+    template <class M>
+    std::pair<iterator, bool> insert_or_assign(K &&key, M &&obj)
+    {
+        auto [idx, inserted] = try_emplace_index(std::move(key), std::forward<M>(obj));
+        if (!inserted)
+        {
+            m_slots[idx].second = std::forward<M>(obj);
+        }
+        return {iterator_at(idx), inserted};
+    }
+
+    size_t erase(K const &key)
+    {
+        size_t idx = find_index(key);
+        if (idx == m_capacity)
+            return 0;
+        erase_at(idx);
+        return 1;
+    }
+
+    template <class Key>
+        requires(TransparentHashEq<Hash, Eq> && !std::is_convertible_v<Key const &, const_iterator>)
+    size_t erase(Key const &key)
+    {
+        size_t idx = find_index(key);
+        if (idx == m_capacity)
+            return 0;
+        erase_at(idx);
+        return 1;
+    }
+
+    // The backward shift may pull an element from later in the run into pos, so iteration resumes
+    // at pos itself. A run that wraps past the end can pull an element already visited from slot 0
+    // into the last slot, where it is visited again; erase-by-predicate loops are unaffected.
+    iterator erase(const_iterator pos) noexcept
+    {
+        size_t idx = pos.m_slot - m_slots;
+        erase_at(idx);
+        iterator it = iterator_at(idx);
+        it.skip_free();
+        return it;
+    }
+
+    iterator erase(iterator pos) noexcept
+    {
+        return erase(const_iterator(pos));
+    }
+
+    // Looks up every key of keys, storing a pointer to its value in out, or null if it is absent.
+    // The home slot of each key in a batch is prefetched before any of them is probed.
+    void find_many(std::span<K const> keys, std::span<V *> out)
+    {
+        if (out.size() < keys.size())
+            throw std::invalid_argument("RobinHoodMap::find_many: out is shorter than keys");
+        lookup_many(keys, [&](size_t i, size_t idx) { out[i] = idx == m_capacity ? nullptr : &m_slots[idx].second; });
+    }
+
+    void find_many(std::span<K const> keys, std::span<V const *> out) const
+    {
+        if (out.size() < keys.size())
+            throw std::invalid_argument("RobinHoodMap::find_many: out is shorter than keys");
+        lookup_many(keys, [&](size_t i, size_t idx) { out[i] = idx == m_capacity ? nullptr : &m_slots[idx].second; });
+    }
+
+    // as HashMap::contains_many()
+    template <std::output_iterator<bool> OutputIt>
+    size_t contains_many(std::span<K const> keys, OutputIt out) const
+    {
+        size_t found = 0;
+        lookup_many(keys, [&](size_t, size_t idx) {
+            bool present = idx != m_capacity;
+            *out = present;
+            ++out;
+            found += present;
+        });
+        return found;
+    }
+
+    bool operator==(RobinHoodMap const &that) const
+    {
+        if (m_size != that.m_size)
+            return false;
+        for (auto const &item : *this)
+        {
+            auto it = that.find(item.first);
+            if (it == that.end() || !(it->second == item.second))
+                return false;
+        }
+        return true;
+    }
+};
+
+// HashMap that never rehashes everything at once, in the manner of the Redis dict. When the live
+// table runs out of room, it becomes the old table and a new one takes over: twice the size if it
+// was full, the same size if erase tombstones used up the room. Every later insert, erase or
+// non-const lookup first moves up to step elements from old to new, so the cost of a resize is
+// spread over the next operations instead of landing on one of them. Until the old table runs dry,
+// lookups check both; new elements only ever go to the new table.
+//
+// Starting a migration still allocates the new table and clears its control bytes, one byte per
+// slot; the elements themselves are moved a few at a time. Any non-const operation may move
+// elements, so it invalidates iterators and references.
+template <class K, class V, class Hash = FastHash<K>, class Eq = std::equal_to<K>,
+          class Alloc = std::allocator<std::pair<K const, V>>>
+struct IncrementalHashMap
+{
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = std::pair<K const, V>;
+    using hasher = Hash;
+    using key_equal = Eq;
+    using allocator_type = Alloc;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+
+private:
+    using Map = HashMap<K, V, Hash, Eq, Alloc>;
+
+    Map m_new;
+    Map m_old;
+    typename Map::iterator m_cursor;
+    size_t m_step;
+
+    // moves up to n elements from the old table to the new one and drops the old table when done
+    void migrate(size_t n)
+    {
+        if (m_old.capacity() == 0)
+            return;
+        for (; n && m_cursor != m_old.end(); n--)
+        {
+            auto &item = *m_cursor;
+            m_new.try_emplace(std::move(const_cast<K &>(item.first)), std::move(item.second));
+            m_cursor = m_old.erase(m_cursor);
+        }
+        if (m_cursor == m_old.end())
+        {
+            m_old = Map(0, m_new.hash_function(), m_new.key_eq(), m_new.get_allocator());
+            m_cursor = m_old.end();
+        }
+    }
+
+    // before an insert: hand the full table over to migration instead of letting it rehash
+    void grow_if_full()
+    {
+        if (m_new.capacity() == 0)
+        {
+            m_new.reserve(1);
+            return;
+        }
+        // growth_left() also runs out on tombstones, so this catches every rehash HashMap would do
+        if (m_new.growth_left() > 0)
+            return;
+        if (is_rehashing())
+        {
+            migrate(m_old.size());
+        }
+        // room for everything the new table can receive before the old one drains; never shrink, so
+        // a table clogged with tombstones is migrated into a fresh one of the same size
+        size_t cap = m_new.capacity();
+        size_t need = m_new.size() + m_new.size() / m_step + 1;
+        m_old = std::move(m_new);
+        m_new = Map(std::max(need, cap - cap / 8), m_old.hash_function(), m_old.key_eq(), m_old.get_allocator());
+        m_cursor = m_old.begin();
+    }
+
+    void erase_old(typename Map::iterator it)
+    {
+        if (it == m_cursor)
+        {
+            m_cursor = m_old.erase(it);
+        }
+        else
+        {
+            m_old.erase(it);
+        }
+    }
+
+public:
+    template <bool Const>
+    struct basic_iterator
+    {
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = IncrementalHashMap::value_type;
+        using difference_type = ptrdiff_t;
+        using pointer = std::conditional_t<Const, value_type const *, value_type *>;
+        using reference = std::conditional_t<Const, value_type const &, value_type &>;
+
+    private:
+        using Owner = std::conditional_t<Const, IncrementalHashMap const, IncrementalHashMap>;
+        using MapIterator = std::conditional_t<Const, typename Map::const_iterator, typename Map::iterator>;
+
+        Owner *m_owner;
+        MapIterator m_it;
+        bool m_in_old;
+
+        friend IncrementalHashMap;
+
+        basic_iterator(Owner *owner, MapIterator it, bool in_old) noexcept : m_owner(owner), m_it(it), m_in_old(in_old)
+        {
+            move_to_old_if_done();
+        }
+
+        // the new table is walked first, then what is left of the old one
+        void move_to_old_if_done() noexcept
+        {
+            if (!m_in_old && m_it == m_owner->m_new.end())
+            {
+                m_in_old = true;
+                m_it = m_owner->m_old.begin();
+            }
+        }
+
+    public:
+        basic_iterator() = default;
+
+        template <bool WasConst>
+            requires(Const && !WasConst)
+        basic_iterator(basic_iterator<WasConst> that) noexcept
+            : m_owner(that.m_owner), m_it(that.m_it), m_in_old(that.m_in_old)
+        {
+        }
+
+        basic_iterator &operator++() noexcept
+        {
+            ++m_it;
+            move_to_old_if_done();
+            return *this;
+        }
+
+        basic_iterator operator++(int) noexcept
+        {
+            auto ret = *this;
+            ++*this;
+            return ret;
+        }
+
+        reference operator*() const noexcept
+        {
+            return *m_it;
+        }
+
+        pointer operator->() const noexcept
+        {
+            return &*m_it;
+        }
+
+        bool operator==(basic_iterator const &that) const noexcept
+        {
+            return m_in_old == that.m_in_old && m_it == that.m_it;
+        }
+
+        bool operator!=(basic_iterator const &that) const noexcept
+        {
+            return !(*this == that);
+        }
+
+        template <bool>
+        friend struct basic_iterator;
+    };
+
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    // step: elements migrated per operation while a resize is under way
+    explicit IncrementalHashMap(size_t step = 8, Hash const &hash = Hash(), Eq const &eq = Eq(),
+                                Alloc const &alloc = Alloc())
+        : m_new(0, hash, eq, alloc), m_old(0, hash, eq, alloc), m_cursor(m_old.end()), m_step(step ? step : 1)
+    {
+    }
+
+    IncrementalHashMap(std::initializer_list<value_type> ilist) : IncrementalHashMap()
+    {
+        m_new.reserve(ilist.size());
+        for (auto const &item : ilist)
+        {
+            insert(item);
+        }
+    }
+
+    // a copy holds everything in one table
+    IncrementalHashMap(IncrementalHashMap const &that)
+        : m_new(that.m_new), m_old(0, that.m_new.hash_function(), that.m_new.key_eq(), m_new.get_allocator()),
+          m_cursor(m_old.end()), m_step(that.m_step)
+    {
+        for (auto it = that.m_old.begin(); it != that.m_old.end(); ++it)
+        {
+            m_new.insert(*it);
+        }
+    }
+
+    // a moved table keeps its storage, so the migration cursor stays valid
+    IncrementalHashMap(IncrementalHashMap &&that) noexcept
+        : m_new(std::move(that.m_new)), m_old(std::move(that.m_old)), m_cursor(that.m_cursor), m_step(that.m_step)
+    {
+        that.m_cursor = that.m_old.end();
+    }
+
+    IncrementalHashMap &operator=(IncrementalHashMap that) noexcept
+    {
+        m_new.swap(that.m_new);
+        m_old.swap(that.m_old);
+        std::swap(m_cursor, that.m_cursor);
+        m_step = that.m_step;
+        return *this;
+    }
+
+    Alloc get_allocator() const noexcept
+    {
+        return m_new.get_allocator();
+    }
+
+    [[nodiscard]] size_t size() const noexcept
+    {
+        return m_new.size() + m_old.size();
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    [[nodiscard]] bool is_rehashing() const noexcept
+    {
+        return m_old.capacity() != 0;
+    }
+
+    // capacity of the table new elements go to
+    [[nodiscard]] size_t capacity() const noexcept
+    {
+        return m_new.capacity();
+    }
+
+    // completes a migration under way right now
+    void finish_rehash()
+    {
+        migrate(m_old.size());
+    }
+
+    // sizes the table for n elements in one go, finishing any migration first
+    void reserve(size_t n)
+    {
+        finish_rehash();
+        m_new.reserve(n);
+    }
+
+    void clear() noexcept
+    {
+        m_new.clear();
+        m_old.clear();
+        m_cursor = m_old.end();
+    }
+
+    iterator begin() noexcept
+    {
+        return iterator{this, m_new.begin(), false};
+    }
+
+    iterator end() noexcept
+    {
+        return iterator{this, m_old.end(), true};
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return const_iterator{this, m_new.begin(), false};
+    }
+
+    const_iterator end() const noexcept
+    {
+        return const_iterator{this, m_old.end(), true};
+    }
+
+    iterator find(K const &key)
+    {
+        migrate(m_step);
+        auto it = m_new.find(key);
+        if (it != m_new.end())
+            return iterator{this, it, false};
+        return iterator{this, m_old.find(key), true};
+    }
+
+    template <class Key>
+        requires TransparentHashEq<Hash, Eq>
+    iterator find(Key const &key)
+    {
+        migrate(m_step);
+        auto it = m_new.find(key);
+        if (it != m_new.end())
+            return iterator{this, it, false};
+        return iterator{this, m_old.find(key), true};
+    }
+
+    const_iterator find(K const &key) const
+    {
+        auto it = m_new.find(key);
+        if (it != m_new.end())
+            return const_iterator{this, it, false};
+        return const_iterator{this, m_old.find(key), true};
+    }
+
+    template <class Key>
+        requires TransparentHashEq<Hash, Eq>
+    const_iterator find(Key const &key) const
+    {
+        auto it = m_new.find(key);
+        if (it != m_new.end())
+            return const_iterator{this, it, false};
+        return const_iterator{this, m_old.find(key), true};
+    }
+
+    [[nodiscard]] bool contains(K const &key) const
+    {
+        return m_new.contains(key) || m_old.contains(key);
+    }
+
+    template <class Key>
+        requires TransparentHashEq<Hash, Eq>
+    [[nodiscard]] bool contains(Key const &key) const
+    {
+        return m_new.contains(key) || m_old.contains(key);
+    }
+
+    [[nodiscard]] size_t count(K const &key) const
+    {
+        return contains(key) ? 1 : 0;
+    }
+
+    template <class Key>
+        requires TransparentHashEq<Hash, Eq>
+    [[nodiscard]] size_t count(Key const &key) const
+    {
+        return contains(key) ? 1 : 0;
+    }
+
+    V &at(K const &key)
+    {
+        auto it = find(key);
+        if (it == end())
+            throw std::out_of_range("IncrementalHashMap::at");
+        return it->second;
+    }
+
+    V const &at(K const &key) const
+    {
+        auto it = find(key);
+        if (it == end())
+            throw std::out_of_range("IncrementalHashMap::at");
+        return it->second;
+    }
+
+    template <class... Args>
+    std::pair<iterator, bool> try_emplace(K const &key, Args &&...args)
+    {
+        migrate(m_step);
+        auto old = m_old.find(key);
+        if (old != m_old.end())
+            return {iterator{this, old, true}, false};
+        // a full m_new is about to become m_old, so the key must be looked up before that
+        auto cur = m_new.find(key);
+        if (cur != m_new.end())
+            return {iterator{this, cur, false}, false};
+        grow_if_full();
+        auto [it, inserted] = m_new.try_emplace(key, std::forward<Args>(args)...);
+        return {iterator{this, it, false}, inserted};
+    }
+
+    template <class... Args>
+    std::pair<iterator, bool> try_emplace(K &&key, Args &&...args)
+    {
+        migrate(m_step);
+        auto old = m_old.find(key);
+        if (old != m_old.end())
+            return {iterator{this, old, true}, false};
+        // a full m_new is about to become m_old, so the key must be looked up before that
+        auto cur = m_new.find(key);
+        if (cur != m_new.end())
+            return {iterator{this, cur, false}, false};
+        grow_if_full();
+        auto [it, inserted] = m_new.try_emplace(std::move(key), std::forward<Args>(args)...);
+        return {iterator{this, it, false}, inserted};
+    }
+
+    std::pair<iterator, bool> insert(value_type const &val)
+    {
+        return try_emplace(val.first, val.second);
+    }
+
+    template <class M>
+    std::pair<iterator, bool> insert_or_assign(K const &key, M &&obj)
+    {
+        auto ret = try_emplace(key, std::forward<M>(obj));
+        if (!ret.second)
+        {
+            ret.first->second = std::forward<M>(obj);
+        }
+        return ret;
+    }
+
+    V &operator[](K const &key)
+    {
+        return try_emplace(key).first->second;
+    }
+
+    size_t erase(K const &key)
+    {
+        migrate(m_step);
+        if (m_new.erase(key))
+            return 1;
+        auto it = m_old.find(key);
+        if (it == m_old.end())
+            return 0;
+        erase_old(it);
+        return 1;
+    }
+
+    template <class Key>
+        requires(TransparentHashEq<Hash, Eq> && !std::is_convertible_v<Key const &, const_iterator>)
+    size_t erase(Key const &key)
+    {
+        migrate(m_step);
+        if (m_new.erase(key))
+            return 1;
+        auto it = m_old.find(key);
+        if (it == m_old.end())
+            return 0;
+        erase_old(it);
+        return 1;
+    }
+};
+
+// Node of an UnorderedMap: a ForwardList node that also keeps the hash of its key.
+template <class T>
+struct UnorderedMapNode : ForwardListValueNode<T>
+{
+    size_t m_hash;
+};
+
+// Node-based hash map laid out as in libstdc++: every element sits in one singly linked list of
+// ForwardList nodes, with the elements of each bucket adjacent, and the bucket array stores for
+// each bucket the node *before* its first element (the list head for the bucket at the front).
+// That makes erasing through any bucket O(1) with a single link per node, and iteration a plain
+// list walk that never visits empty buckets.
+//
+// Elements never move: inserting, rehashing and erasing other elements leave pointers and
+// references valid, as with std::unordered_map; a rehash invalidates iterators only. Each node
+// caches its hash, so rehashing and bucket scans never call the hasher or compare keys of other
+// hashes. Nodes are allocated one at a time through Alloc rebound to UnorderedMapNode, so a
+// NodePool sized for UnorderedMapNode<std::pair<K const, V>> can serve them.
+template <class K, class V, class Hash = FastHash<K>, class Eq = std::equal_to<K>,
+          class Alloc = std::allocator<std::pair<K const, V>>>
+struct UnorderedMap
+{
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = std::pair<K const, V>;
+    using hasher = Hash;
+    using key_equal = Eq;
+    using allocator_type = Alloc;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using pointer = value_type *;
+    using const_pointer = value_type const *;
+    using reference = value_type &;
+    using const_reference = value_type const &;
+
+private:
+    using ListNode = ForwardListBaseNode<value_type>;
+    using Node = UnorderedMapNode<value_type>;
+    using AllocTraits = std::allocator_traits<Alloc>;
+    using AllocNode = AllocTraits::template rebind_alloc<Node>;
+    using AllocNodeTraits = std::allocator_traits<AllocNode>;
+    using AllocBucket = AllocTraits::template rebind_alloc<ListNode *>;
+    using AllocBucketTraits = std::allocator_traits<AllocBucket>;
+
+    static constexpr size_t min_buckets = 8;
+
+    ListNode m_before_begin;
+    ListNode **m_buckets;
+    size_t m_bucket_count;
+    size_t m_size;
+    unsigned m_shift;
+    float m_max_load_factor;
+    [[no_unique_address]] Hash m_hash;
+    [[no_unique_address]] Eq m_eq;
+    [[no_unique_address]] Alloc m_alloc;
+
+    static K &mutable_key(value_type &val) noexcept
+    {
+        return const_cast<K &>(val.first);
+    }
+
+    static size_t hash_of(ListNode const *node) noexcept
+    {
+        return static_cast<Node const *>(node)->m_hash;
+    }
+
+    // Fibonacci hashing of the cached hash, so identity hashes still spread over the buckets
+    size_t bucket_index(size_t hash) const noexcept
+    {
+        return static_cast<size_t>((static_cast<uint64_t>(hash) * 0x9e3779b97f4a7c15ull) >> m_shift);
+    }
+
+    template <class... Args>
+    Node *new_node(Args &&...args)
+    {
+        AllocNode alloc{m_alloc};
+        Node *node = AllocNodeTraits::allocate(alloc, 1);
+        try
+        {
+            AllocNodeTraits::construct(alloc, &node->m_value, std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            AllocNodeTraits::deallocate(alloc, node, 1);
+            throw;
+        }
+        node->m_next = nullptr;
+        return node;
+    }
+
+    void delete_node(ListNode *node) noexcept
+    {
+        AllocNode alloc{m_alloc};
+        Node *value_node = static_cast<Node *>(node);
+        AllocNodeTraits::destroy(alloc, &value_node->m_value);
+        AllocNodeTraits::deallocate(alloc, value_node, 1);
+    }
+
+    void delete_all() noexcept
+    {
+        ListNode *node = m_before_begin.m_next;
+        while (node)
+        {
+            ListNode *next = node->m_next;
+            delete_node(node);
+            node = next;
+        }
+        m_before_begin.m_next = nullptr;
+    }
+
+    void deallocate_buckets() noexcept
+    {
+        if (m_bucket_count == 0)
+            return;
+        AllocBucket alloc{m_alloc};
+        AllocBucketTraits::deallocate(alloc, m_buckets, m_bucket_count);
+        m_buckets = nullptr;
+        m_bucket_count = 0;
+        m_shift = 64;
+    }
+
+    // the node before the one holding key, or null if key is absent
+    template <class Key>
+    ListNode *find_before(size_t bucket, Key const &key, size_t hash) const
+    {
+        ListNode *prev = m_buckets[bucket];
+        if (!prev)
+            return nullptr;
+        for (ListNode *node = prev->m_next; node; prev = node, node = node->m_next)
+        {
+            if (hash_of(node) == hash && m_eq(node->value().first, key))
+                return prev;
+            if (node->m_next && bucket_index(hash_of(node->m_next)) != bucket)
+                break;
+        }
+        return nullptr;
+    }
+
+    template <class Key>
+    Node *find_node(Key const &key) const
+    {
+        if (m_size == 0)
+            return nullptr;
+        return find_node(key, m_hash(key));
+    }
+
+    template <class Key>
+    Node *find_node(Key const &key, size_t hash) const
+    {
+        ListNode *prev = find_before(bucket_index(hash), key, hash);
+        return prev ? static_cast<Node *>(prev->m_next) : nullptr;
+    }
+
+    // Calls f(i, node holding keys[i] or null) in order. Each batch goes through three passes so
+    // the dependent misses of a chained lookup overlap across keys: prefetch the bucket entries,
+    // then the predecessor nodes they point to, then search.
+    template <class F>
+    void lookup_many(std::span<K const> keys, F f) const
+    {
+        size_t hashes[lookup_batch];
+        for (size_t first = 0; first < keys.size(); first += lookup_batch)
+        {
+            size_t n = std::min(lookup_batch, keys.size() - first);
+            if (m_size == 0)
+            {
+                for (size_t i = 0; i < n; i++)
+                {
+                    f(first + i, nullptr);
+                }
+                continue;
+            }
+            for (size_t i = 0; i < n; i++)
+            {
+                hashes[i] = m_hash(keys[first + i]);
+                prefetch_read(m_buckets + bucket_index(hashes[i]));
+            }
+            for (size_t i = 0; i < n; i++)
+            {
+                if (ListNode *prev = m_buckets[bucket_index(hashes[i])])
+                {
+                    prefetch_read(prev);
+                }
+            }
+            for (size_t i = 0; i < n; i++)
+            {
+                f(first + i, find_node(keys[first + i], hashes[i]));
+            }
+        }
+    }
+
+    // Relinks every node into a new bucket array using the cached hashes; no element is touched.
+    void rehash_buckets(size_t bucket_count)
+    {
+        AllocBucket alloc{m_alloc};
+        ListNode **buckets = AllocBucketTraits::allocate(alloc, bucket_count);
+        std::fill_n(buckets, bucket_count, nullptr);
+        deallocate_buckets();
+        m_buckets = buckets;
+        m_bucket_count = bucket_count;
+        m_shift = 64 - std::countr_zero(bucket_count);
+
+        ListNode *node = m_before_begin.m_next;
+        m_before_begin.m_next = nullptr;
+        size_t front_bucket = 0;
+        while (node)
+        {
+            ListNode *next = node->m_next;
+            size_t bucket = bucket_index(hash_of(node));
+            if (!m_buckets[bucket])
+            {
+                node->m_next = m_before_begin.m_next;
+                m_before_begin.m_next = node;
+                m_buckets[bucket] = &m_before_begin;
+                if (node->m_next)
+                {
+                    m_buckets[front_bucket] = node;
+                }
+                front_bucket = bucket;
+            }
+            else
+            {
+                node->m_next = m_buckets[bucket]->m_next;
+                m_buckets[bucket]->m_next = node;
+            }
+            node = next;
+        }
+    }
+
+    size_t buckets_for(size_t n) const noexcept
+    {
+        size_t needed = static_cast<size_t>(static_cast<double>(n) / m_max_load_factor) + 1;
+        return std::bit_ceil(std::max(needed, min_buckets));
+    }
+
+    void link_node(Node *node) noexcept
+    {
+        size_t bucket = bucket_index(node->m_hash);
+        if (m_buckets[bucket])
+        {
+            node->m_next = m_buckets[bucket]->m_next;
+            m_buckets[bucket]->m_next = node;
+        }
+        else
+        {
+            // an empty bucket's elements go to the front of the list
+            node->m_next = m_before_begin.m_next;
+            m_before_begin.m_next = node;
+            if (node->m_next)
+            {
+                m_buckets[bucket_index(hash_of(node->m_next))] = node;
+            }
+            m_buckets[bucket] = &m_before_begin;
+        }
+        ++m_size;
+    }
+
+    // Links a node known to hold a new key, growing the buckets first if needed; on failure the
+    // node is freed.
+    Node *insert_node(Node *node)
+    {
+        if (m_bucket_count == 0 || m_size + 1 > static_cast<double>(m_bucket_count) * m_max_load_factor)
+        {
+            try
+            {
+                rehash_buckets(std::max(buckets_for(m_size + 1), m_bucket_count * 2));
+            }
+            catch (...)
+            {
+                delete_node(node);
+                throw;
+            }
+        }
+        link_node(node);
+        return node;
+    }
+
+    ListNode *unlink_after(ListNode *prev) noexcept
+    {
+        ListNode *node = prev->m_next;
+        ListNode *next = node->m_next;
+        size_t bucket = bucket_index(hash_of(node));
+        if (prev == m_buckets[bucket])
+        {
+            // node was the first of its bucket
+            if (!next || bucket_index(hash_of(next)) != bucket)
+            {
+                if (next)
+                {
+                    m_buckets[bucket_index(hash_of(next))] = prev;
+                }
+                m_buckets[bucket] = nullptr;
+            }
+        }
+        else if (next)
+        {
+            size_t next_bucket = bucket_index(hash_of(next));
+            if (next_bucket != bucket)
+            {
+                m_buckets[next_bucket] = prev;
+            }
+        }
+        prev->m_next = next;
+        --m_size;
+        return next;
+    }
+
+    ListNode *before(ListNode *node) const noexcept
+    {
+        ListNode *prev = m_buckets[bucket_index(hash_of(node))];
+        while (prev->m_next != node)
+        {
+            prev = prev->m_next;
+        }
+        return prev;
+    }
+
+    template <class Key, class... Args>
+    std::pair<Node *, bool> try_emplace_node(Key &&key, Args &&...args)
+    {
+        size_t hash = m_hash(key);
+        if (m_bucket_count)
+        {
+            if (ListNode *prev = find_before(bucket_index(hash), key, hash))
+                return {static_cast<Node *>(prev->m_next), false};
+        }
+        Node *node = new_node(std::piecewise_construct, std::forward_as_tuple(std::forward<Key>(key)),
+                              std::forward_as_tuple(std::forward<Args>(args)...));
+        node->m_hash = hash;
+        return {insert_node(node), true};
+    }
+
+    void copy_from(UnorderedMap const &that)
+    {
+        if (that.m_size == 0)
+            return;
+        rehash_buckets(buckets_for(that.m_size));
+        for (ListNode *from = that.m_before_begin.m_next; from; from = from->m_next)
+        {
+            Node *node = new_node(from->value());
+            node->m_hash = hash_of(from);
+            link_node(node);
+        }
+    }
+
+    void steal(UnorderedMap &that) noexcept
+    {
+        m_before_begin.m_next = std::exchange(that.m_before_begin.m_next, nullptr);
+        m_buckets = std::exchange(that.m_buckets, nullptr);
+        m_bucket_count = std::exchange(that.m_bucket_count, 0);
+        m_size = std::exchange(that.m_size, 0);
+        m_shift = std::exchange(that.m_shift, 64);
+        if (m_before_begin.m_next)
+        {
+            m_buckets[bucket_index(hash_of(m_before_begin.m_next))] = &m_before_begin;
+        }
+    }
+
+    void move_elements_from(UnorderedMap &that)
+    {
+        if (that.m_size)
+        {
+            rehash_buckets(buckets_for(that.m_size));
+        }
+        for (ListNode *from = that.m_before_begin.m_next; from; from = from->m_next)
+        {
+            Node *node = new_node(std::move(mutable_key(from->value())), std::move(from->value().second));
+            node->m_hash = hash_of(from);
+            link_node(node);
+        }
+        that.clear();
+    }
+
+public:
+    template <bool Const>
+    struct basic_iterator
+    {
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = UnorderedMap::value_type;
+        using difference_type = ptrdiff_t;
+        using pointer = std::conditional_t<Const, value_type const *, value_type *>;
+        using reference = std::conditional_t<Const, value_type const &, value_type &>;
+
+    private:
+        ListNode *m_node;
+
+        friend UnorderedMap;
+
+        explicit basic_iterator(ListNode *node) noexcept : m_node(node)
+        {
+        }
+
+    public:
+        basic_iterator() = default;
+
+        template <bool WasConst>
+            requires(Const && !WasConst)
+        basic_iterator(basic_iterator<WasConst> that) noexcept : m_node(that.m_node)
+        {
+        }
+
+        basic_iterator &operator++() noexcept
+        {
+            m_node = m_node->m_next;
+            return *this;
+        }
+
+        basic_iterator operator++(int) noexcept
+        {
+            auto ret = *this;
+            ++*this;
+            return ret;
+        }
+
+        reference operator*() const noexcept
+        {
+            return m_node->value();
+        }
+
+        pointer operator->() const noexcept
+        {
+            return &m_node->value();
+        }
+
+        bool operator==(basic_iterator const &that) const noexcept
+        {
+            return m_node == that.m_node;
+        }
+
+        bool operator!=(basic_iterator const &that) const noexcept
+        {
+            return !(*this == that);
+        }
+
+        template <bool>
+        friend struct basic_iterator;
+    };
+
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    UnorderedMap() : UnorderedMap(0)
+    {
+    }
+
+    explicit UnorderedMap(size_t bucket_count, Hash const &hash = Hash(), Eq const &eq = Eq(),
+                          Alloc const &alloc = Alloc())
+        : m_buckets(nullptr), m_bucket_count(0), m_size(0), m_shift(64), m_max_load_factor(1.0f), m_hash(hash),
+          m_eq(eq), m_alloc(alloc)
+    {
+        m_before_begin.m_next = nullptr;
+        if (bucket_count)
+        {
+            rehash_buckets(std::bit_ceil(std::max(bucket_count, min_buckets)));
+        }
+    }
+
+    explicit UnorderedMap(Alloc const &alloc) : UnorderedMap(0, Hash(), Eq(), alloc)
+    {
+    }
+
+    template <std::input_iterator InputIt>
+    UnorderedMap(InputIt first, InputIt last, size_t bucket_count = 0, Hash const &hash = Hash(),
+                 Eq const &eq = Eq(), Alloc const &alloc = Alloc())
+        : UnorderedMap(bucket_count, hash, eq, alloc)
+    {
+        insert(first, last);
+    }
+
+    UnorderedMap(std::initializer_list<value_type> ilist, size_t bucket_count = 0, Hash const &hash = Hash(),
+                 Eq const &eq = Eq(), Alloc const &alloc = Alloc())
+        : UnorderedMap(ilist.begin(), ilist.end(), bucket_count, hash, eq, alloc)
+    {
+    }
+
+    UnorderedMap(UnorderedMap const &that)
+        : UnorderedMap(0, that.m_hash, that.m_eq, AllocTraits::select_on_container_copy_construction(that.m_alloc))
+    {
+        m_max_load_factor = that.m_max_load_factor;
+        copy_from(that);
+    }
+
+    UnorderedMap(UnorderedMap const &that, Alloc const &alloc) : UnorderedMap(0, that.m_hash, that.m_eq, alloc)
+    {
+        m_max_load_factor = that.m_max_load_factor;
+        copy_from(that);
+    }
+
+    UnorderedMap(UnorderedMap &&that) noexcept : UnorderedMap(0, that.m_hash, that.m_eq, std::move(that.m_alloc))
+    {
+        m_max_load_factor = that.m_max_load_factor;
+        steal(that);
+    }
+
+    UnorderedMap(UnorderedMap &&that, Alloc const &alloc) : UnorderedMap(0, that.m_hash, that.m_eq, alloc)
+    {
+        m_max_load_factor = that.m_max_load_factor;
+        if (m_alloc == that.m_alloc)
+        {
+            steal(that);
+        }
+        else
+        {
+            move_elements_from(that);
+        }
+    }
+
+    UnorderedMap &operator=(UnorderedMap const &that)
+    {
+        if (this == &that)
+            return *this;
+        clear();
+        if constexpr (AllocTraits::propagate_on_container_copy_assignment::value)
+        {
+            deallocate_buckets();
+            m_alloc = that.m_alloc;
+        }
+        m_hash = that.m_hash;
+        m_eq = that.m_eq;
+        m_max_load_factor = that.m_max_load_factor;
+        copy_from(that);
+        return *this;
+    }
+
+    UnorderedMap &operator=(UnorderedMap &&that) noexcept(AllocTraits::propagate_on_container_move_assignment::value ||
+                                                           AllocTraits::is_always_equal::value)
+    {
+        if (this == &that)
+            return *this;
+        clear();
+        m_hash = that.m_hash;
+        m_eq = that.m_eq;
+        m_max_load_factor = that.m_max_load_factor;
+        if constexpr (AllocTraits::propagate_on_container_move_assignment::value)
+        {
+            deallocate_buckets();
+            m_alloc = std::move(that.m_alloc);
+            steal(that);
+        }
+        else if (m_alloc == that.m_alloc)
+        {
+            deallocate_buckets();
+            steal(that);
+        }
+        else
+        {
+            move_elements_from(that);
+        }
+        return *this;
+    }
+
+    ~UnorderedMap()
+    {
+        delete_all();
+        deallocate_buckets();
+    }
+
+    void swap(UnorderedMap &that) noexcept
+    {
+        if constexpr (AllocTraits::propagate_on_container_swap::value)
+        {
+            std::swap(m_alloc, that.m_alloc);
+        }
+        std::swap(m_before_begin.m_next, that.m_before_begin.m_next);
+        std::swap(m_buckets, that.m_buckets);
+        std::swap(m_bucket_count, that.m_bucket_count);
+        std::swap(m_size, that.m_size);
+        std::swap(m_shift, that.m_shift);
+        std::swap(m_max_load_factor, that.m_max_load_factor);
+        std::swap(m_hash, that.m_hash);
+        std::swap(m_eq, that.m_eq);
+        // the bucket of each front element pointed at the other map's list head
+        if (m_before_begin.m_next)
+        {
+            m_buckets[bucket_index(hash_of(m_before_begin.m_next))] = &m_before_begin;
+        }
+        if (that.m_before_begin.m_next)
+        {
+            that.m_buckets[that.bucket_index(hash_of(that.m_before_begin.m_next))] = &that.m_before_begin;
+        }
+    }
+
+    Alloc get_allocator() const noexcept
+    {
+        return m_alloc;
+    }
+
+    hasher hash_function() const
+    {
+        return m_hash;
+    }
+
+    key_equal key_eq() const
+    {
+        return m_eq;
+    }
+
+    [[nodiscard]] size_t size() const noexcept
+    {
+        return m_size;
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return m_size == 0;
+    }
+
+    [[nodiscard]] size_t bucket_count() const noexcept
+    {
+        return m_bucket_count;
+    }
+
+    // 0 while no buckets are allocated
+    [[nodiscard]] size_t bucket(K const &key) const
+    {
+        return m_bucket_count ? bucket_index(m_hash(key)) : 0;
+    }
+
+    // 0 for an n past bucket_count(), including every n before the first insert
+    [[nodiscard]] size_t bucket_size(size_t n) const noexcept
+    {
+        size_t count = 0;
+        if (n < m_bucket_count && m_buckets[n])
+        {
+            for (ListNode *node = m_buckets[n]->m_next; node && bucket_index(hash_of(node)) == n; node = node->m_next)
+            {
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    [[nodiscard]] float load_factor() const noexcept
+    {
+        return m_bucket_count ? float(m_size) / float(m_bucket_count) : 0.0f;
+    }
+
+    [[nodiscard]] float max_load_factor() const noexcept
+    {
+        return m_max_load_factor;
+    }
+
+    void max_load_factor(float ml)
+    {
+        m_max_load_factor = ml;
+        reserve(m_size);
+    }
+
+    // keeps the bucket array, so refilling to the same size only allocates nodes
+    void clear() noexcept
+    {
+        delete_all();
+        m_size = 0;
+        if (m_bucket_count)
+        {
+            std::fill_n(m_buckets, m_bucket_count, nullptr);
+        }
+    }
+
+    void rehash(size_t n)
+    {
+        size_t bucket_count = std::max(std::bit_ceil(std::max(n, min_buckets)), m_size ? buckets_for(m_size) : 0);
+        if (bucket_count != m_bucket_count)
+        {
+            rehash_buckets(bucket_count);
+        }
+    }
+
+    // makes room for n elements in total without another rehash
+    void reserve(size_t n)
+    {
+        size_t bucket_count = buckets_for(n);
+        if (bucket_count > m_bucket_count)
+        {
+            rehash_buckets(bucket_count);
+        }
+    }
+
+    iterator begin() noexcept
+    {
+        return iterator(m_before_begin.m_next);
+    }
+
+    iterator end() noexcept
+    {
+        return iterator(nullptr);
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return const_iterator(m_before_begin.m_next);
+    }
+
+    const_iterator end() const noexcept
+    {
+        return const_iterator(nullptr);
+    }
+
+    const_iterator cbegin() const noexcept
+    {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept
+    {
+        return end();
+    }
+
+    iterator find(K const &key)
+    {
+        return iterator(find_node(key));
+    }
+
+    template <class Key>
+        requires TransparentHashEq<Hash, Eq>
+    iterator find(Key const &key)
+    {
+        return iterator(find_node(key));
+    }
+
+    const_iterator find(K const &key) const
+    {
+        return const_iterator(find_node(key));
+    }
+
+    template <class Key>
+        requires TransparentHashEq<Hash, Eq>
+    const_iterator find(Key const &key) const
+    {
+        return const_iterator(find_node(key));
+    }
+
+    [[nodiscard]] bool contains(K const &key) const
+    {
+        return find_node(key) != nullptr;
+    }
+
+    template <class Key>
+        requires TransparentHashEq<Hash, Eq>
+    [[nodiscard]] bool contains(Key const &key) const
+    {
+        return find_node(key) != nullptr;
+    }
+
+    [[nodiscard]] size_t count(K const &key) const
+    {
+        return contains(key) ? 1 : 0;
+    }
+
+    template <class Key>
+        requires TransparentHashEq<Hash, Eq>
+    [[nodiscard]] size_t count(Key const &key) const
+    {
+        return contains(key) ? 1 : 0;
+    }
+
+    std::pair<iterator, iterator> equal_range(K const &key)
+    {
+        iterator it = find(key);
+        return {it, it == end() ? it : std::next(it)};
+    }
+
+    template <class Key>
+        requires TransparentHashEq<Hash, Eq>
+    std::pair<iterator, iterator> equal_range(Key const &key)
+    {
+        iterator it = find(key);
+        return {it, it == end() ? it : std::next(it)};
+    }
+
+    std::pair<const_iterator, const_iterator> equal_range(K const &key) const
+    {
+        const_iterator it = find(key);
+        return {it, it == end() ? it : std::next(it)};
+    }
+
+    template <class Key>
+        requires TransparentHashEq<Hash, Eq>
+    std::pair<const_iterator, const_iterator> equal_range(Key const &key) const
+    {
+        const_iterator it = find(key);
+        return {it, it == end() ? it : std::next(it)};
+    }
+
+    V &at(K const &key)
+    {
+        Node *node = find_node(key);
+        if (!node)
+            throw std::out_of_range("UnorderedMap::at");
+        return node->m_value.second;
+    }
+
+    V const &at(K const &key) const
+    {
+        return const_cast<UnorderedMap *>(this)->at(key);
+    }
+
+    V &operator[](K const &key)
+    {
+        return try_emplace_node(key).first->m_value.second;
+    }
+
+    V &operator[](K &&key)
+    {
+        return try_emplace_node(std::move(key)).first->m_value.second;
+    }
+
+    template <class... Args>
+    std::pair<iterator, bool> try_emplace(K const &key, Args &&...args)
+    {
+        auto [node, inserted] = try_emplace_node(key, std::forward<Args>(args)...);
+        return {iterator(node), inserted};
+    }
+
+    template <class... Args>
+    std::pair<iterator, bool> try_emplace(K &&key, Args &&...args)
+    {
+        auto [node, inserted] = try_emplace_node(std::move(key), std::forward<Args>(args)...);
+        return {iterator(node), inserted};
+    }
+
+    template <class... Args>
+    iterator try_emplace(const_iterator, K const &key, Args &&...args)
+    {
+        return try_emplace(key, std::forward<Args>(args)...).first;
+    }
+
+    template <class... Args>
+    iterator try_emplace(const_iterator, K &&key, Args &&...args)
+    {
+        return try_emplace(std::move(key), std::forward<Args>(args)...).first;
+    }
+
+    // The node is built first, as in std::unordered_map, and freed again if its key is taken.
+    template <class... Args>
+    std::pair<iterator, bool> emplace(Args &&...args)
+    {
+        Node *node = new_node(std::forward<Args>(args)...);
+        node->m_hash = m_hash(node->m_value.first);
+        if (m_bucket_count)
+        {
+            if (ListNode *prev = find_before(bucket_index(node->m_hash), node->m_value.first, node->m_hash))
+            {
+                delete_node(node);
+                return {iterator(prev->m_next), false};
+            }
+        }
+        return {iterator(insert_node(node)), true};
+    }
+
+    template <class... Args>
+    iterator emplace_hint(const_iterator, Args &&...args)
+    {
+        return emplace(std::forward<Args>(args)...).first;
+    }
+
+    std::pair<iterator, bool> insert(value_type const &val)
+    {
+        return try_emplace(val.first, val.second);
+    }
+
+    std::pair<iterator, bool> insert(value_type &&val)
+    {
+        return try_emplace(std::move(mutable_key(val)), std::move(val.second));
+    }
+
+    iterator insert(const_iterator, value_type const &val)
+    {
+        return insert(val).first;
+    }
+
+    iterator insert(const_iterator, value_type &&val)
+    {
+        return insert(std::move(val)).first;
+    }
+
+    template <std::input_iterator InputIt>
+    void insert(InputIt first, InputIt last)
+    {
+        if constexpr (std::forward_iterator<InputIt>)
+        {
+            reserve(m_size + std::distance(first, last));
+        }
+        for (; first != last; ++first)
+        {
+            insert(*first);
+        }
+    }
+
+    void insert(std::initializer_list<value_type> ilist)
+    {
+        insert(ilist.begin(), ilist.end());
+    }
+
+    template <class M>
+    std::pair<iterator, bool> insert_or_assign(K const &key, M &&obj)
+    {
+        auto [node, inserted] = try_emplace_node(key, std::forward<M>(obj));
+        if (!inserted)
+        {
+            node->m_value.second = std::forward<M>(obj);
+        }
+        return {iterator(node), inserted};
+    }
+
+    template <class M>
+    std::pair<iterator, bool> insert_or_assign(K &&key, M &&obj)
+    {
+        auto [node, inserted] = try_emplace_node(std::move(key), std::forward<M>(obj));
+        if (!inserted)
+        {
+            node->m_value.second = std::forward<M>(obj);
+        }
+        return {iterator(node), inserted};
+    }
+
+    size_t erase(K const &key)
+    {
+        if (m_size == 0)
+            return 0;
+        size_t hash = m_hash(key);
+        ListNode *prev = find_before(bucket_index(hash), key, hash);
+        if (!prev)
+            return 0;
+        ListNode *node = prev->m_next;
+        unlink_after(prev);
+        delete_node(node);
+        return 1;
+    }
+
+    template <class Key>
+        requires(TransparentHashEq<Hash, Eq> && !std::is_convertible_v<Key const &, const_iterator>)
+    size_t erase(Key const &key)
+    {
+        if (m_size == 0)
+            return 0;
+        size_t hash = m_hash(key);
+        ListNode *prev = find_before(bucket_index(hash), key, hash);
+        if (!prev)
+            return 0;
+        ListNode *node = prev->m_next;
+        unlink_after(prev);
+        delete_node(node);
+        return 1;
+    }
+
+    // finding the predecessor walks the element's bucket only
+    iterator erase(const_iterator pos) noexcept
+    {
+        ListNode *node = pos.m_node;
+        ListNode *next = unlink_after(before(node));
+        delete_node(node);
+        return iterator(next);
+    }
+
+    iterator erase(iterator pos) noexcept
+    {
+        return erase(const_iterator(pos));
+    }
+
+    iterator erase(const_iterator first, const_iterator last) noexcept
+    {
+        while (first != last)
+        {
+            first = erase(first);
+        }
+        return iterator(last.m_node);
+    }
+
+    // Looks up every key of keys, storing a pointer to its value in out, or null if it is absent.
+    void find_many(std::span<K const> keys, std::span<V *> out)
+    {
+        if (out.size() < keys.size())
+            throw std::invalid_argument("UnorderedMap::find_many: out is shorter than keys");
+        lookup_many(keys, [&](size_t i, Node *node) { out[i] = node ? &node->m_value.second : nullptr; });
+    }
+
+    void find_many(std::span<K const> keys, std::span<V const *> out) const
+    {
+        if (out.size() < keys.size())
+            throw std::invalid_argument("UnorderedMap::find_many: out is shorter than keys");
+        lookup_many(keys, [&](size_t i, Node *node) { out[i] = node ? &node->m_value.second : nullptr; });
+    }
+
+    // as HashMap::contains_many()
+    template <std::output_iterator<bool> OutputIt>
+    size_t contains_many(std::span<K const> keys, OutputIt out) const
+    {
+        size_t found = 0;
+        lookup_many(keys, [&](size_t, Node *node) {
+            bool present = node != nullptr;
+            *out = present;
+            ++out;
+            found += present;
+        });
+        return found;
+    }
+
+    bool operator==(UnorderedMap const &that) const
+    {
+        if (m_size != that.m_size)
+            return false;
+        for (auto const &item : *this)
+        {
+            auto it = that.find(item.first);
+            if (it == that.end() || !(it->second == item.second))
+                return false;
+        }
+        return true;
+    }
+};
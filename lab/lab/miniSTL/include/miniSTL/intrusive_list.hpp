@@ -0,0 +1,459 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <miniSTL/list.hpp>
+
+struct IntrusiveTag;
+
+// Link embedded in a user object so it can be threaded onto an IntrusiveList without allocating.
+// An unlinked hook has null links. With AutoUnlink (the safe mode) a hook that is still linked
+// when its owner dies takes itself off the list, and linking an already linked hook asserts.
+template <bool AutoUnlink = true>
+struct IntrusiveListHook : ListBaseNode<IntrusiveTag>
+{
+    static constexpr bool auto_unlink = AutoUnlink;
+
+    IntrusiveListHook() noexcept
+    {
+        m_next = nullptr;
+        m_prev = nullptr;
+    }
+
+    // an object's copy starts out on no list
+    IntrusiveListHook(IntrusiveListHook const &) noexcept : IntrusiveListHook()
+    {
+    }
+
+    IntrusiveListHook &operator=(IntrusiveListHook const &) noexcept
+    {
+        return *this;
+    }
+
+    ~IntrusiveListHook()
+    {
+        if constexpr (AutoUnlink)
+        {
+            unlink();
+        }
+    }
+
+    [[nodiscard]] bool is_linked() const noexcept
+    {
+        return m_next != nullptr;
+    }
+
+    void unlink() noexcept
+    {
+        if (!is_linked())
+            return;
+        m_prev->m_next = m_next;
+        m_next->m_prev = m_prev;
+        m_next = nullptr;
+        m_prev = nullptr;
+    }
+};
+
+// Doubly linked list over objects that embed an IntrusiveListHook at HookPtr, e.g.
+// IntrusiveList<Order, &Order::by_price>. The list never owns, copies or allocates its elements;
+// one object can sit on as many lists as it has hooks. Because a hook can unlink itself without
+// knowing its list, no size is cached and size() is linear.
+template <class T, auto HookPtr>
+struct IntrusiveList
+{
+    using value_type = T;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using pointer = T *;
+    using const_pointer = T const *;
+    using reference = T &;
+    using const_reference = T const &;
+
+private:
+    using ListNode = ListBaseNode<IntrusiveTag>;
+    using Hook = std::remove_reference_t<decltype(std::declval<T &>().*HookPtr)>;
+
+    ListNode m_dummy;
+
+    static ptrdiff_t hook_offset() noexcept
+    {
+        alignas(T) static std::byte probe[sizeof(T)];
+        T *owner = reinterpret_cast<T *>(probe);
+        return reinterpret_cast<std::byte *>(&(owner->*HookPtr)) - probe;
+    }
+
+    static T *owner_of(ListNode *node) noexcept
+    {
+        return reinterpret_cast<T *>(reinterpret_cast<std::byte *>(static_cast<Hook *>(node)) - hook_offset());
+    }
+
+    static T const *owner_of(ListNode const *node) noexcept
+    {
+        return owner_of(const_cast<ListNode *>(node));
+    }
+
+    static ListNode *hook_of(T &val) noexcept
+    {
+        return &(val.*HookPtr);
+    }
+
+    static void link_before(ListNode *next, ListNode *node) noexcept
+    {
+        assert(!static_cast<Hook *>(node)->is_linked() && "object is already on a list through this hook");
+        node->m_prev = next->m_prev;
+        node->m_next = next;
+        next->m_prev->m_next = node;
+        next->m_prev = node;
+    }
+
+    static void reseat_dummy(ListNode &dummy, ListNode &old_dummy) noexcept
+    {
+        if (dummy.m_next == &old_dummy)
+        {
+            dummy.m_next = dummy.m_prev = &dummy;
+        }
+        else
+        {
+            dummy.m_next->m_prev = &dummy;
+            dummy.m_prev->m_next = &dummy;
+        }
+    }
+
+public:
+    struct iterator
+    {
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = ptrdiff_t;
+        using pointer = T *;
+        using reference = T &;
+
+    private:
+        ListNode *m_curr;
+
+        friend IntrusiveList;
+
+        explicit iterator(ListNode *curr) noexcept : m_curr(curr) {}
+
+    public:
+        iterator() = default;
+
+        iterator &operator++() noexcept
+        {
+            m_curr = m_curr->m_next;
+            return *this;
+        }
+
+        iterator operator++(int) noexcept
+        {
+            auto ret = *this;
+            m_curr = m_curr->m_next;
+            return ret;
+        }
+
+        iterator &operator--() noexcept
+        {
+            m_curr = m_curr->m_prev;
+            return *this;
+        }
+
+        iterator operator--(int) noexcept
+        {
+            auto ret = *this;
+            m_curr = m_curr->m_prev;
+            return ret;
+        }
+
+        T &operator*() const noexcept
+        {
+            return *owner_of(m_curr);
+        }
+
+        T *operator->() const noexcept
+        {
+            return owner_of(m_curr);
+        }
+
+        bool operator!=(iterator const &that) const noexcept
+        {
+            return !(*this == that);
+        }
+
+        bool operator==(iterator const &that) const noexcept
+        {
+            return m_curr == that.m_curr;
+        }
+    };
+
+    struct const_iterator
+    {
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = ptrdiff_t;
+        using pointer = T const *;
+        using reference = T const &;
+
+    private:
+        ListNode const *m_curr;
+
+        friend IntrusiveList;
+
+        explicit const_iterator(ListNode const *curr) noexcept : m_curr(curr) {}
+
+    public:
+        const_iterator() = default;
+
+        const_iterator(iterator that) noexcept : m_curr(that.m_curr) {}
+
+        explicit operator iterator() noexcept
+        {
+            return iterator{const_cast<ListNode *>(m_curr)};
+        }
+
+        const_iterator &operator++() noexcept
+        {
+            m_curr = m_curr->m_next;
+            return *this;
+        }
+
+        const_iterator operator++(int) noexcept
+        {
+            auto ret = *this;
+            m_curr = m_curr->m_next;
+            return ret;
+        }
+
+        const_iterator &operator--() noexcept
+        {
+            m_curr = m_curr->m_prev;
+            return *this;
+        }
+
+        const_iterator operator--(int) noexcept
+        {
+            auto ret = *this;
+            m_curr = m_curr->m_prev;
+            return ret;
+        }
+
+        T const &operator*() const noexcept
+        {
+            return *owner_of(m_curr);
+        }
+
+        T const *operator->() const noexcept
+        {
+            return owner_of(m_curr);
+        }
+
+        bool operator!=(const_iterator const &that) const noexcept
+        {
+            return !(*this == that);
+        }
+
+        bool operator==(const_iterator const &that) const noexcept
+        {
+            return m_curr == that.m_curr;
+        }
+    };
+
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using reverse_const_iterator = std::reverse_iterator<const_iterator>;
+
+    IntrusiveList() noexcept
+    {
+        m_dummy.m_next = &m_dummy;
+        m_dummy.m_prev = &m_dummy;
+    }
+
+    IntrusiveList(IntrusiveList const &) = delete;
+    IntrusiveList &operator=(IntrusiveList const &) = delete;
+
+    IntrusiveList(IntrusiveList &&that) noexcept : IntrusiveList()
+    {
+        swap(that);
+    }
+
+    IntrusiveList &operator=(IntrusiveList &&that) noexcept
+    {
+        clear();
+        swap(that);
+        return *this;
+    }
+
+    // the objects outlive the list, so they are only unlinked
+    ~IntrusiveList()
+    {
+        clear();
+    }
+
+    void swap(IntrusiveList &that) noexcept
+    {
+        std::swap(m_dummy, that.m_dummy);
+        reseat_dummy(m_dummy, that.m_dummy);
+        reseat_dummy(that.m_dummy, m_dummy);
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return m_dummy.m_next == &m_dummy;
+    }
+
+    [[nodiscard]] size_t size() const noexcept
+    {
+        size_t n = 0;
+        for (ListNode const *cur = m_dummy.m_next; cur != &m_dummy; cur = cur->m_next)
+        {
+            ++n;
+        }
+        return n;
+    }
+
+    T &front() noexcept
+    {
+        return *owner_of(m_dummy.m_next);
+    }
+
+    T &back() noexcept
+    {
+        return *owner_of(m_dummy.m_prev);
+    }
+
+    T const &front() const noexcept
+    {
+        return *owner_of(m_dummy.m_next);
+    }
+
+    T const &back() const noexcept
+    {
+        return *owner_of(m_dummy.m_prev);
+    }
+
+    iterator begin() noexcept
+    {
+        return iterator{m_dummy.m_next};
+    }
+
+    iterator end() noexcept
+    {
+        return iterator{&m_dummy};
+    }
+
+    const_iterator cbegin() const noexcept
+    {
+        return const_iterator{m_dummy.m_next};
+    }
+
+    const_iterator cend() const noexcept
+    {
+        return const_iterator{&m_dummy};
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return cbegin();
+    }
+
+    const_iterator end() const noexcept
+    {
+        return cend();
+    }
+
+    reverse_iterator rbegin() noexcept
+    {
+        return std::make_reverse_iterator(end());
+    }
+
+    reverse_iterator rend() noexcept
+    {
+        return std::make_reverse_iterator(begin());
+    }
+
+    reverse_const_iterator crbegin() const noexcept
+    {
+        return std::make_reverse_iterator(cend());
+    }
+
+    reverse_const_iterator crend() const noexcept
+    {
+        return std::make_reverse_iterator(cbegin());
+    }
+
+    // iterator to an object known to be on this list
+    static iterator iterator_to(T &val) noexcept
+    {
+        return iterator{hook_of(val)};
+    }
+
+    static const_iterator iterator_to(T const &val) noexcept
+    {
+        return const_iterator{hook_of(const_cast<T &>(val))};
+    }
+
+    // takes val off whichever list its hook is on, without needing that list
+    static void unlink(T &val) noexcept
+    {
+        static_cast<Hook *>(hook_of(val))->unlink();
+    }
+
+    iterator insert(const_iterator pos, T &val) noexcept
+    {
+        ListNode *node = hook_of(val);
+        link_before(const_cast<ListNode *>(pos.m_curr), node);
+        return iterator{node};
+    }
+
+    void push_back(T &val) noexcept
+    {
+        link_before(&m_dummy, hook_of(val));
+    }
+
+    void push_front(T &val) noexcept
+    {
+        link_before(m_dummy.m_next, hook_of(val));
+    }
+
+    iterator erase(const_iterator pos) noexcept
+    {
+        ListNode *node = const_cast<ListNode *>(pos.m_curr);
+        ListNode *next = node->m_next;
+        static_cast<Hook *>(node)->unlink();
+        return iterator{next};
+    }
+
+    iterator erase(const_iterator first, const_iterator last) noexcept
+    {
+        while (first != last)
+        {
+            first = erase(first);
+        }
+        return iterator(first);
+    }
+
+    void pop_front() noexcept
+    {
+        erase(cbegin());
+    }
+
+    void pop_back() noexcept
+    {
+        erase(--cend());
+    }
+
+    void clear() noexcept
+    {
+        ListNode *cur = m_dummy.m_next;
+        while (cur != &m_dummy)
+        {
+            ListNode *next = cur->m_next;
+            cur->m_next = nullptr;
+            cur->m_prev = nullptr;
+            cur = next;
+        }
+        m_dummy.m_next = &m_dummy;
+        m_dummy.m_prev = &m_dummy;
+    }
+};
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cassert>
 #include <cstddef>
 #include <iterator>
 #include <memory>
@@ -8,6 +9,11 @@
 #include <utility>
 #include <compare>
 #include <initializer_list>
+#include <algorithm>
+#include <functional>
+#include <memory_resource>
+#include <optional>
+#include <type_traits>
 
 template <class T>
 struct ListBaseNode
@@ -52,11 +58,181 @@ struct List
 private:
     using ListNode = ListBaseNode<T>;
     using AllocNode = std::allocator_traits<Alloc>::template rebind_alloc<ListValueNode<T>>;
+    using AllocTraits = std::allocator_traits<Alloc>;
+    using AllocNodeTraits = std::allocator_traits<AllocNode>;
 
     ListNode m_dummy;
     size_t m_size;
     [[no_unique_address]] Alloc m_alloc;
 
+    template <class... Args>
+    ListNode *new_node(Args &&...args)
+    {
+        AllocNode alloc{m_alloc};
+        ListValueNode<T> *node = AllocNodeTraits::allocate(alloc, 1);
+        try
+        {
+            AllocNodeTraits::construct(alloc, &node->m_value, std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            AllocNodeTraits::deallocate(alloc, node, 1);
+            throw;
+        }
+        return node;
+    }
+
+    void delete_node(ListNode *node) noexcept
+    {
+        AllocNode alloc{m_alloc};
+        auto *value_node = static_cast<ListValueNode<T> *>(node);
+        AllocNodeTraits::destroy(alloc, &value_node->m_value);
+        AllocNodeTraits::deallocate(alloc, value_node, 1);
+    }
+
+    // deletes a null-terminated chain linked through m_next
+    void free_chain(ListNode *node) noexcept
+    {
+        while (node)
+        {
+            ListNode *next = node->m_next;
+            delete_node(node);
+            node = next;
+        }
+    }
+
+    // nodes built off to the side before being linked into the list in one step
+    struct Chain
+    {
+        ListNode m_head;
+        ListNode *m_tail = &m_head;
+        size_t m_count = 0;
+
+        void append(ListNode *node) noexcept
+        {
+            m_tail->m_next = node;
+            node->m_prev = m_tail;
+            m_tail = node;
+            ++m_count;
+        }
+    };
+
+    void discard(Chain &chain) noexcept
+    {
+        chain.m_tail->m_next = nullptr;
+        free_chain(chain.m_head.m_next);
+    }
+
+    // allocators that can lay out nodes contiguously (PoolAllocator) get told how many are coming
+    void reserve_nodes(size_t n)
+    {
+        AllocNode alloc{m_alloc};
+        if constexpr (requires { alloc.reserve(n); })
+        {
+            alloc.reserve(n);
+        }
+    }
+
+    // With a trivially destructible T nothing has to run per node, so clear() can skip the walk when
+    // the allocator is able to drop every node at once: a PoolAllocator whose pool holds only this
+    // list's nodes, or a monotonic arena whose deallocate is a no-op anyway.
+    bool release_nodes_in_bulk() noexcept
+    {
+        if constexpr (std::is_trivially_destructible_v<T>)
+        {
+            AllocNode alloc{m_alloc};
+            if constexpr (requires { alloc.try_release(m_size); })
+            {
+                return alloc.try_release(m_size);
+            }
+            else if constexpr (std::is_same_v<AllocNode, std::pmr::polymorphic_allocator<ListValueNode<T>>>)
+            {
+                return dynamic_cast<std::pmr::monotonic_buffer_resource *>(alloc.resource()) != nullptr;
+            }
+        }
+        return false;
+    }
+
+    // after the dummies of two lists were swapped, point the nodes back at their new owner
+    static void reseat_dummy(ListNode &dummy, ListNode &old_dummy) noexcept
+    {
+        if (dummy.m_next == &old_dummy)
+        {
+            dummy.m_next = dummy.m_prev = &dummy;
+        }
+        else
+        {
+            dummy.m_next->m_prev = &dummy;
+            dummy.m_prev->m_next = &dummy;
+        }
+    }
+
+    // moves [first, last) in front of pos, which must not lie inside the range
+    static void transfer(ListNode *pos, ListNode *first, ListNode *last) noexcept
+    {
+        ListNode *tail = last->m_prev;
+        first->m_prev->m_next = last;
+        last->m_prev = first->m_prev;
+
+        ListNode *before = pos->m_prev;
+        before->m_next = first;
+        first->m_prev = before;
+        tail->m_next = pos;
+        pos->m_prev = tail;
+    }
+
+    // Merges the sorted, null-terminated chain `b` into `a`, both linked through m_next only; ties
+    // keep `a` first. If comp throws, `a` still holds every node of both chains, unordered.
+    template <class Compare>
+    static void merge_chains(ListNode *&a, ListNode *&b, Compare &comp)
+    {
+        ListNode head;
+        ListNode *tail = &head;
+        ListNode *x = a, *y = b;
+        b = nullptr;
+        try
+        {
+            while (x && y)
+            {
+                if (comp(y->value(), x->value()))
+                {
+                    tail->m_next = y;
+                    y = y->m_next;
+                }
+                else
+                {
+                    tail->m_next = x;
+                    x = x->m_next;
+                }
+                tail = tail->m_next;
+            }
+        }
+        catch (...)
+        {
+            tail->m_next = x;
+            while (tail->m_next)
+            {
+                tail = tail->m_next;
+            }
+            tail->m_next = y;
+            a = head.m_next;
+            throw;
+        }
+        tail->m_next = x ? x : y;
+        a = head.m_next;
+    }
+
+    // links a null-terminated chain after `prev`, setting m_prev on the way
+    static void link_chain(ListNode *&prev, ListNode *node) noexcept
+    {
+        for (; node; node = node->m_next)
+        {
+            prev->m_next = node;
+            node->m_prev = prev;
+            prev = node;
+        }
+    }
+
 public:
     void init_move(List &&that)
     {
@@ -69,80 +245,131 @@ public:
         that.m_dummy.m_next = that.m_dummy.m_prev = &that.m_dummy;
         that.m_size = 0;
     }
+    // the init_move overloads fill a list that is still empty
     template <std::input_iterator InputIt>
     void init_move(InputIt first, InputIt last)
     {
-        m_size = 0;
-        ListNode *prev = &m_dummy;
-        while (first != last)
-        {
-            ListNode *node = AllocNode{m_alloc}.allocate(1);
-            prev->m_next = node;
-            node->m_prev = prev;
-            std::__construct_at(&node->value(), *first);
-            prev = node;
-            ++first;
-            ++m_size;
-        }
-        m_dummy.m_prev = prev;
-        prev->m_next = &m_dummy;
+        insert(cend(), first, last);
     }
     void init_move(size_t n)
     {
-        ListNode *prev = &m_dummy;
-        while (n)
+        reserve_nodes(n);
+        Chain chain;
+        try
         {
-            ListNode *node = AllocNode{m_alloc}.allocate(1);
-            prev->m_next = node;
-            node->m_prev = prev;
-            std::__construct_at(&node->value());
-            prev = node;
-            --n;
+            while (chain.m_count < n)
+            {
+                chain.append(new_node());
+            }
         }
-        m_dummy.m_prev = prev;
-        prev->m_next = &m_dummy;
-        m_size = n;
+        catch (...)
+        {
+            discard(chain);
+            throw;
+        }
+        link(cend(), chain);
     }
     void init_move(size_t n, T const &val)
     {
-        ListNode *prev = &m_dummy;
-        while (n)
-        {
-            ListNode *node = AllocNode{m_alloc}.allocate(1);
-            prev->m_next = node;
-            node->m_prev = prev;
-            std::__construct_at(&node->value(), val);
-            prev = node;
-            --n;
-        }
-        m_dummy.m_prev = prev;
-        prev->m_next = &m_dummy;
-        m_size = n;
+        insert(cend(), n, val);
     }
-    List()
+    List() : List(Alloc())
+    {
+    }
+    explicit List(Alloc const &alloc) noexcept : m_size(0), m_alloc(alloc)
     {
         m_dummy.m_next = &m_dummy;
         m_dummy.m_prev = &m_dummy;
-        m_size = 0;
     }
-    List(List &&that) noexcept : m_size(std::move(that.m_size)), m_alloc(std::move(that.m_alloc))
+    List(List &&that) noexcept : m_alloc(std::move(that.m_alloc))
     {
         init_move(std::move(that));
     }
 
-    List(List const &that) noexcept : m_size(std::move(that.m_size)), m_alloc(std::move(that.m_alloc))
+    // Allocator-extended move: nodes can only be taken over when `alloc` is able to free them,
+    // otherwise the values are moved into new nodes from `alloc`.
+    List(List &&that, Alloc const &alloc) : List(alloc)
     {
-        init_move(std::move(that));
+        if (AllocTraits::is_always_equal::value || m_alloc == that.m_alloc)
+        {
+            init_move(std::move(that));
+        }
+        else
+        {
+            init_move(std::make_move_iterator(that.begin()), std::make_move_iterator(that.end()));
+            that.clear();
+        }
     }
+
+    List(List const &that) : List(that, AllocTraits::select_on_container_copy_construction(that.m_alloc))
+    {
+    }
+
+    List(List const &that, Alloc const &alloc) : List(alloc)
+    {
+        init_move(that.cbegin(), that.cend());
+    }
+
     List &operator=(List const &that)
     {
+        if (this == &that)
+            return *this;
+        if constexpr (AllocTraits::propagate_on_container_copy_assignment::value)
+        {
+            if (m_alloc != that.m_alloc)
+            {
+                clear();
+            }
+            m_alloc = that.m_alloc;
+        }
         assign(that.cbegin(), that.cend());
         return *this;
     }
 
-    bool empty() noexcept
+    List &operator=(List &&that) noexcept(AllocTraits::propagate_on_container_move_assignment::value ||
+                                          AllocTraits::is_always_equal::value)
+    {
+        if (this == &that)
+            return *this;
+        clear();
+        if constexpr (!AllocTraits::propagate_on_container_move_assignment::value &&
+                      !AllocTraits::is_always_equal::value)
+        {
+            if (m_alloc != that.m_alloc)
+            {
+                init_move(std::make_move_iterator(that.begin()), std::make_move_iterator(that.end()));
+                that.clear();
+                return *this;
+            }
+        }
+        if constexpr (AllocTraits::propagate_on_container_move_assignment::value)
+        {
+            m_alloc = std::move(that.m_alloc);
+        }
+        init_move(std::move(that));
+        return *this;
+    }
+
+    void swap(List &that) noexcept
     {
-        return m_dummy.m_prev = m_dummy.m_next;
+        std::swap(m_dummy, that.m_dummy);
+        std::swap(m_size, that.m_size);
+        reseat_dummy(m_dummy, that.m_dummy);
+        reseat_dummy(that.m_dummy, m_dummy);
+        if constexpr (AllocTraits::propagate_on_container_swap::value)
+        {
+            std::swap(m_alloc, that.m_alloc);
+        }
+    }
+
+    Alloc get_allocator() const noexcept
+    {
+        return m_alloc;
+    }
+
+    bool empty() const noexcept
+    {
+        return m_size == 0;
     }
 
     T &front() noexcept
@@ -165,18 +392,18 @@ public:
         return m_dummy.m_prev->value();
     }
 
-    explicit List(size_t n, Alloc const &alloc = Alloc()) : m_alloc(alloc)
+    explicit List(size_t n, Alloc const &alloc = Alloc()) : List(alloc)
     {
         init_move(n);
     }
 
-    List(size_t n, T const &val, Alloc const &alloc = Alloc()) : m_alloc(alloc)
+    List(size_t n, T const &val, Alloc const &alloc = Alloc()) : List(alloc)
     {
         init_move(n, val);
     }
 
     template <std::input_iterator InputIt>
-    List(InputIt first, InputIt last, Alloc const &alloc = Alloc())
+    List(InputIt first, InputIt last, Alloc const &alloc = Alloc()) : List(alloc)
     {
         init_move(first, last);
     }
@@ -213,49 +440,36 @@ public:
         init_move(n, val);
     }
 
+    template <class... Args>
+    T &emplace_back(Args &&...args)
+    {
+        return *emplace(cend(), std::forward<Args>(args)...);
+    }
+
+    template <class... Args>
+    T &emplace_front(Args &&...args)
+    {
+        return *emplace(cbegin(), std::forward<Args>(args)...);
+    }
+
     void push_back(T const &val)
     {
-        ++m_size;
-        ListNode *node = AllocNode{m_alloc}.allocate(1);
-        node->m_prev = m_dummy.m_prev;
-        node->m_next = &m_dummy;
-        m_dummy.m_prev->m_next = node;
-        m_dummy.m_prev = node;
-        std::__construct_at(&node->value(), val);
+        emplace_back(val);
     }
 
     void push_back(T &&val)
     {
-        ++m_size;
-        ListNode *Node = AllocNode{m_alloc}.allocate(1);
-        Node->m_prev = m_dummy.m_prev;
-        Node->m_next = &m_dummy;
-        m_dummy.m_prev->m_next = Node;
-        m_dummy.m_prev = Node;
-        std::__construct_at(&Node->value(), std::move(val));
+        emplace_back(std::move(val));
     }
 
     void push_front(T const &val)
     {
-        ++m_size;
-        ListNode *node = AllocNode{m_alloc}.allocate(1);
-        m_dummy.m_next->m_prev = node;
-        node->m_next = m_dummy.m_next;
-        node->m_prev = &m_dummy;
-        m_dummy.m_next = node;
-        std::__construct_at(&node->value(), val);
+        emplace_front(val);
     }
 
     void push_front(T &&val)
     {
-        ++m_size;
-        auto node = AllocNode{m_alloc}.allocate(1);
-
-        m_dummy.m_next->m_prev = node;
-        node->m_next = m_dummy.m_next;
-        node->m_prev = &m_dummy;
-        m_dummy.m_next = node;
-        std::__construct_at(&node->value(), std::move(val));
+        emplace_front(std::move(val));
     }
 
     ~List()
@@ -265,13 +479,15 @@ public:
 
     void clear() noexcept
     {
-        ListNode *cur = m_dummy.m_next;
-        while (cur != &m_dummy)
+        if (m_size == 0 || !release_nodes_in_bulk())
         {
-            auto temp = cur->m_next;
-            std::destroy_at(&cur->value());
-            AllocNode{m_alloc}.deallocate(static_cast<ListValueNode<T> *>(cur), 1);
-            cur = temp;
+            ListNode *cur = m_dummy.m_next;
+            while (cur != &m_dummy)
+            {
+                auto temp = cur->m_next;
+                delete_node(cur);
+                cur = temp;
+            }
         }
         m_dummy.m_next = &m_dummy;
         m_dummy.m_prev = &m_dummy;
@@ -332,7 +548,7 @@ public:
             return !(*this == that);
         }
 
-        bool operator==(iterator const &that)
+        bool operator==(iterator const &that) const noexcept
         {
             return m_curr == that.m_curr;
         }
@@ -396,12 +612,12 @@ public:
             return m_curr->value();
         }
 
-        bool operator!=(const_iterator const &that)
+        bool operator!=(const_iterator const &that) const noexcept
         {
             return !(*this == that);
         }
 
-        bool operator==(const_iterator const &that)
+        bool operator==(const_iterator const &that) const noexcept
         {
             return m_curr == that.m_curr;
         }
@@ -477,9 +693,7 @@ public:
         auto next = noConstNode->m_next;
         noConstNode->m_next->m_prev = noConstNode->m_prev;
         noConstNode->m_prev->m_next = noConstNode->m_next;
-        std::destroy_at(&noConstNode->value());
-
-        AllocNode{m_alloc}.deallocate(static_cast<ListValueNode<T> *>(noConstNode), 1);
+        delete_node(noConstNode);
         --m_size;
         return iterator{next};
     }
@@ -503,90 +717,444 @@ public:
         erase(this->rbegin());
     }
 
-    iterator insert(const_iterator pos, const T &val)
+    template <class... Args>
+    iterator emplace(const_iterator pos, Args &&...args)
     {
-        ++m_size;
-        ListNode *curr = AllocNode{m_alloc}.allocate(1);
+        ListNode *curr = new_node(std::forward<Args>(args)...);
         auto *next = const_cast<ListNode *>(pos.m_curr);
 
         curr->m_prev = next->m_prev;
         next->m_prev->m_next = curr;
         curr->m_next = next;
         next->m_prev = curr;
-
-        std::construct_at(&curr->value(), val);
+        ++m_size;
         return iterator{curr};
     }
 
-    iterator insert(const_iterator pos, T &&val)
+    // Owns one node taken out of a List by extract(), together with the allocator that made it, so
+    // the element can move to another List sharing that allocator without allocating or copying T.
+    struct node_type
+    {
+        using value_type = T;
+        using allocator_type = Alloc;
+
+    private:
+        ListNode *m_node = nullptr;
+        std::optional<Alloc> m_alloc;
+
+        friend List;
+
+        node_type(ListNode *node, Alloc const &alloc) noexcept : m_node(node), m_alloc(alloc)
+        {
+        }
+
+        ListNode *release() noexcept
+        {
+            m_alloc.reset();
+            return std::exchange(m_node, nullptr);
+        }
+
+    public:
+        node_type() noexcept = default;
+
+        node_type(node_type &&that) noexcept : m_node(std::exchange(that.m_node, nullptr)), m_alloc(that.m_alloc)
+        {
+            that.m_alloc.reset();
+        }
+
+        node_type &operator=(node_type &&that) noexcept
+        {
+            node_type tmp(std::move(that));
+            swap(tmp);
+            return *this;
+        }
+
+        ~node_type()
+        {
+            if (m_node)
+            {
+                AllocNode alloc{*m_alloc};
+                auto *value_node = static_cast<ListValueNode<T> *>(m_node);
+                AllocNodeTraits::destroy(alloc, &value_node->m_value);
+                AllocNodeTraits::deallocate(alloc, value_node, 1);
+            }
+        }
+
+        void swap(node_type &that) noexcept
+        {
+            std::swap(m_node, that.m_node);
+            std::swap(m_alloc, that.m_alloc);
+        }
+
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return m_node == nullptr;
+        }
+
+        explicit operator bool() const noexcept
+        {
+            return m_node != nullptr;
+        }
+
+        T &value() const noexcept
+        {
+            return m_node->value();
+        }
+
+        Alloc get_allocator() const
+        {
+            return *m_alloc;
+        }
+    };
+
+    node_type extract(const_iterator pos) noexcept
+    {
+        auto *node = const_cast<ListNode *>(pos.m_curr);
+        node->m_next->m_prev = node->m_prev;
+        node->m_prev->m_next = node->m_next;
+        --m_size;
+        return node_type{node, m_alloc};
+    }
+
+    // Links the handle's node in front of pos; the node must come from an allocator equal to ours.
+    // An empty handle inserts nothing and returns pos.
+    iterator insert(const_iterator pos, node_type &&nh) noexcept
     {
-        ++m_size;
-        ListNode *curr = AllocNode{m_alloc}.allocate(1);
         auto *next = const_cast<ListNode *>(pos.m_curr);
+        if (nh.empty())
+            return iterator{next};
+        assert(*nh.m_alloc == m_alloc && "node handle comes from an incompatible allocator");
+        ListNode *node = nh.release();
+        node->m_prev = next->m_prev;
+        node->m_next = next;
+        next->m_prev->m_next = node;
+        next->m_prev = node;
+        ++m_size;
+        return iterator{node};
+    }
 
-        curr->m_prev = next->m_prev;
-        next->m_prev->m_next = curr;
-        curr->m_next = next;
-        next->m_prev = curr;
+    iterator insert(const_iterator pos, const T &val)
+    {
+        return emplace(pos, val);
+    }
 
-        std::construct_at(&curr->value(), std::move(val));
-        return iterator{curr};
+    iterator insert(const_iterator pos, T &&val)
+    {
+        return emplace(pos, std::move(val));
     }
 
+private:
+    iterator link(const_iterator pos, Chain &chain) noexcept
+    {
+        auto *next = const_cast<ListNode *>(pos.m_curr);
+        if (chain.m_count == 0)
+            return iterator{next};
+        ListNode *first = chain.m_head.m_next;
+        first->m_prev = next->m_prev;
+        chain.m_tail->m_next = next;
+        next->m_prev->m_next = first;
+        next->m_prev = chain.m_tail;
+        m_size += chain.m_count;
+        return iterator{first};
+    }
+
+public:
+    // The bulk inserts build the whole chain off to the side, so a throwing constructor leaves the
+    // list untouched, then link it in at once.
     iterator insert(const_iterator pos, size_t n, T const &val)
     {
+        reserve_nodes(n);
+        Chain chain;
+        try
+        {
+            while (chain.m_count < n)
+            {
+                chain.append(new_node(val));
+            }
+        }
+        catch (...)
+        {
+            discard(chain);
+            throw;
+        }
+        return link(pos, chain);
+    }
+
+    template <std::input_iterator InputIt>
+    iterator insert(const_iterator pos, InputIt first, InputIt last)
+    {
+        if constexpr (std::forward_iterator<InputIt>)
+        {
+            reserve_nodes(std::distance(first, last));
+        }
+        Chain chain;
+        try
+        {
+            for (; first != last; ++first)
+            {
+                chain.append(new_node(*first));
+            }
+        }
+        catch (...)
+        {
+            discard(chain);
+            throw;
+        }
+        return link(pos, chain);
+    }
+
+    iterator insert(const_iterator pos, std::initializer_list<T> ilist)
+    {
+        return insert(pos, ilist.begin(), ilist.end());
+    }
+
+    void splice(const_iterator pos, List &other) noexcept
+    {
+        if (other.m_size == 0)
+            return;
+        transfer(const_cast<ListNode *>(pos.m_curr), other.m_dummy.m_next, &other.m_dummy);
+        m_size += other.m_size;
+        other.m_size = 0;
+    }
+
+    void splice(const_iterator pos, List &&other) noexcept
+    {
+        splice(pos, other);
+    }
+
+    void splice(const_iterator pos, List &other, const_iterator it) noexcept
+    {
+        auto *node = const_cast<ListNode *>(it.m_curr);
+        auto *next = const_cast<ListNode *>(pos.m_curr);
+        if (node == next || node->m_next == next)
+            return;
+        transfer(next, node, node->m_next);
+        --other.m_size;
+        ++m_size;
+    }
+
+    void splice(const_iterator pos, List &&other, const_iterator it) noexcept
+    {
+        splice(pos, other, it);
+    }
+
+    // O(1) within one list; between lists the range has to be counted to keep both sizes right
+    void splice(const_iterator pos, List &other, const_iterator first, const_iterator last) noexcept
+    {
+        if (first == last)
+            return;
+        if (&other != this)
+        {
+            size_t n = std::distance(first, last);
+            other.m_size -= n;
+            m_size += n;
+        }
+        transfer(const_cast<ListNode *>(pos.m_curr), const_cast<ListNode *>(first.m_curr),
+                 const_cast<ListNode *>(last.m_curr));
+    }
+
+    void splice(const_iterator pos, List &&other, const_iterator first, const_iterator last) noexcept
+    {
+        splice(pos, other, first, last);
+    }
+
+    // O(1) between lists too, for callers that already know the range holds n elements
+    void splice(const_iterator pos, List &other, const_iterator first, const_iterator last, size_t n) noexcept
+    {
+        if (first == last)
+            return;
+        other.m_size -= n;
         m_size += n;
-        auto result = pos;
-        bool isFirstInsert = true;
+        transfer(const_cast<ListNode *>(pos.m_curr), const_cast<ListNode *>(first.m_curr),
+                 const_cast<ListNode *>(last.m_curr));
+    }
 
-        while (n)
+    // Moves every element of other for which pred holds in front of pos, keeping their order.
+    // Nodes are relinked, never reallocated; runs of matches move as one range. Returns the count.
+    template <class Predicate>
+    size_t splice_if(const_iterator pos, List &other, Predicate pred)
+    {
+        if (&other == this)
+            return 0;
+        auto *next = const_cast<ListNode *>(pos.m_curr);
+        size_t moved = 0;
+        ListNode *cur = other.m_dummy.m_next;
+        while (cur != &other.m_dummy)
         {
-            if (isFirstInsert)
+            if (!pred(cur->value()))
             {
-                result = insert(pos, val);
-                ++pos;
-                isFirstInsert = false;
-                ++m_size;
-                --n;
+                cur = cur->m_next;
                 continue;
             }
-            --n;
-            ++m_size;
-            insert(pos, val);
-            ++pos;
+            ListNode *first = cur;
+            size_t n = 0;
+            do
+            {
+                cur = cur->m_next;
+                ++n;
+            } while (cur != &other.m_dummy && pred(cur->value()));
+            transfer(next, first, cur);
+            moved += n;
+        }
+        other.m_size -= moved;
+        m_size += moved;
+        return moved;
+    }
+
+    // Stable: of equivalent elements, the ones already in this list come first. If comp throws,
+    // the elements moved so far stay in this list.
+    template <class Compare>
+    void merge(List &other, Compare comp)
+    {
+        if (&other == this)
+            return;
+        ListNode *a = m_dummy.m_next;
+        ListNode *b = other.m_dummy.m_next;
+        while (a != &m_dummy && b != &other.m_dummy)
+        {
+            if (comp(b->value(), a->value()))
+            {
+                ListNode *next = b->m_next;
+                transfer(a, b, next);
+                b = next;
+                ++m_size;
+                --other.m_size;
+            }
+            else
+            {
+                a = a->m_next;
+            }
         }
+        if (b != &other.m_dummy)
+        {
+            transfer(&m_dummy, b, &other.m_dummy);
+        }
+        m_size += other.m_size;
+        other.m_size = 0;
+    }
 
-        return iterator{result};
+    template <class Compare>
+    void merge(List &&other, Compare comp)
+    {
+        merge(other, comp);
     }
 
-    template <std::input_iterator InputIt>
-    iterator insert(const_iterator pos, InputIt first, InputIt last)
+    void merge(List &other)
     {
-        auto result = pos;
-        bool isFirstInsert = true;
+        merge(other, std::less<>());
+    }
 
-        while (first != last)
+    void merge(List &&other)
+    {
+        merge(other, std::less<>());
+    }
+
+    // Stable bottom-up merge sort that only relinks nodes: runs of 2^i nodes are kept in
+    // pending[i] as null-terminated chains and m_prev is rebuilt in one pass at the end.
+    // If comp throws, every node is linked back in some unspecified order.
+    template <class Compare>
+    void sort(Compare comp)
+    {
+        if (m_size < 2)
+            return;
+        ListNode *pending[64] = {};
+        ListNode *run = nullptr;
+        ListNode *sorted = nullptr;
+        m_dummy.m_prev->m_next = nullptr;
+        ListNode *cur = m_dummy.m_next;
+        ListNode *prev = &m_dummy;
+        try
         {
-            if (isFirstInsert)
+            while (cur)
             {
-                result = insert(pos, *first);
-                ++pos;
-                ++first;
-                isFirstInsert = false;
-                ++m_size;
-                continue;
+                run = cur;
+                cur = cur->m_next;
+                run->m_next = nullptr;
+                size_t i = 0;
+                for (; pending[i]; ++i)
+                {
+                    merge_chains(pending[i], run, comp);
+                    run = pending[i];
+                    pending[i] = nullptr;
+                }
+                pending[i] = run;
+                run = nullptr;
+            }
+
+            for (ListNode *&chain : pending)
+            {
+                if (chain)
+                {
+                    merge_chains(chain, sorted, comp);
+                    sorted = chain;
+                    chain = nullptr;
+                }
             }
-            ++m_size;
-            insert(pos, *first);
-            ++pos;
-            ++first;
         }
-        return iterator{result};
+        catch (...)
+        {
+            link_chain(prev, cur);
+            link_chain(prev, run);
+            link_chain(prev, sorted);
+            for (ListNode *chain : pending)
+            {
+                link_chain(prev, chain);
+            }
+            prev->m_next = &m_dummy;
+            m_dummy.m_prev = prev;
+            throw;
+        }
+
+        link_chain(prev, sorted);
+        prev->m_next = &m_dummy;
+        m_dummy.m_prev = prev;
     }
 
-    iterator insert(const_iterator pos, std::initializer_list<T> ilist)
+    void sort()
     {
-        return insert(pos, ilist.begin(), ilist.end());
+        sort(std::less<>());
+    }
+
+    // Moves every element into a freshly allocated node, in iteration order, and frees the old
+    // nodes afterwards, so traversal touches memory sequentially again. Invalidates iterators and
+    // references.
+    void defragment()
+    {
+        defragment(cbegin(), m_size);
+    }
+
+    // Incremental form: relocates at most n nodes starting at pos and returns the first node not
+    // yet relocated, which the next call can continue from.
+    iterator defragment(const_iterator pos, size_t n)
+    {
+        auto *cur = const_cast<ListNode *>(pos.m_curr);
+        reserve_nodes(std::min(n, m_size));
+        ListNode *garbage = nullptr;
+        try
+        {
+            while (n && cur != &m_dummy)
+            {
+                ListNode *node = new_node(std::move(cur->value()));
+                ListNode *next = cur->m_next;
+                node->m_prev = cur->m_prev;
+                node->m_next = next;
+                cur->m_prev->m_next = node;
+                next->m_prev = node;
+
+                // old nodes are freed only at the end so the allocator cannot hand them back out
+                cur->m_next = garbage;
+                garbage = cur;
+                cur = next;
+                --n;
+            }
+        }
+        catch (...)
+        {
+            free_chain(garbage);
+            throw;
+        }
+        free_chain(garbage);
+        return iterator{cur};
     }
 
     bool operator==(List const &that) const noexcept
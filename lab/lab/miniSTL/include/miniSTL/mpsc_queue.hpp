@@ -0,0 +1,196 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <miniSTL/list.hpp>
+
+// Multi-producer single-consumer FIFO after Dmitry Vyukov's intrusive queue, threading
+// ListValueNode<T>s through their m_next links. Any number of threads may push: linking a node is
+// one exchange and one store, so it is wait-free. Only one thread may pop or drain; that side is
+// lock-free, but an element whose producer was preempted between those two steps stays invisible
+// until the producer resumes, and the queue looks empty for that moment.
+//
+// Nodes are allocated on the producer threads and freed on the consumer, so Alloc must be safe to
+// use from several threads at once, e.g. std::allocator or a polymorphic_allocator over a
+// std::pmr::synchronized_pool_resource. A NodePool is single-threaded and cannot serve this queue.
+template <class T, class Alloc = std::allocator<T>>
+struct MpscQueue
+{
+    using value_type = T;
+    using allocator_type = Alloc;
+    using size_type = size_t;
+
+private:
+    using ListNode = ListBaseNode<T>;
+    using AllocNode = std::allocator_traits<Alloc>::template rebind_alloc<ListValueNode<T>>;
+    using AllocNodeTraits = std::allocator_traits<AllocNode>;
+    using NextRef = std::atomic_ref<ListNode *>;
+
+    static_assert(NextRef::required_alignment <= alignof(ListNode *), "ListBaseNode links cannot be used atomically");
+
+    alignas(64) std::atomic<ListNode *> m_head;
+    alignas(64) ListNode *m_tail;
+    ListNode m_stub;
+    [[no_unique_address]] Alloc m_alloc;
+
+    static ListNode *next_of(ListNode *node) noexcept
+    {
+        return NextRef(node->m_next).load(std::memory_order_acquire);
+    }
+
+    template <class... Args>
+    ListNode *new_node(Args &&...args)
+    {
+        AllocNode alloc{m_alloc};
+        ListValueNode<T> *node = AllocNodeTraits::allocate(alloc, 1);
+        try
+        {
+            AllocNodeTraits::construct(alloc, &node->m_value, std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            AllocNodeTraits::deallocate(alloc, node, 1);
+            throw;
+        }
+        return node;
+    }
+
+    void delete_node(ListNode *node) noexcept
+    {
+        AllocNode alloc{m_alloc};
+        auto *value_node = static_cast<ListValueNode<T> *>(node);
+        AllocNodeTraits::destroy(alloc, &value_node->m_value);
+        AllocNodeTraits::deallocate(alloc, value_node, 1);
+    }
+
+    void link(ListNode *node) noexcept
+    {
+        NextRef(node->m_next).store(nullptr, std::memory_order_relaxed);
+        ListNode *prev = m_head.exchange(node, std::memory_order_acq_rel);
+        NextRef(prev->m_next).store(node, std::memory_order_release);
+    }
+
+    // Unlinks the oldest element's node, or returns null if none is visible yet. The stub node
+    // keeps the queue non-empty for producers; it is skipped here and pushed again whenever the
+    // consumer is about to take the last real node.
+    ListNode *unlink() noexcept
+    {
+        ListNode *tail = m_tail;
+        ListNode *next = next_of(tail);
+        if (tail == &m_stub)
+        {
+            if (!next)
+                return nullptr;
+            m_tail = next;
+            tail = next;
+            next = next_of(next);
+        }
+        if (next)
+        {
+            m_tail = next;
+            return tail;
+        }
+        if (tail != m_head.load(std::memory_order_acquire))
+            return nullptr;
+        link(&m_stub);
+        next = next_of(tail);
+        if (next)
+        {
+            m_tail = next;
+            return tail;
+        }
+        return nullptr;
+    }
+
+public:
+    MpscQueue() : MpscQueue(Alloc())
+    {
+    }
+
+    explicit MpscQueue(Alloc const &alloc) noexcept : m_head(&m_stub), m_tail(&m_stub), m_alloc(alloc)
+    {
+        m_stub.m_next = nullptr;
+        m_stub.m_prev = nullptr;
+    }
+
+    MpscQueue(MpscQueue const &) = delete;
+    MpscQueue &operator=(MpscQueue const &) = delete;
+
+    // no producer or consumer may still be using the queue
+    ~MpscQueue()
+    {
+        while (ListNode *node = unlink())
+        {
+            delete_node(node);
+        }
+    }
+
+    Alloc get_allocator() const noexcept
+    {
+        return m_alloc;
+    }
+
+    template <class... Args>
+    void emplace(Args &&...args)
+    {
+        link(new_node(std::forward<Args>(args)...));
+    }
+
+    void push(T const &val)
+    {
+        emplace(val);
+    }
+
+    void push(T &&val)
+    {
+        emplace(std::move(val));
+    }
+
+    // consumer only
+    std::optional<T> try_pop()
+    {
+        ListNode *node = unlink();
+        if (!node)
+            return std::nullopt;
+        std::optional<T> ret{std::move(node->value())};
+        delete_node(node);
+        return ret;
+    }
+
+    // Consumer only: hands up to max elements, oldest first, to f(T &&) and returns how many.
+    template <class F>
+    size_t drain(F f, size_t max = std::numeric_limits<size_t>::max())
+    {
+        size_t n = 0;
+        while (n < max)
+        {
+            ListNode *node = unlink();
+            if (!node)
+                break;
+            try
+            {
+                f(std::move(node->value()));
+            }
+            catch (...)
+            {
+                delete_node(node);
+                throw;
+            }
+            delete_node(node);
+            ++n;
+        }
+        return n;
+    }
+
+    // consumer only; an element still being linked by a producer does not count yet
+    [[nodiscard]] bool empty() const noexcept
+    {
+        ListNode *tail = m_tail;
+        ListNode *next = next_of(tail);
+        return tail == &m_stub && next == nullptr;
+    }
+};
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+// Hands out fixed-size slots carved from large blocks. Freed slots go onto an intrusive free list
+// and are reused before a new block is requested; the blocks themselves are only returned all at
+// once, by release() or the destructor. The unused tail of the current block is carved before the
+// free list, so after reserve(n) the next n slots are contiguous. Not thread-safe.
+struct NodePool
+{
+private:
+    struct FreeSlot
+    {
+        FreeSlot *m_next;
+    };
+
+    struct Block
+    {
+        Block *m_next;
+        size_t m_bytes;
+    };
+
+    size_t m_slot_size;
+    size_t m_slot_align;
+    size_t m_slots_per_block;
+    size_t m_header_size;
+    Block *m_blocks;
+    FreeSlot *m_free;
+    std::byte *m_carve;
+    std::byte *m_carve_end;
+    size_t m_block_count;
+    size_t m_live;
+
+    static size_t round_up(size_t n, size_t align) noexcept
+    {
+        return (n + align - 1) / align * align;
+    }
+
+    std::align_val_t block_align() const noexcept
+    {
+        return std::align_val_t{std::max(m_slot_align, alignof(Block))};
+    }
+
+    void grow(size_t slots)
+    {
+        // whatever is left of the current block would be lost, so hand it to the free list
+        while (m_carve != m_carve_end)
+        {
+            m_free = ::new (m_carve) FreeSlot{m_free};
+            m_carve += m_slot_size;
+        }
+        size_t bytes = m_header_size + m_slot_size * slots;
+        auto *raw = static_cast<std::byte *>(::operator new(bytes, block_align()));
+        auto *block = ::new (raw) Block{m_blocks, bytes};
+        m_blocks = block;
+        m_carve = raw + m_header_size;
+        m_carve_end = m_carve + m_slot_size * slots;
+        ++m_block_count;
+    }
+
+public:
+    explicit NodePool(size_t slot_size, size_t slot_align = alignof(std::max_align_t), size_t slots_per_block = 256)
+        : m_slot_align(std::max(slot_align, alignof(FreeSlot))),
+          m_slots_per_block(slots_per_block ? slots_per_block : 1),
+          m_blocks(nullptr), m_free(nullptr), m_carve(nullptr), m_carve_end(nullptr), m_block_count(0),
+          m_live(0)
+    {
+        m_slot_size = round_up(std::max(slot_size, sizeof(FreeSlot)), m_slot_align);
+        m_header_size = round_up(sizeof(Block), m_slot_align);
+    }
+
+    NodePool(NodePool const &) = delete;
+    NodePool &operator=(NodePool const &) = delete;
+
+    ~NodePool()
+    {
+        release();
+    }
+
+    [[nodiscard]] bool fits(size_t size, size_t align) const noexcept
+    {
+        return size <= m_slot_size && align <= m_slot_align;
+    }
+
+    [[nodiscard]] void *allocate()
+    {
+        if (m_carve == m_carve_end)
+        {
+            if (m_free)
+            {
+                FreeSlot *slot = m_free;
+                m_free = slot->m_next;
+                ++m_live;
+                return slot;
+            }
+            grow(m_slots_per_block);
+        }
+        void *slot = m_carve;
+        m_carve += m_slot_size;
+        ++m_live;
+        return slot;
+    }
+
+    // Makes the next n allocations come from one contiguous run, allocating at most one block.
+    void reserve(size_t n)
+    {
+        if (static_cast<size_t>(m_carve_end - m_carve) >= n * m_slot_size)
+            return;
+        grow(std::max(n, m_slots_per_block));
+    }
+
+    void deallocate(void *p) noexcept
+    {
+        --m_live;
+        m_free = ::new (p) FreeSlot{m_free};
+    }
+
+    // Returns every block at once. Objects still living in the pool are not destroyed.
+    void release() noexcept
+    {
+        while (m_blocks)
+        {
+            Block *next = m_blocks->m_next;
+            ::operator delete(static_cast<void *>(m_blocks), m_blocks->m_bytes, block_align());
+            m_blocks = next;
+        }
+        m_free = nullptr;
+        m_carve = m_carve_end = nullptr;
+        m_block_count = 0;
+        m_live = 0;
+    }
+
+    // Releases every block if exactly n slots are in use, i.e. when the caller holds all of them
+    // and can drop them without returning each one.
+    bool try_release(size_t n) noexcept
+    {
+        if (m_live != n)
+            return false;
+        release();
+        return true;
+    }
+
+    [[nodiscard]] size_t live_count() const noexcept
+    {
+        return m_live;
+    }
+
+    [[nodiscard]] size_t slot_size() const noexcept
+    {
+        return m_slot_size;
+    }
+
+    [[nodiscard]] size_t block_count() const noexcept
+    {
+        return m_block_count;
+    }
+};
+
+// Allocator that serves single-object requests which fit a NodePool slot from that pool and
+// everything else from std::allocator. Rebound copies share the pool, so a List<T, PoolAllocator<T>>
+// draws its ListValueNode<T>s from it, and any number of lists may share one pool.
+template <class T>
+struct PoolAllocator
+{
+    using value_type = T;
+
+    NodePool *m_pool;
+
+    PoolAllocator(NodePool *pool) noexcept : m_pool(pool)
+    {
+    }
+
+    template <class U>
+    PoolAllocator(PoolAllocator<U> const &that) noexcept : m_pool(that.m_pool)
+    {
+    }
+
+    [[nodiscard]] T *allocate(size_t n)
+    {
+        if (n == 1 && m_pool->fits(sizeof(T), alignof(T)))
+        {
+            return static_cast<T *>(m_pool->allocate());
+        }
+        return std::allocator<T>{}.allocate(n);
+    }
+
+    void deallocate(T *p, size_t n) noexcept
+    {
+        if (n == 1 && m_pool->fits(sizeof(T), alignof(T)))
+        {
+            m_pool->deallocate(p);
+            return;
+        }
+        std::allocator<T>{}.deallocate(p, n);
+    }
+
+    // lets containers ask for their next n nodes to be laid out contiguously
+    void reserve(size_t n)
+    {
+        if (m_pool->fits(sizeof(T), alignof(T)))
+        {
+            m_pool->reserve(n);
+        }
+    }
+
+    // drops n objects of type T at once if they are the only ones alive in the pool
+    bool try_release(size_t n) noexcept
+    {
+        return m_pool->fits(sizeof(T), alignof(T)) && m_pool->try_release(n);
+    }
+
+    template <class U>
+    bool operator==(PoolAllocator<U> const &that) const noexcept
+    {
+        return m_pool == that.m_pool;
+    }
+};
@@ -0,0 +1,549 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <miniSTL/hash.hpp>
+#include <miniSTL/hash_table.hpp>
+#include <miniSTL/vector.hpp>
+
+// Read-only map over a key set fixed at construction, indexed by a minimal perfect hash function:
+// the n keys map to the positions 0..n-1 without collisions, and the keys and values are stored in
+// that order. A lookup computes the position from the key, reads the one key there to verify it and
+// returns the value next to it; there is no probing and no empty slot.
+//
+// The function follows CHD and PTHash. Keys are split into partitions of about partition_size
+// keys, each with its own range of positions, so the partitions are built in parallel. Within a
+// partition keys fall into buckets of about bucket_size keys; the largest buckets go first, and
+// each gets the first pilot value that sends all its keys to free positions. Beside the keys and
+// values the map keeps one 32-bit pilot per bucket and two offsets per partition.
+//
+// For trivially copyable K and V, serialize() writes the whole map as one flat image that
+// from_image() can use in place, e.g. straight from a memory-mapped file, without copying.
+template <class K, class V, class Hash = FastHash<K>, class Eq = std::equal_to<K>>
+struct PerfectHashMap
+{
+    using key_type = K;
+    using mapped_type = V;
+    using hasher = Hash;
+    using key_equal = Eq;
+    using size_type = size_t;
+
+    static constexpr size_t partition_size = 1 << 14;
+    static constexpr size_t bucket_size = 4;
+
+private:
+    struct Header
+    {
+        uint64_t m_magic;
+        uint32_t m_version;
+        uint32_t m_key_size;
+        uint32_t m_value_size;
+        uint32_t m_reserved;
+        uint64_t m_size;
+        uint64_t m_partition_count;
+        uint64_t m_bucket_count;
+        uint64_t m_seed;
+    };
+
+    static constexpr uint64_t image_magic = 0x50484d6150535432ull;
+    static constexpr uint32_t image_version = 1;
+
+    // where an entry of the input sits while its partition is being built
+    struct Entry
+    {
+        uint64_t m_hash;
+        size_t m_index;
+        size_t m_bucket;
+    };
+
+    size_t m_size;
+    size_t m_partition_count;
+    size_t m_bucket_count;
+    uint64_t m_seed;
+    uint64_t const *m_key_offsets;
+    uint64_t const *m_bucket_offsets;
+    uint32_t const *m_pilots;
+    K const *m_keys;
+    V const *m_values;
+    [[no_unique_address]] Hash m_hash;
+    [[no_unique_address]] Eq m_eq;
+
+    // owned storage of a built map; a map from an image leaves these empty
+    Vector<uint64_t> m_own_key_offsets;
+    Vector<uint64_t> m_own_bucket_offsets;
+    Vector<uint32_t> m_own_pilots;
+    Vector<K> m_own_keys;
+    Vector<V> m_own_values;
+
+    static uint64_t mix(uint64_t x) noexcept
+    {
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdull;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53ull;
+        x ^= x >> 33;
+        return x;
+    }
+
+    // maps a 32-bit value evenly onto 0..n-1 with a multiply instead of a division
+    static size_t reduce(uint32_t x, size_t n) noexcept
+    {
+        return static_cast<size_t>((static_cast<uint64_t>(x) * n) >> 32);
+    }
+
+    static size_t position(uint64_t hash, uint32_t pilot, size_t n) noexcept
+    {
+        return reduce(static_cast<uint32_t>(mix(hash ^ (pilot * 0x9e3779b97f4a7c15ull)) >> 32), n);
+    }
+
+    template <class Key>
+    uint64_t hash_of(Key const &key) const
+    {
+        return mix(static_cast<uint64_t>(m_hash(key)) ^ m_seed);
+    }
+
+    size_t partition_of(uint64_t hash) const noexcept
+    {
+        return reduce(static_cast<uint32_t>(hash >> 32), m_partition_count);
+    }
+
+    static size_t align_up(size_t n, size_t align) noexcept
+    {
+        return (n + align - 1) / align * align;
+    }
+
+    // Finds a pilot for every bucket of partition p, whose entries are given, and records for each
+    // of its positions the input index of the key placed there.
+    void build_partition(size_t p, std::span<Entry> entries, Vector<size_t> &index_at)
+    {
+        size_t first_key = m_own_key_offsets[p];
+        size_t first_bucket = m_own_bucket_offsets[p];
+        size_t n = entries.size();
+        size_t buckets = m_own_bucket_offsets[p + 1] - first_bucket;
+        if (n == 0)
+            return;
+
+        // group entries by bucket, largest buckets first
+        Vector<size_t> bucket_len(buckets);
+        for (Entry &entry : entries)
+        {
+            entry.m_bucket = reduce(static_cast<uint32_t>(entry.m_hash), buckets);
+            ++bucket_len[entry.m_bucket];
+        }
+        std::sort(entries.begin(), entries.end(), [&](Entry const &a, Entry const &b) {
+            if (bucket_len[a.m_bucket] != bucket_len[b.m_bucket])
+                return bucket_len[a.m_bucket] > bucket_len[b.m_bucket];
+            if (a.m_bucket != b.m_bucket)
+                return a.m_bucket < b.m_bucket;
+            return a.m_hash < b.m_hash;
+        });
+
+        Vector<uint64_t> taken((n + 63) / 64);
+        Vector<size_t> placed;
+        for (size_t i = 0; i < n;)
+        {
+            size_t len = bucket_len[entries[i].m_bucket];
+            std::span<Entry> bucket = entries.subspan(i, len);
+            for (size_t j = 1; j < len; j++)
+            {
+                if (bucket[j].m_hash == bucket[j - 1].m_hash)
+                    throw std::invalid_argument("PerfectHashMap: duplicate keys or keys with equal hashes");
+            }
+            for (uint32_t pilot = 0;; pilot++)
+            {
+                if (pilot == std::numeric_limits<uint32_t>::max())
+                    throw std::runtime_error("PerfectHashMap: no pilot found for a bucket");
+                placed.clear();
+                bool fits = true;
+                for (Entry const &entry : bucket)
+                {
+                    size_t pos = position(entry.m_hash, pilot, n);
+                    if ((taken[pos / 64] >> (pos % 64) & 1) ||
+                        std::find(placed.begin(), placed.end(), pos) != placed.end())
+                    {
+                        fits = false;
+                        break;
+                    }
+                    placed.push_back(pos);
+                }
+                if (!fits)
+                    continue;
+                for (size_t j = 0; j < len; j++)
+                {
+                    taken[placed[j] / 64] |= uint64_t(1) << (placed[j] % 64);
+                    index_at[first_key + placed[j]] = bucket[j].m_index;
+                }
+                m_own_pilots[first_bucket + bucket[0].m_bucket] = pilot;
+                break;
+            }
+            i += len;
+        }
+    }
+
+    void build(Vector<K> &keys, Vector<V> &values, unsigned threads)
+    {
+        m_size = keys.size();
+        m_partition_count = std::max<size_t>(1, (m_size + partition_size - 1) / partition_size);
+
+        Vector<Entry> entries;
+        entries.reserve(m_size);
+        for (size_t i = 0; i < m_size; i++)
+        {
+            entries.push_back(Entry{hash_of(keys[i]), i, 0});
+        }
+
+        // counting sort by partition; each partition gets about one bucket per bucket_size keys
+        m_own_key_offsets = Vector<uint64_t>(m_partition_count + 1);
+        for (Entry const &entry : entries)
+        {
+            ++m_own_key_offsets[partition_of(entry.m_hash) + 1];
+        }
+        m_own_bucket_offsets = Vector<uint64_t>(m_partition_count + 1);
+        for (size_t p = 0; p < m_partition_count; p++)
+        {
+            size_t n = m_own_key_offsets[p + 1];
+            m_own_bucket_offsets[p + 1] = m_own_bucket_offsets[p] + (n + bucket_size - 1) / bucket_size;
+            m_own_key_offsets[p + 1] += m_own_key_offsets[p];
+        }
+        m_bucket_count = m_own_bucket_offsets[m_partition_count];
+        Vector<Entry> grouped(entries.size());
+        Vector<uint64_t> next(m_own_key_offsets.begin(), m_own_key_offsets.end() - 1);
+        for (Entry const &entry : entries)
+        {
+            grouped[next[partition_of(entry.m_hash)]++] = entry;
+        }
+
+        m_own_pilots = Vector<uint32_t>(m_bucket_count);
+        Vector<size_t> index_at(m_size);
+        auto partition_entries = [&](size_t p) {
+            return std::span<Entry>(grouped.data() + m_own_key_offsets[p], m_own_key_offsets[p + 1] - m_own_key_offsets[p]);
+        };
+        if (threads == 0)
+        {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        threads = static_cast<unsigned>(std::min<size_t>(threads, m_partition_count));
+        if (threads <= 1)
+        {
+            for (size_t p = 0; p < m_partition_count; p++)
+            {
+                build_partition(p, partition_entries(p), index_at);
+            }
+        }
+        else
+        {
+            // partitions write disjoint ranges of index_at and m_own_pilots
+            std::atomic<size_t> next_partition{0};
+            std::exception_ptr error;
+            std::mutex error_mutex;
+            Vector<std::thread> workers;
+            workers.reserve(threads);
+            for (unsigned t = 0; t < threads; t++)
+            {
+                workers.emplace_back([&] {
+                    for (size_t p; (p = next_partition.fetch_add(1)) < m_partition_count;)
+                    {
+                        try
+                        {
+                            build_partition(p, partition_entries(p), index_at);
+                        }
+                        catch (...)
+                        {
+                            std::lock_guard lock(error_mutex);
+                            error = std::current_exception();
+                            next_partition = m_partition_count;
+                        }
+                    }
+                });
+            }
+            for (std::thread &worker : workers)
+            {
+                worker.join();
+            }
+            if (error)
+                std::rethrow_exception(error);
+        }
+
+        m_own_keys.reserve(m_size);
+        m_own_values.reserve(m_size);
+        for (size_t i : index_at)
+        {
+            m_own_keys.push_back(std::move(keys[i]));
+            m_own_values.push_back(std::move(values[i]));
+        }
+        point_to_own();
+    }
+
+    void point_to_own() noexcept
+    {
+        m_key_offsets = m_own_key_offsets.data();
+        m_bucket_offsets = m_own_bucket_offsets.data();
+        m_pilots = m_own_pilots.data();
+        m_keys = m_own_keys.data();
+        m_values = m_own_values.data();
+    }
+
+    PerfectHashMap(Hash const &hash, Eq const &eq)
+        : m_size(0), m_partition_count(0), m_bucket_count(0), m_seed(0), m_key_offsets(nullptr),
+          m_bucket_offsets(nullptr), m_pilots(nullptr), m_keys(nullptr), m_values(nullptr), m_hash(hash), m_eq(eq)
+    {
+    }
+
+public:
+    // Builds the map from parallel key and value vectors on up to `threads` threads (0 for one per
+    // hardware thread). Throws std::invalid_argument on a size mismatch or duplicate keys.
+    PerfectHashMap(Vector<K> keys, Vector<V> values, Hash const &hash = Hash(), Eq const &eq = Eq(),
+                   unsigned threads = 0, uint64_t seed = 0x9e3779b97f4a7c15ull)
+        : PerfectHashMap(hash, eq)
+    {
+        if (keys.size() != values.size())
+            throw std::invalid_argument("PerfectHashMap: key and value counts differ");
+        m_seed = seed;
+        build(keys, values, threads);
+    }
+
+    PerfectHashMap(PerfectHashMap &&that) noexcept
+        : m_size(std::exchange(that.m_size, 0)), m_partition_count(std::exchange(that.m_partition_count, 0)),
+          m_bucket_count(std::exchange(that.m_bucket_count, 0)), m_seed(that.m_seed),
+          m_key_offsets(std::exchange(that.m_key_offsets, nullptr)),
+          m_bucket_offsets(std::exchange(that.m_bucket_offsets, nullptr)),
+          m_pilots(std::exchange(that.m_pilots, nullptr)), m_keys(std::exchange(that.m_keys, nullptr)),
+          m_values(std::exchange(that.m_values, nullptr)), m_hash(that.m_hash), m_eq(that.m_eq),
+          m_own_key_offsets(std::move(that.m_own_key_offsets)),
+          m_own_bucket_offsets(std::move(that.m_own_bucket_offsets)), m_own_pilots(std::move(that.m_own_pilots)),
+          m_own_keys(std::move(that.m_own_keys)), m_own_values(std::move(that.m_own_values))
+    {
+    }
+
+    PerfectHashMap &operator=(PerfectHashMap &&that) noexcept
+    {
+        PerfectHashMap tmp(std::move(that));
+        swap(tmp);
+        return *this;
+    }
+
+    // copying a map that may borrow its storage would have to decide who owns what; move it instead
+    PerfectHashMap(PerfectHashMap const &) = delete;
+    PerfectHashMap &operator=(PerfectHashMap const &) = delete;
+
+    // Uses an image written by serialize() in place; it must stay alive and unchanged for the
+    // lifetime of the map and be aligned to 8 bytes. Throws std::invalid_argument if the image is
+    // truncated or was written for other key or value types.
+    static PerfectHashMap from_image(std::span<std::byte const> image, Hash const &hash = Hash(), Eq const &eq = Eq())
+        requires(std::is_trivially_copyable_v<K> && std::is_trivially_copyable_v<V>)
+    {
+        static_assert(alignof(K) <= 8 && alignof(V) <= 8, "image sections are only 8-byte aligned");
+        Header header;
+        if (image.size() < sizeof(header) || reinterpret_cast<uintptr_t>(image.data()) % 8 != 0)
+            throw std::invalid_argument("PerfectHashMap: image too small or misaligned");
+        std::memcpy(&header, image.data(), sizeof(header));
+        if (header.m_magic != image_magic || header.m_version != image_version || header.m_key_size != sizeof(K) ||
+            header.m_value_size != sizeof(V))
+            throw std::invalid_argument("PerfectHashMap: not an image of this map type");
+        PerfectHashMap map(hash, eq);
+        map.m_size = header.m_size;
+        map.m_partition_count = header.m_partition_count;
+        map.m_bucket_count = header.m_bucket_count;
+        map.m_seed = header.m_seed;
+        if (map.image_size() > image.size())
+            throw std::invalid_argument("PerfectHashMap: image truncated");
+        std::byte const *at = image.data() + sizeof(Header);
+        map.m_key_offsets = reinterpret_cast<uint64_t const *>(at);
+        at += (map.m_partition_count + 1) * sizeof(uint64_t);
+        map.m_bucket_offsets = reinterpret_cast<uint64_t const *>(at);
+        at += (map.m_partition_count + 1) * sizeof(uint64_t);
+        map.m_pilots = reinterpret_cast<uint32_t const *>(at);
+        at += align_up(map.m_bucket_count * sizeof(uint32_t), 8);
+        map.m_keys = reinterpret_cast<K const *>(at);
+        at += align_up(map.m_size * sizeof(K), 8);
+        map.m_values = reinterpret_cast<V const *>(at);
+        return map;
+    }
+
+    // number of bytes serialize() writes
+    [[nodiscard]] size_t image_size() const noexcept
+    {
+        return sizeof(Header) + 2 * (m_partition_count + 1) * sizeof(uint64_t) +
+               align_up(m_bucket_count * sizeof(uint32_t), 8) + align_up(m_size * sizeof(K), 8) +
+               align_up(m_size * sizeof(V), 8);
+    }
+
+    void serialize(std::ostream &out) const
+        requires(std::is_trivially_copyable_v<K> && std::is_trivially_copyable_v<V>)
+    {
+        Header header{image_magic, image_version, sizeof(K), sizeof(V), 0, m_size, m_partition_count, m_bucket_count,
+                      m_seed};
+        char const zeros[8] = {};
+        auto write = [&](void const *data, size_t bytes) {
+            out.write(static_cast<char const *>(data), static_cast<std::streamsize>(bytes));
+            out.write(zeros, static_cast<std::streamsize>(align_up(bytes, 8) - bytes));
+        };
+        write(&header, sizeof(header));
+        write(m_key_offsets, (m_partition_count + 1) * sizeof(uint64_t));
+        write(m_bucket_offsets, (m_partition_count + 1) * sizeof(uint64_t));
+        write(m_pilots, m_bucket_count * sizeof(uint32_t));
+        write(m_keys, m_size * sizeof(K));
+        write(m_values, m_size * sizeof(V));
+    }
+
+    void swap(PerfectHashMap &that) noexcept
+    {
+        std::swap(m_size, that.m_size);
+        std::swap(m_partition_count, that.m_partition_count);
+        std::swap(m_bucket_count, that.m_bucket_count);
+        std::swap(m_seed, that.m_seed);
+        std::swap(m_key_offsets, that.m_key_offsets);
+        std::swap(m_bucket_offsets, that.m_bucket_offsets);
+        std::swap(m_pilots, that.m_pilots);
+        std::swap(m_keys, that.m_keys);
+        std::swap(m_values, that.m_values);
+        std::swap(m_hash, that.m_hash);
+        std::swap(m_eq, that.m_eq);
+        m_own_key_offsets.swap(that.m_own_key_offsets);
+        m_own_bucket_offsets.swap(that.m_own_bucket_offsets);
+        m_own_pilots.swap(that.m_own_pilots);
+        m_own_keys.swap(that.m_own_keys);
+        m_own_values.swap(that.m_own_values);
+    }
+
+    hasher hash_function() const
+    {
+        return m_hash;
+    }
+
+    key_equal key_eq() const
+    {
+        return m_eq;
+    }
+
+    [[nodiscard]] size_t size() const noexcept
+    {
+        return m_size;
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return m_size == 0;
+    }
+
+    // bits of lookup structure per key, not counting the keys and values themselves
+    [[nodiscard]] double bits_per_key() const noexcept
+    {
+        if (m_size == 0)
+            return 0.0;
+        size_t bytes = 2 * (m_partition_count + 1) * sizeof(uint64_t) + m_bucket_count * sizeof(uint32_t);
+        return 8.0 * static_cast<double>(bytes) / static_cast<double>(m_size);
+    }
+
+    // The position of key among keys() and values(), or size() if it is not in the map. Any key
+    // hashes to some position; only the one compare tells members from strangers.
+    [[nodiscard]] size_t index_of(K const &key) const
+    {
+        if (m_size == 0)
+            return m_size;
+        uint64_t hash = hash_of(key);
+        size_t p = partition_of(hash);
+        size_t first_key = m_key_offsets[p];
+        size_t n = m_key_offsets[p + 1] - first_key;
+        if (n == 0)
+            return m_size;
+        size_t first_bucket = m_bucket_offsets[p];
+        size_t bucket = first_bucket + reduce(static_cast<uint32_t>(hash), m_bucket_offsets[p + 1] - first_bucket);
+        size_t pos = first_key + position(hash, m_pilots[bucket], n);
+        return m_eq(m_keys[pos], key) ? pos : m_size;
+    }
+
+    template <class Key>
+        requires TransparentHashEq<Hash, Eq>
+    [[nodiscard]] size_t index_of(Key const &key) const
+    {
+        if (m_size == 0)
+            return m_size;
+        uint64_t hash = hash_of(key);
+        size_t p = partition_of(hash);
+        size_t first_key = m_key_offsets[p];
+        size_t n = m_key_offsets[p + 1] - first_key;
+        if (n == 0)
+            return m_size;
+        size_t first_bucket = m_bucket_offsets[p];
+        size_t bucket = first_bucket + reduce(static_cast<uint32_t>(hash), m_bucket_offsets[p + 1] - first_bucket);
+        size_t pos = first_key + position(hash, m_pilots[bucket], n);
+        return m_eq(m_keys[pos], key) ? pos : m_size;
+    }
+
+    [[nodiscard]] V const *find(K const &key) const
+    {
+        size_t pos = index_of(key);
+        return pos == m_size ? nullptr : &m_values[pos];
+    }
+
+    template <class Key>
+        requires TransparentHashEq<Hash, Eq>
+    [[nodiscard]] V const *find(Key const &key) const
+    {
+        size_t pos = index_of(key);
+        return pos == m_size ? nullptr : &m_values[pos];
+    }
+
+    [[nodiscard]] bool contains(K const &key) const
+    {
+        return index_of(key) != m_size;
+    }
+
+    template <class Key>
+        requires TransparentHashEq<Hash, Eq>
+    [[nodiscard]] bool contains(Key const &key) const
+    {
+        return index_of(key) != m_size;
+    }
+
+    [[nodiscard]] size_t count(K const &key) const
+    {
+        return contains(key) ? 1 : 0;
+    }
+
+    template <class Key>
+        requires TransparentHashEq<Hash, Eq>
+    [[nodiscard]] size_t count(Key const &key) const
+    {
+        return contains(key) ? 1 : 0;
+    }
+
+    V const &at(K const &key) const
+    {
+        size_t pos = index_of(key);
+        if (pos == m_size)
+            throw std::out_of_range("PerfectHashMap::at");
+        return m_values[pos];
+    }
+
+    V const &operator[](K const &key) const
+    {
+        return at(key);
+    }
+
+    // keys and values in position order
+    std::span<K const> keys() const noexcept
+    {
+        return {m_keys, m_size};
+    }
+
+    std::span<V const> values() const noexcept
+    {
+        return {m_values, m_size};
+    }
+};
@@ -0,0 +1,981 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// Bottom level of a skip list tower, laid out like ListBaseNode: a doubly linked level 0 through
+// the list's dummy, plus m_height - 1 forward links for the express levels held in m_tower.
+// Forward links are atomic so readers can walk them while the writer links nodes in; m_prev is
+// only ever touched by the writer.
+template <class T>
+struct SkipListBaseNode
+{
+    std::atomic<SkipListBaseNode *> m_next;
+    SkipListBaseNode *m_prev;
+    std::atomic<SkipListBaseNode *> *m_tower;
+    unsigned m_height;
+
+    std::atomic<SkipListBaseNode *> &link(unsigned level) noexcept
+    {
+        return level ? m_tower[level - 1] : m_next;
+    }
+
+    std::atomic<SkipListBaseNode *> const &link(unsigned level) const noexcept
+    {
+        return level ? m_tower[level - 1] : m_next;
+    }
+
+    inline T &value();
+
+    inline T const &value() const;
+};
+template <class T>
+struct SkipListValueNode : SkipListBaseNode<T>
+{
+    union
+    {
+        T m_value;
+    };
+
+    SkipListValueNode() noexcept
+    {
+    }
+
+    ~SkipListValueNode()
+    {
+    }
+};
+template <class T>
+inline T &SkipListBaseNode<T>::value()
+{
+    return static_cast<SkipListValueNode<T> &>(*this).m_value;
+}
+template <class T>
+inline T const &SkipListBaseNode<T>::value() const
+{
+    return static_cast<SkipListValueNode<T> const &>(*this).m_value;
+}
+
+// Ordered lookups (find, contains, count, lower_bound, upper_bound, equal_range, erase) also take
+// any Key that Compare orders against K when it declares is_transparent, like std::less<>.
+template <class Compare>
+concept TransparentCompare = requires { typename Compare::is_transparent; };
+
+// Ordered map over a randomized skip list (towers grow with probability 1/4 per level), giving
+// expected O(log n) find/insert/erase and in-order iteration along level 0.
+//
+// One writer may run alongside any number of readers without locks: readers use only the const
+// lookup and forward-iteration members, and a node is fully built before a release store publishes
+// it, bottom level first. erase() unlinks nodes but parks them instead of freeing them, since a
+// reader may still be standing on one; the writer frees them with reclaim() once no reader can
+// hold a pointer into the list. Overwriting a mapped value (insert_or_assign, operator[]) is not
+// synchronised with readers of that value.
+//
+// Nodes and towers come from Alloc rebound, so a PoolAllocator serves every node and the one-link
+// towers that most taller nodes need.
+template <class K, class V, class Compare = std::less<K>, class Alloc = std::allocator<std::pair<K const, V>>>
+struct SkipList
+{
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = std::pair<K const, V>;
+    using key_compare = Compare;
+    using allocator_type = Alloc;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using pointer = value_type *;
+    using const_pointer = value_type const *;
+    using reference = value_type &;
+    using const_reference = value_type const &;
+
+    static constexpr unsigned max_height = 16;
+
+private:
+    using ListNode = SkipListBaseNode<value_type>;
+    using ValueNode = SkipListValueNode<value_type>;
+    using Link = std::atomic<ListNode *>;
+    using AllocTraits = std::allocator_traits<Alloc>;
+    using AllocNode = AllocTraits::template rebind_alloc<ValueNode>;
+    using AllocNodeTraits = std::allocator_traits<AllocNode>;
+    using AllocLink = AllocTraits::template rebind_alloc<Link>;
+    using AllocLinkTraits = std::allocator_traits<AllocLink>;
+
+    ListNode m_dummy;
+    Link m_head_links[max_height - 1];
+    std::atomic<unsigned> m_level;
+    std::atomic<size_t> m_size;
+    ListNode *m_retired;
+    uint64_t m_seed;
+    [[no_unique_address]] Compare m_comp;
+    [[no_unique_address]] Alloc m_alloc;
+
+    static K const &key_of(ListNode const *node) noexcept
+    {
+        return node->value().first;
+    }
+
+    bool is_end(ListNode const *node) const noexcept
+    {
+        return node == nullptr || node == &m_dummy;
+    }
+
+    // each extra level is kept with probability 1/4
+    unsigned random_height() noexcept
+    {
+        m_seed ^= m_seed << 13;
+        m_seed ^= m_seed >> 7;
+        m_seed ^= m_seed << 17;
+        unsigned zeros = std::countr_zero(m_seed | (uint64_t(1) << (2 * (max_height - 1))));
+        return 1 + zeros / 2;
+    }
+
+    template <class... Args>
+    ListNode *new_node(unsigned height, Args &&...args)
+    {
+        AllocNode alloc{m_alloc};
+        ValueNode *node = AllocNodeTraits::allocate(alloc, 1);
+        ::new (static_cast<void *>(node)) ValueNode;
+        node->m_height = height;
+        node->m_tower = nullptr;
+        try
+        {
+            if (height > 1)
+            {
+                AllocLink link_alloc{m_alloc};
+                node->m_tower = AllocLinkTraits::allocate(link_alloc, height - 1);
+                for (unsigned i = 0; i + 1 < height; i++)
+                {
+                    AllocLinkTraits::construct(link_alloc, node->m_tower + i, nullptr);
+                }
+            }
+            AllocNodeTraits::construct(alloc, &node->m_value, std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            free_tower(node);
+            node->~ValueNode();
+            AllocNodeTraits::deallocate(alloc, node, 1);
+            throw;
+        }
+        return node;
+    }
+
+    void free_tower(ListNode *node) noexcept
+    {
+        if (node->m_tower)
+        {
+            AllocLink link_alloc{m_alloc};
+            AllocLinkTraits::deallocate(link_alloc, node->m_tower, node->m_height - 1);
+        }
+    }
+
+    void delete_node(ListNode *node) noexcept
+    {
+        AllocNode alloc{m_alloc};
+        auto *value_node = static_cast<ValueNode *>(node);
+        AllocNodeTraits::destroy(alloc, &value_node->m_value);
+        free_tower(node);
+        value_node->~ValueNode();
+        AllocNodeTraits::deallocate(alloc, value_node, 1);
+    }
+
+    void reset() noexcept
+    {
+        m_dummy.m_next.store(&m_dummy, std::memory_order_relaxed);
+        m_dummy.m_prev = &m_dummy;
+        for (auto &link : m_head_links)
+        {
+            link.store(nullptr, std::memory_order_relaxed);
+        }
+        m_level.store(1, std::memory_order_relaxed);
+        m_size.store(0, std::memory_order_relaxed);
+    }
+
+    // Walks down from the top level and records, per level, the last node whose key is less than
+    // `key`. Returns the level 0 successor of that node, i.e. the first node not less than `key`.
+    template <class Key>
+    ListNode *find_preds(Key const &key, ListNode **preds) const noexcept
+    {
+        auto *x = const_cast<ListNode *>(&m_dummy);
+        for (unsigned level = m_level.load(std::memory_order_acquire); level-- > 0;)
+        {
+            for (;;)
+            {
+                ListNode *next = x->link(level).load(std::memory_order_acquire);
+                if (is_end(next) || !m_comp(key_of(next), key))
+                    break;
+                x = next;
+            }
+            if (preds)
+            {
+                preds[level] = x;
+            }
+        }
+        return x->m_next.load(std::memory_order_acquire);
+    }
+
+    template <class Key>
+    ListNode *first_not_less(Key const &key) const noexcept
+    {
+        return find_preds(key, nullptr);
+    }
+
+    template <class Key>
+    ListNode *first_greater(Key const &key) const noexcept
+    {
+        ListNode *node = first_not_less(key);
+        if (!is_end(node) && !m_comp(key, key_of(node)))
+        {
+            node = node->m_next.load(std::memory_order_acquire);
+        }
+        return node;
+    }
+
+    // Wires a fresh node in after preds. Its own links are set first and the predecessors are
+    // then pointed at it bottom-up with release stores, so a reader that sees the node sees it whole.
+    void link(ListNode *node, ListNode **preds) noexcept
+    {
+        unsigned height = node->m_height;
+        unsigned level = m_level.load(std::memory_order_relaxed);
+        for (; level < height; level++)
+        {
+            preds[level] = &m_dummy;
+        }
+        for (unsigned i = 0; i < height; i++)
+        {
+            node->link(i).store(preds[i]->link(i).load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+        node->m_prev = preds[0];
+        node->m_next.load(std::memory_order_relaxed)->m_prev = node;
+        for (unsigned i = 0; i < height; i++)
+        {
+            preds[i]->link(i).store(node, std::memory_order_release);
+        }
+        if (height > m_level.load(std::memory_order_relaxed))
+        {
+            m_level.store(height, std::memory_order_release);
+        }
+        m_size.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Takes a node off every level. Its own forward links are left intact so a reader standing on
+    // it can still move on; the node is parked on the retired chain (through m_prev, which readers
+    // never follow) until reclaim().
+    void unlink(ListNode *node, ListNode **preds) noexcept
+    {
+        for (unsigned i = 0; i < node->m_height; i++)
+        {
+            preds[i]->link(i).store(node->link(i).load(std::memory_order_relaxed), std::memory_order_release);
+        }
+        node->m_next.load(std::memory_order_relaxed)->m_prev = preds[0];
+        node->m_prev = m_retired;
+        m_retired = node;
+        unsigned level = m_level.load(std::memory_order_relaxed);
+        while (level > 1 && m_dummy.link(level - 1).load(std::memory_order_relaxed) == nullptr)
+        {
+            --level;
+        }
+        m_level.store(level, std::memory_order_release);
+        m_size.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    // appends a node holding a key greater than every key so far; tails[] tracks each level's last node
+    template <class... Args>
+    void append(ListNode **tails, Args &&...args)
+    {
+        ListNode *node = new_node(random_height(), std::forward<Args>(args)...);
+        link(node, tails);
+        for (unsigned i = 0; i < node->m_height; i++)
+        {
+            tails[i] = node;
+        }
+    }
+
+    void append_all(SkipList const &that)
+    {
+        ListNode *tails[max_height];
+        std::fill(std::begin(tails), std::end(tails), &m_dummy);
+        for (auto const &item : that)
+        {
+            append(tails, item);
+        }
+    }
+
+    void append_all_move(SkipList &that)
+    {
+        ListNode *tails[max_height];
+        std::fill(std::begin(tails), std::end(tails), &m_dummy);
+        for (auto &item : that)
+        {
+            append(tails, std::move(const_cast<K &>(item.first)), std::move(item.second));
+        }
+        that.clear();
+    }
+
+    // the dummy stays in place, so a swap exchanges the links and re-points the level 0 neighbours
+    void swap_links(SkipList &that) noexcept
+    {
+        auto exchange = [](Link &a, Link &b) {
+            ListNode *tmp = a.load(std::memory_order_relaxed);
+            a.store(b.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            b.store(tmp, std::memory_order_relaxed);
+        };
+        exchange(m_dummy.m_next, that.m_dummy.m_next);
+        std::swap(m_dummy.m_prev, that.m_dummy.m_prev);
+        for (unsigned i = 0; i + 1 < max_height; i++)
+        {
+            exchange(m_head_links[i], that.m_head_links[i]);
+        }
+        reseat_dummy(m_dummy, that.m_dummy);
+        reseat_dummy(that.m_dummy, m_dummy);
+
+        unsigned level = m_level.load(std::memory_order_relaxed);
+        m_level.store(that.m_level.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        that.m_level.store(level, std::memory_order_relaxed);
+        size_t size = m_size.load(std::memory_order_relaxed);
+        m_size.store(that.m_size.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        that.m_size.store(size, std::memory_order_relaxed);
+        std::swap(m_retired, that.m_retired);
+    }
+
+    static void reseat_dummy(ListNode &dummy, ListNode &old_dummy) noexcept
+    {
+        if (dummy.m_next.load(std::memory_order_relaxed) == &old_dummy)
+        {
+            dummy.m_next.store(&dummy, std::memory_order_relaxed);
+            dummy.m_prev = &dummy;
+        }
+        else
+        {
+            dummy.m_next.load(std::memory_order_relaxed)->m_prev = &dummy;
+            dummy.m_prev->m_next.store(&dummy, std::memory_order_relaxed);
+        }
+    }
+
+public:
+    struct iterator
+    {
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = SkipList::value_type;
+        using difference_type = ptrdiff_t;
+        using pointer = value_type *;
+        using reference = value_type &;
+
+    private:
+        ListNode *m_curr;
+
+        friend SkipList;
+
+        explicit iterator(ListNode *curr) noexcept : m_curr(curr) {}
+
+    public:
+        iterator() = default;
+
+        iterator &operator++() noexcept
+        {
+            m_curr = m_curr->m_next.load(std::memory_order_acquire);
+            return *this;
+        }
+
+        iterator operator++(int) noexcept
+        {
+            auto ret = *this;
+            ++*this;
+            return ret;
+        }
+
+        // only the writer may walk backwards
+        iterator &operator--() noexcept
+        {
+            m_curr = m_curr->m_prev;
+            return *this;
+        }
+
+        iterator operator--(int) noexcept
+        {
+            auto ret = *this;
+            m_curr = m_curr->m_prev;
+            return ret;
+        }
+
+        value_type &operator*() const noexcept
+        {
+            return m_curr->value();
+        }
+
+        value_type *operator->() const noexcept
+        {
+            return &m_curr->value();
+        }
+
+        bool operator!=(iterator const &that) const noexcept
+        {
+            return !(*this == that);
+        }
+
+        bool operator==(iterator const &that) const noexcept
+        {
+            return m_curr == that.m_curr;
+        }
+    };
+
+    struct const_iterator
+    {
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = SkipList::value_type;
+        using difference_type = ptrdiff_t;
+        using pointer = value_type const *;
+        using reference = value_type const &;
+
+    private:
+        ListNode const *m_curr;
+
+        friend SkipList;
+
+        explicit const_iterator(ListNode const *curr) noexcept : m_curr(curr) {}
+
+    public:
+        const_iterator() = default;
+
+        const_iterator(iterator that) noexcept : m_curr(that.m_curr) {}
+
+        explicit operator iterator() noexcept
+        {
+            return iterator{const_cast<ListNode *>(m_curr)};
+        }
+
+        const_iterator &operator++() noexcept
+        {
+            m_curr = m_curr->m_next.load(std::memory_order_acquire);
+            return *this;
+        }
+
+        const_iterator operator++(int) noexcept
+        {
+            auto ret = *this;
+            ++*this;
+            return ret;
+        }
+
+        const_iterator &operator--() noexcept
+        {
+            m_curr = m_curr->m_prev;
+            return *this;
+        }
+
+        const_iterator operator--(int) noexcept
+        {
+            auto ret = *this;
+            m_curr = m_curr->m_prev;
+            return ret;
+        }
+
+        value_type const &operator*() const noexcept
+        {
+            return m_curr->value();
+        }
+
+        value_type const *operator->() const noexcept
+        {
+            return &m_curr->value();
+        }
+
+        bool operator!=(const_iterator const &that) const noexcept
+        {
+            return !(*this == that);
+        }
+
+        bool operator==(const_iterator const &that) const noexcept
+        {
+            return m_curr == that.m_curr;
+        }
+    };
+
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using reverse_const_iterator = std::reverse_iterator<const_iterator>;
+
+    SkipList() : SkipList(Compare(), Alloc())
+    {
+    }
+
+    explicit SkipList(Alloc const &alloc) : SkipList(Compare(), alloc)
+    {
+    }
+
+    explicit SkipList(Compare const &comp, Alloc const &alloc = Alloc())
+        : m_retired(nullptr), m_seed((0x9e3779b97f4a7c15ull ^ reinterpret_cast<uintptr_t>(this)) | 1), m_comp(comp),
+          m_alloc(alloc)
+    {
+        m_dummy.m_tower = m_head_links;
+        m_dummy.m_height = max_height;
+        reset();
+    }
+
+    template <std::input_iterator InputIt>
+    SkipList(InputIt first, InputIt last, Compare const &comp = Compare(), Alloc const &alloc = Alloc())
+        : SkipList(comp, alloc)
+    {
+        insert(first, last);
+    }
+
+    SkipList(std::initializer_list<value_type> ilist, Compare const &comp = Compare(), Alloc const &alloc = Alloc())
+        : SkipList(ilist.begin(), ilist.end(), comp, alloc)
+    {
+    }
+
+    SkipList(SkipList const &that)
+        : SkipList(that.m_comp, AllocTraits::select_on_container_copy_construction(that.m_alloc))
+    {
+        append_all(that);
+    }
+
+    SkipList(SkipList const &that, Alloc const &alloc) : SkipList(that.m_comp, alloc)
+    {
+        append_all(that);
+    }
+
+    SkipList(SkipList &&that) noexcept : SkipList(that.m_comp, std::move(that.m_alloc))
+    {
+        swap_links(that);
+    }
+
+    SkipList(SkipList &&that, Alloc const &alloc) : SkipList(that.m_comp, alloc)
+    {
+        if (m_alloc == that.m_alloc)
+        {
+            swap_links(that);
+        }
+        else
+        {
+            append_all_move(that);
+        }
+    }
+
+    SkipList &operator=(SkipList const &that)
+    {
+        if (this == &that)
+            return *this;
+        clear();
+        if constexpr (AllocTraits::propagate_on_container_copy_assignment::value)
+        {
+            m_alloc = that.m_alloc;
+        }
+        m_comp = that.m_comp;
+        append_all(that);
+        return *this;
+    }
+
+    SkipList &operator=(SkipList &&that) noexcept(AllocTraits::propagate_on_container_move_assignment::value ||
+                                                   AllocTraits::is_always_equal::value)
+    {
+        if (this == &that)
+            return *this;
+        clear();
+        m_comp = that.m_comp;
+        if constexpr (AllocTraits::propagate_on_container_move_assignment::value)
+        {
+            m_alloc = std::move(that.m_alloc);
+            swap_links(that);
+        }
+        else if (m_alloc == that.m_alloc)
+        {
+            swap_links(that);
+        }
+        else
+        {
+            append_all_move(that);
+        }
+        return *this;
+    }
+
+    ~SkipList()
+    {
+        clear();
+    }
+
+    void swap(SkipList &that) noexcept
+    {
+        if constexpr (AllocTraits::propagate_on_container_swap::value)
+        {
+            std::swap(m_alloc, that.m_alloc);
+        }
+        std::swap(m_comp, that.m_comp);
+        swap_links(that);
+    }
+
+    Alloc get_allocator() const noexcept
+    {
+        return m_alloc;
+    }
+
+    key_compare key_comp() const
+    {
+        return m_comp;
+    }
+
+    [[nodiscard]] size_t size() const noexcept
+    {
+        return m_size.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    // writer only, with no reader inside the list
+    void clear() noexcept
+    {
+        ListNode *cur = m_dummy.m_next.load(std::memory_order_relaxed);
+        while (cur != &m_dummy)
+        {
+            ListNode *next = cur->m_next.load(std::memory_order_relaxed);
+            delete_node(cur);
+            cur = next;
+        }
+        reclaim();
+        reset();
+    }
+
+    // Frees the nodes erase() has parked. Call from the writer once no reader can still hold one.
+    void reclaim() noexcept
+    {
+        while (m_retired)
+        {
+            ListNode *next = m_retired->m_prev;
+            delete_node(m_retired);
+            m_retired = next;
+        }
+    }
+
+    iterator begin() noexcept
+    {
+        return iterator{m_dummy.m_next.load(std::memory_order_acquire)};
+    }
+
+    iterator end() noexcept
+    {
+        return iterator{&m_dummy};
+    }
+
+    const_iterator cbegin() const noexcept
+    {
+        return const_iterator{m_dummy.m_next.load(std::memory_order_acquire)};
+    }
+
+    const_iterator cend() const noexcept
+    {
+        return const_iterator{&m_dummy};
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return cbegin();
+    }
+
+    const_iterator end() const noexcept
+    {
+        return cend();
+    }
+
+    reverse_iterator rbegin() noexcept
+    {
+        return std::make_reverse_iterator(end());
+    }
+
+    reverse_iterator rend() noexcept
+    {
+        return std::make_reverse_iterator(begin());
+    }
+
+    reverse_const_iterator crbegin() const noexcept
+    {
+        return std::make_reverse_iterator(cend());
+    }
+
+    reverse_const_iterator crend() const noexcept
+    {
+        return std::make_reverse_iterator(cbegin());
+    }
+
+    iterator lower_bound(K const &key) noexcept
+    {
+        return iterator{first_not_less(key)};
+    }
+
+    template <class Key>
+        requires TransparentCompare<Compare>
+    iterator lower_bound(Key const &key) noexcept
+    {
+        return iterator{first_not_less(key)};
+    }
+
+    const_iterator lower_bound(K const &key) const noexcept
+    {
+        return const_iterator{first_not_less(key)};
+    }
+
+    template <class Key>
+        requires TransparentCompare<Compare>
+    const_iterator lower_bound(Key const &key) const noexcept
+    {
+        return const_iterator{first_not_less(key)};
+    }
+
+    iterator upper_bound(K const &key) noexcept
+    {
+        return iterator{first_greater(key)};
+    }
+
+    template <class Key>
+        requires TransparentCompare<Compare>
+    iterator upper_bound(Key const &key) noexcept
+    {
+        return iterator{first_greater(key)};
+    }
+
+    const_iterator upper_bound(K const &key) const noexcept
+    {
+        return const_iterator{first_greater(key)};
+    }
+
+    template <class Key>
+        requires TransparentCompare<Compare>
+    const_iterator upper_bound(Key const &key) const noexcept
+    {
+        return const_iterator{first_greater(key)};
+    }
+
+    iterator find(K const &key) noexcept
+    {
+        ListNode *node = first_not_less(key);
+        return iterator{is_end(node) || m_comp(key, key_of(node)) ? &m_dummy : node};
+    }
+
+    template <class Key>
+        requires TransparentCompare<Compare>
+    iterator find(Key const &key) noexcept
+    {
+        ListNode *node = first_not_less(key);
+        return iterator{is_end(node) || m_comp(key, key_of(node)) ? &m_dummy : node};
+    }
+
+    const_iterator find(K const &key) const noexcept
+    {
+        return const_cast<SkipList *>(this)->find(key);
+    }
+
+    template <class Key>
+        requires TransparentCompare<Compare>
+    const_iterator find(Key const &key) const noexcept
+    {
+        return const_cast<SkipList *>(this)->find(key);
+    }
+
+    [[nodiscard]] bool contains(K const &key) const noexcept
+    {
+        return find(key) != end();
+    }
+
+    template <class Key>
+        requires TransparentCompare<Compare>
+    [[nodiscard]] bool contains(Key const &key) const noexcept
+    {
+        return find(key) != end();
+    }
+
+    [[nodiscard]] size_t count(K const &key) const noexcept
+    {
+        return contains(key) ? 1 : 0;
+    }
+
+    template <class Key>
+        requires TransparentCompare<Compare>
+    [[nodiscard]] size_t count(Key const &key) const noexcept
+    {
+        return contains(key) ? 1 : 0;
+    }
+
+    std::pair<iterator, iterator> equal_range(K const &key) noexcept
+    {
+        return {lower_bound(key), upper_bound(key)};
+    }
+
+    template <class Key>
+        requires TransparentCompare<Compare>
+    std::pair<iterator, iterator> equal_range(Key const &key) noexcept
+    {
+        return {lower_bound(key), upper_bound(key)};
+    }
+
+    std::pair<const_iterator, const_iterator> equal_range(K const &key) const noexcept
+    {
+        return {lower_bound(key), upper_bound(key)};
+    }
+
+    template <class Key>
+        requires TransparentCompare<Compare>
+    std::pair<const_iterator, const_iterator> equal_range(Key const &key) const noexcept
+    {
+        return {lower_bound(key), upper_bound(key)};
+    }
+
+    // the elements with keys in [lo, hi), in order
+    std::ranges::subrange<const_iterator> range(K const &lo, K const &hi) const noexcept
+    {
+        return {lower_bound(lo), lower_bound(hi)};
+    }
+
+    V &at(K const &key)
+    {
+        auto it = find(key);
+        if (it == end())
+            throw std::out_of_range("SkipList::at");
+        return it->second;
+    }
+
+    V const &at(K const &key) const
+    {
+        auto it = find(key);
+        if (it == end())
+            throw std::out_of_range("SkipList::at");
+        return it->second;
+    }
+
+    template <class... Args>
+    std::pair<iterator, bool> try_emplace(K const &key, Args &&...args)
+    {
+        ListNode *preds[max_height];
+        ListNode *node = find_preds(key, preds);
+        if (!is_end(node) && !m_comp(key, key_of(node)))
+            return {iterator{node}, false};
+        node = new_node(random_height(), std::piecewise_construct, std::forward_as_tuple(key),
+                        std::forward_as_tuple(std::forward<Args>(args)...));
+        link(node, preds);
+        return {iterator{node}, true};
+    }
+
+    template <class... Args>
+    std::pair<iterator, bool> try_emplace(K &&key, Args &&...args)
+    {
+        ListNode *preds[max_height];
+        ListNode *node = find_preds(key, preds);
+        if (!is_end(node) && !m_comp(key, key_of(node)))
+            return {iterator{node}, false};
+        node = new_node(random_height(), std::piecewise_construct, std::forward_as_tuple(std::move(key)),
+                        std::forward_as_tuple(std::forward<Args>(args)...));
+        link(node, preds);
+        return {iterator{node}, true};
+    }
+
+    // the node is built first because the key is only known once the pair exists
+    template <class... Args>
+    std::pair<iterator, bool> emplace(Args &&...args)
+    {
+        ListNode *node = new_node(random_height(), std::forward<Args>(args)...);
+        ListNode *preds[max_height];
+        ListNode *found = find_preds(key_of(node), preds);
+        if (!is_end(found) && !m_comp(key_of(node), key_of(found)))
+        {
+            delete_node(node);
+            return {iterator{found}, false};
+        }
+        link(node, preds);
+        return {iterator{node}, true};
+    }
+
+    std::pair<iterator, bool> insert(value_type const &val)
+    {
+        return try_emplace(val.first, val.second);
+    }
+
+    std::pair<iterator, bool> insert(value_type &&val)
+    {
+        return try_emplace(std::move(const_cast<K &>(val.first)), std::move(val.second));
+    }
+
+    template <std::input_iterator InputIt>
+    void insert(InputIt first, InputIt last)
+    {
+        for (; first != last; ++first)
+        {
+            emplace(*first);
+        }
+    }
+
+    void insert(std::initializer_list<value_type> ilist)
+    {
+        insert(ilist.begin(), ilist.end());
+    }
+
+    template <class M>
+    std::pair<iterator, bool> insert_or_assign(K const &key, M &&obj)
+    {
+        auto ret = try_emplace(key, std::forward<M>(obj));
+        if (!ret.second)
+        {
+            ret.first->second = std::forward<M>(obj);
+        }
+        return ret;
+    }
+
+    V &operator[](K const &key)
+    {
+        return try_emplace(key).first->second;
+    }
+
+    size_t erase(K const &key) noexcept
+    {
+        ListNode *preds[max_height];
+        ListNode *node = find_preds(key, preds);
+        if (is_end(node) || m_comp(key, key_of(node)))
+            return 0;
+        unlink(node, preds);
+        return 1;
+    }
+
+    template <class Key>
+        requires(TransparentCompare<Compare> && !std::is_convertible_v<Key const &, const_iterator>)
+    size_t erase(Key const &key) noexcept
+    {
+        ListNode *preds[max_height];
+        ListNode *node = find_preds(key, preds);
+        if (is_end(node) || m_comp(key, key_of(node)))
+            return 0;
+        unlink(node, preds);
+        return 1;
+    }
+
+    iterator erase(const_iterator pos) noexcept
+    {
+        auto *node = const_cast<ListNode *>(pos.m_curr);
+        ListNode *next = node->m_next.load(std::memory_order_relaxed);
+        erase(key_of(node));
+        return iterator{next};
+    }
+
+    iterator erase(const_iterator first, const_iterator last) noexcept
+    {
+        while (first != last)
+        {
+            first = erase(first);
+        }
+        return iterator{const_cast<ListNode *>(last.m_curr)};
+    }
+
+    bool operator==(SkipList const &that) const
+    {
+        return size() == that.size() && std::equal(begin(), end(), that.begin(), that.end());
+    }
+};
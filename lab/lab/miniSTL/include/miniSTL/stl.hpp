@@ -1,2 +1,14 @@
+#include <miniSTL/compact_list.hpp>
+#include <miniSTL/concurrent_hash_map.hpp>
+#include <miniSTL/cuckoo_map.hpp>
+#include <miniSTL/forward_list.hpp>
+#include <miniSTL/hash.hpp>
+#include <miniSTL/hash_table.hpp>
+#include <miniSTL/intrusive_list.hpp>
 #include <miniSTL/list.hpp>
+#include <miniSTL/mpsc_queue.hpp>
+#include <miniSTL/node_pool.hpp>
+#include <miniSTL/perfect_hash_map.hpp>
+#include <miniSTL/skip_list.hpp>
+#include <miniSTL/unrolled_list.hpp>
 #include <miniSTL/vector.hpp>
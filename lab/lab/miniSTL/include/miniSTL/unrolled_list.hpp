@@ -0,0 +1,738 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <utility>
+#include <initializer_list>
+
+template <class T>
+struct UnrolledBaseNode
+{
+    UnrolledBaseNode *m_next;
+    UnrolledBaseNode *m_prev;
+};
+template <class T, size_t K>
+struct UnrolledValueNode : UnrolledBaseNode<T>
+{
+    size_t m_count;
+    union
+    {
+        T m_values[K];
+    };
+};
+
+// Doubly linked list whose nodes each hold up to K contiguous elements. A full node is split in
+// half on insert, and a node that drops below half full after an erase absorbs its successor when
+// both fit in one node, so nodes stay at least half full on average.
+template <class T, size_t K = 16, class Alloc = std::allocator<T>>
+struct UnrolledList
+{
+    static_assert(K >= 2, "UnrolledList nodes must hold at least two elements");
+
+    using value_type = T;
+    using allocator_type = Alloc;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using pointer = T *;
+    using const_pointer = T const *;
+    using reference = T &;
+    using const_reference = T const &;
+
+private:
+    using BaseNode = UnrolledBaseNode<T>;
+    using Node = UnrolledValueNode<T, K>;
+    using AllocTraits = std::allocator_traits<Alloc>;
+    using AllocNode = typename AllocTraits::template rebind_alloc<Node>;
+    using AllocNodeTraits = std::allocator_traits<AllocNode>;
+
+    BaseNode m_dummy;
+    size_t m_size;
+    [[no_unique_address]] Alloc m_alloc;
+
+    static Node *as_node(BaseNode *node) noexcept
+    {
+        return static_cast<Node *>(node);
+    }
+
+    static Node const *as_node(BaseNode const *node) noexcept
+    {
+        return static_cast<Node const *>(node);
+    }
+
+    Node *new_node_after(BaseNode *prev)
+    {
+        AllocNode alloc{m_alloc};
+        Node *node = AllocNodeTraits::allocate(alloc, 1);
+        node->m_count = 0;
+        node->m_prev = prev;
+        node->m_next = prev->m_next;
+        prev->m_next->m_prev = node;
+        prev->m_next = node;
+        return node;
+    }
+
+    // unlinks and frees a node whose elements have already been destroyed
+    void delete_node(Node *node) noexcept
+    {
+        node->m_prev->m_next = node->m_next;
+        node->m_next->m_prev = node->m_prev;
+        AllocNode alloc{m_alloc};
+        AllocNodeTraits::deallocate(alloc, node, 1);
+    }
+
+    // Moves elements [first, from->m_count) of `from` to the end of `to`. Should a move throw, the
+    // elements not yet moved are destroyed, so both nodes stay consistent but may be left empty.
+    void move_elements(Node *from, size_t first, Node *to)
+    {
+        size_t i = first;
+        try
+        {
+            for (; i < from->m_count; ++i)
+            {
+                AllocTraits::construct(m_alloc, &to->m_values[to->m_count], std::move(from->m_values[i]));
+                AllocTraits::destroy(m_alloc, &from->m_values[i]);
+                ++to->m_count;
+            }
+        }
+        catch (...)
+        {
+            for (size_t j = i; j < from->m_count; ++j)
+            {
+                AllocTraits::destroy(m_alloc, &from->m_values[j]);
+            }
+            m_size -= from->m_count - i;
+            from->m_count = first;
+            throw;
+        }
+        from->m_count = first;
+    }
+
+    void steal(UnrolledList &that) noexcept
+    {
+        if (that.m_size == 0)
+        {
+            m_dummy.m_next = m_dummy.m_prev = &m_dummy;
+        }
+        else
+        {
+            m_dummy = that.m_dummy;
+            m_dummy.m_next->m_prev = &m_dummy;
+            m_dummy.m_prev->m_next = &m_dummy;
+        }
+        m_size = that.m_size;
+        that.m_dummy.m_next = that.m_dummy.m_prev = &that.m_dummy;
+        that.m_size = 0;
+    }
+
+public:
+    struct iterator
+    {
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = ptrdiff_t;
+        using pointer = T *;
+        using reference = T &;
+
+    private:
+        BaseNode *m_node;
+        size_t m_index;
+
+        friend UnrolledList;
+
+        iterator(BaseNode *node, size_t index) noexcept : m_node(node), m_index(index) {}
+
+    public:
+        iterator() = default;
+
+        iterator &operator++() noexcept
+        {
+            if (++m_index == as_node(m_node)->m_count)
+            {
+                m_node = m_node->m_next;
+                m_index = 0;
+            }
+            return *this;
+        }
+
+        iterator operator++(int) noexcept
+        {
+            auto ret = *this;
+            ++*this;
+            return ret;
+        }
+
+        iterator &operator--() noexcept
+        {
+            if (m_index == 0)
+            {
+                m_node = m_node->m_prev;
+                m_index = as_node(m_node)->m_count;
+            }
+            --m_index;
+            return *this;
+        }
+
+        iterator operator--(int) noexcept
+        {
+            auto ret = *this;
+            --*this;
+            return ret;
+        }
+
+        T &operator*() const noexcept
+        {
+            return as_node(m_node)->m_values[m_index];
+        }
+
+        T *operator->() const noexcept
+        {
+            return &as_node(m_node)->m_values[m_index];
+        }
+
+        bool operator!=(iterator const &that) const noexcept
+        {
+            return !(*this == that);
+        }
+
+        bool operator==(iterator const &that) const noexcept
+        {
+            return m_node == that.m_node && m_index == that.m_index;
+        }
+    };
+
+    struct const_iterator
+    {
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = ptrdiff_t;
+        using pointer = T const *;
+        using reference = T const &;
+
+    private:
+        BaseNode const *m_node;
+        size_t m_index;
+
+        friend UnrolledList;
+
+        const_iterator(BaseNode const *node, size_t index) noexcept : m_node(node), m_index(index) {}
+
+    public:
+        const_iterator() = default;
+
+        const_iterator(iterator that) noexcept : m_node(that.m_node), m_index(that.m_index) {}
+
+        explicit operator iterator() noexcept
+        {
+            return iterator{const_cast<BaseNode *>(m_node), m_index};
+        }
+
+        const_iterator &operator++() noexcept
+        {
+            if (++m_index == as_node(m_node)->m_count)
+            {
+                m_node = m_node->m_next;
+                m_index = 0;
+            }
+            return *this;
+        }
+
+        const_iterator operator++(int) noexcept
+        {
+            auto ret = *this;
+            ++*this;
+            return ret;
+        }
+
+        const_iterator &operator--() noexcept
+        {
+            if (m_index == 0)
+            {
+                m_node = m_node->m_prev;
+                m_index = as_node(m_node)->m_count;
+            }
+            --m_index;
+            return *this;
+        }
+
+        const_iterator operator--(int) noexcept
+        {
+            auto ret = *this;
+            --*this;
+            return ret;
+        }
+
+        T const &operator*() const noexcept
+        {
+            return as_node(m_node)->m_values[m_index];
+        }
+
+        T const *operator->() const noexcept
+        {
+            return &as_node(m_node)->m_values[m_index];
+        }
+
+        bool operator!=(const_iterator const &that) const noexcept
+        {
+            return !(*this == that);
+        }
+
+        bool operator==(const_iterator const &that) const noexcept
+        {
+            return m_node == that.m_node && m_index == that.m_index;
+        }
+    };
+
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using reverse_const_iterator = std::reverse_iterator<const_iterator>;
+
+    UnrolledList() : UnrolledList(Alloc())
+    {
+    }
+
+    explicit UnrolledList(Alloc const &alloc) noexcept : m_size(0), m_alloc(alloc)
+    {
+        m_dummy.m_next = &m_dummy;
+        m_dummy.m_prev = &m_dummy;
+    }
+
+    UnrolledList(size_t n, T const &val, Alloc const &alloc = Alloc()) : UnrolledList(alloc)
+    {
+        while (n--)
+        {
+            emplace_back(val);
+        }
+    }
+
+    template <std::input_iterator InputIt>
+    UnrolledList(InputIt first, InputIt last, Alloc const &alloc = Alloc()) : UnrolledList(alloc)
+    {
+        for (; first != last; ++first)
+        {
+            emplace_back(*first);
+        }
+    }
+
+    UnrolledList(std::initializer_list<T> ilist, Alloc const &alloc = Alloc())
+        : UnrolledList(ilist.begin(), ilist.end(), alloc)
+    {
+    }
+
+    UnrolledList(UnrolledList const &that)
+        : UnrolledList(that.cbegin(), that.cend(), AllocTraits::select_on_container_copy_construction(that.m_alloc))
+    {
+    }
+
+    UnrolledList(UnrolledList &&that) noexcept : m_alloc(std::move(that.m_alloc))
+    {
+        steal(that);
+    }
+
+    UnrolledList &operator=(UnrolledList const &that)
+    {
+        if (this == &that)
+            return *this;
+        clear();
+        if constexpr (AllocTraits::propagate_on_container_copy_assignment::value)
+        {
+            m_alloc = that.m_alloc;
+        }
+        for (auto const &val : that)
+        {
+            emplace_back(val);
+        }
+        return *this;
+    }
+
+    UnrolledList &operator=(UnrolledList &&that) noexcept(AllocTraits::propagate_on_container_move_assignment::value ||
+                                                          AllocTraits::is_always_equal::value)
+    {
+        if (this == &that)
+            return *this;
+        clear();
+        if constexpr (!AllocTraits::propagate_on_container_move_assignment::value &&
+                      !AllocTraits::is_always_equal::value)
+        {
+            if (m_alloc != that.m_alloc)
+            {
+                for (auto &val : that)
+                {
+                    emplace_back(std::move(val));
+                }
+                that.clear();
+                return *this;
+            }
+        }
+        if constexpr (AllocTraits::propagate_on_container_move_assignment::value)
+        {
+            m_alloc = std::move(that.m_alloc);
+        }
+        steal(that);
+        return *this;
+    }
+
+    ~UnrolledList()
+    {
+        clear();
+    }
+
+    Alloc get_allocator() const noexcept
+    {
+        return m_alloc;
+    }
+
+    [[nodiscard]] size_t size() const noexcept
+    {
+        return m_size;
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return m_size == 0;
+    }
+
+    T &front() noexcept
+    {
+        return as_node(m_dummy.m_next)->m_values[0];
+    }
+
+    T const &front() const noexcept
+    {
+        return as_node(m_dummy.m_next)->m_values[0];
+    }
+
+    T &back() noexcept
+    {
+        Node *last = as_node(m_dummy.m_prev);
+        return last->m_values[last->m_count - 1];
+    }
+
+    T const &back() const noexcept
+    {
+        Node const *last = as_node(m_dummy.m_prev);
+        return last->m_values[last->m_count - 1];
+    }
+
+    void clear() noexcept
+    {
+        BaseNode *cur = m_dummy.m_next;
+        while (cur != &m_dummy)
+        {
+            BaseNode *next = cur->m_next;
+            Node *node = as_node(cur);
+            for (size_t i = 0; i != node->m_count; ++i)
+            {
+                AllocTraits::destroy(m_alloc, &node->m_values[i]);
+            }
+            AllocNode alloc{m_alloc};
+            AllocNodeTraits::deallocate(alloc, node, 1);
+            cur = next;
+        }
+        m_dummy.m_next = &m_dummy;
+        m_dummy.m_prev = &m_dummy;
+        m_size = 0;
+    }
+
+    iterator begin() noexcept
+    {
+        return iterator{m_dummy.m_next, 0};
+    }
+
+    iterator end() noexcept
+    {
+        return iterator{&m_dummy, 0};
+    }
+
+    const_iterator cbegin() const noexcept
+    {
+        return const_iterator{m_dummy.m_next, 0};
+    }
+
+    const_iterator cend() const noexcept
+    {
+        return const_iterator{&m_dummy, 0};
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return cbegin();
+    }
+
+    const_iterator end() const noexcept
+    {
+        return cend();
+    }
+
+    reverse_iterator rbegin() noexcept
+    {
+        return std::make_reverse_iterator(end());
+    }
+
+    reverse_iterator rend() noexcept
+    {
+        return std::make_reverse_iterator(begin());
+    }
+
+    reverse_const_iterator crbegin() const noexcept
+    {
+        return std::make_reverse_iterator(cend());
+    }
+
+    reverse_const_iterator crend() const noexcept
+    {
+        return std::make_reverse_iterator(cbegin());
+    }
+
+    // Calls f with a std::span over each node's elements, in order.
+    template <class F>
+    void for_each_chunk(F &&f)
+    {
+        for (BaseNode *cur = m_dummy.m_next; cur != &m_dummy; cur = cur->m_next)
+        {
+            f(std::span<T>(as_node(cur)->m_values, as_node(cur)->m_count));
+        }
+    }
+
+    template <class F>
+    void for_each_chunk(F &&f) const
+    {
+        for (BaseNode const *cur = m_dummy.m_next; cur != &m_dummy; cur = cur->m_next)
+        {
+            f(std::span<T const>(as_node(cur)->m_values, as_node(cur)->m_count));
+        }
+    }
+
+private:
+    // Moves val into slot idx of the node at base, or of a new last node if base is the dummy,
+    // splitting a full node first. A throwing move leaves no empty node linked and no destroyed
+    // slot counted.
+    iterator insert_moved(BaseNode *base, size_t idx, T &val)
+    {
+        Node *node;
+        if (base == &m_dummy)
+        {
+            node = new_node_after(m_dummy.m_prev);
+            try
+            {
+                AllocTraits::construct(m_alloc, &node->m_values[0], std::move(val));
+            }
+            catch (...)
+            {
+                delete_node(node);
+                throw;
+            }
+            node->m_count = 1;
+            ++m_size;
+            return iterator{node, 0};
+        }
+
+        node = as_node(base);
+        if (node->m_count == K)
+        {
+            Node *next = new_node_after(node);
+            try
+            {
+                move_elements(node, K / 2, next);
+            }
+            catch (...)
+            {
+                if (next->m_count == 0)
+                {
+                    delete_node(next);
+                }
+                throw;
+            }
+            if (idx > K / 2)
+            {
+                node = next;
+                idx -= K / 2;
+            }
+        }
+
+        size_t hole = node->m_count;
+        try
+        {
+            for (; hole > idx; --hole)
+            {
+                AllocTraits::construct(m_alloc, &node->m_values[hole], std::move(node->m_values[hole - 1]));
+                AllocTraits::destroy(m_alloc, &node->m_values[hole - 1]);
+            }
+            AllocTraits::construct(m_alloc, &node->m_values[idx], std::move(val));
+        }
+        catch (...)
+        {
+            // a move threw and left a hole; drop the elements above it
+            for (size_t i = hole + 1; i <= node->m_count; ++i)
+            {
+                AllocTraits::destroy(m_alloc, &node->m_values[i]);
+            }
+            m_size -= node->m_count - hole;
+            node->m_count = hole;
+            if (hole == 0)
+            {
+                delete_node(node);
+            }
+            throw;
+        }
+        ++node->m_count;
+        ++m_size;
+        return iterator{node, idx};
+    }
+
+public:
+    template <class... Args>
+    iterator emplace(const_iterator pos, Args &&...args)
+    {
+        BaseNode *base = const_cast<BaseNode *>(pos.m_node);
+        size_t idx = pos.m_index;
+
+        // inserting in front of a node's first element can go to the end of the previous node
+        if (idx == 0 && base->m_prev != &m_dummy && as_node(base->m_prev)->m_count < K)
+        {
+            Node *prev = as_node(base->m_prev);
+            AllocTraits::construct(m_alloc, &prev->m_values[prev->m_count], std::forward<Args>(args)...);
+            ++m_size;
+            return iterator{prev, prev->m_count++};
+        }
+
+        // Anywhere else elements move or a node is linked before the new element exists, so it is
+        // built first: args may refer into the list, and a throwing constructor changes nothing.
+        alignas(T) std::byte tmp_storage[sizeof(T)];
+        T *tmp = reinterpret_cast<T *>(tmp_storage);
+        AllocTraits::construct(m_alloc, tmp, std::forward<Args>(args)...);
+        try
+        {
+            iterator it = insert_moved(base, idx, *tmp);
+            AllocTraits::destroy(m_alloc, tmp);
+            return it;
+        }
+        catch (...)
+        {
+            AllocTraits::destroy(m_alloc, tmp);
+            throw;
+        }
+    }
+
+    template <class... Args>
+    T &emplace_back(Args &&...args)
+    {
+        return *emplace(cend(), std::forward<Args>(args)...);
+    }
+
+    template <class... Args>
+    T &emplace_front(Args &&...args)
+    {
+        return *emplace(cbegin(), std::forward<Args>(args)...);
+    }
+
+    void push_back(T const &val)
+    {
+        emplace_back(val);
+    }
+
+    void push_back(T &&val)
+    {
+        emplace_back(std::move(val));
+    }
+
+    void push_front(T const &val)
+    {
+        emplace_front(val);
+    }
+
+    void push_front(T &&val)
+    {
+        emplace_front(std::move(val));
+    }
+
+    iterator insert(const_iterator pos, T const &val)
+    {
+        return emplace(pos, val);
+    }
+
+    iterator insert(const_iterator pos, T &&val)
+    {
+        return emplace(pos, std::move(val));
+    }
+
+    iterator erase(const_iterator pos)
+    {
+        Node *node = as_node(const_cast<BaseNode *>(pos.m_node));
+        size_t idx = pos.m_index;
+
+        AllocTraits::destroy(m_alloc, &node->m_values[idx]);
+        for (size_t i = idx + 1; i < node->m_count; ++i)
+        {
+            AllocTraits::construct(m_alloc, &node->m_values[i - 1], std::move(node->m_values[i]));
+            AllocTraits::destroy(m_alloc, &node->m_values[i]);
+        }
+        --node->m_count;
+        --m_size;
+
+        if (node->m_count == 0)
+        {
+            BaseNode *next = node->m_next;
+            delete_node(node);
+            return iterator{next, 0};
+        }
+        if (node->m_count < K / 2 && node->m_next != &m_dummy)
+        {
+            Node *next = as_node(node->m_next);
+            if (node->m_count + next->m_count <= K)
+            {
+                try
+                {
+                    move_elements(next, 0, node);
+                }
+                catch (...)
+                {
+                    delete_node(next);
+                    throw;
+                }
+                delete_node(next);
+            }
+        }
+        if (idx < node->m_count)
+        {
+            return iterator{node, idx};
+        }
+        return iterator{node->m_next, 0};
+    }
+
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        // erasing can merge nodes, so `last` is tracked by how many elements are left to remove
+        size_t n = std::distance(first, last);
+        iterator it{const_cast<BaseNode *>(first.m_node), first.m_index};
+        while (n--)
+        {
+            it = erase(it);
+        }
+        return it;
+    }
+
+    void pop_front()
+    {
+        erase(cbegin());
+    }
+
+    void pop_back()
+    {
+        erase(--cend());
+    }
+
+    bool operator==(UnrolledList const &that) const noexcept
+    {
+        if (m_size != that.m_size)
+            return false;
+        auto it = cbegin();
+        for (auto const &val : that)
+        {
+            if (!(*it == val))
+                return false;
+            ++it;
+        }
+        return true;
+    }
+};
@@ -8,6 +8,7 @@
 #include <utility>
 #include <compare>
 #include <initializer_list>
+#include <vector>
 
 template <class T, class Alloc = std::allocator<T>>
 struct Vector
@@ -25,51 +26,61 @@ struct Vector
     using reverse_iterator = std::reverse_iterator<T *>;
     using const_reverse_iterator = std::reverse_iterator<T const *>;
 
+private:
+    using AllocTraits = std::allocator_traits<Alloc>;
+
+public:
     T *m_data;
     size_t m_size;
     size_t m_cap;
     [[no_unique_address]] Alloc m_alloc;
 
-    Vector()
+    Vector() : Vector(Alloc())
+    {
+    }
+
+    explicit Vector(Alloc const &alloc) noexcept : m_data(nullptr), m_size(0), m_cap(0), m_alloc(alloc)
     {
-        m_data = nullptr;
-        m_size = 0;
-        m_cap = 0;
     }
 
     Vector(std::initializer_list<T> ilist, Alloc const &alloc = Alloc()) : Vector(ilist.begin(), ilist.end(), alloc)
     {
     }
-    explicit Vector(size_t n, Alloc const &alloc = Alloc()) : m_alloc(alloc)
+    explicit Vector(size_t n, Alloc const &alloc = Alloc()) : Vector(alloc)
     {
-        m_data = m_alloc.allocate(n);
+        if (n == 0)
+            return;
+        m_data = AllocTraits::allocate(m_alloc, n);
         m_cap = m_size = n;
         for (size_t i = 0; i != n; i++)
         {
-            std::__construct_at(&m_data[i]);
+            AllocTraits::construct(m_alloc, &m_data[i]);
         }
     }
-    Vector(size_t n, T const &val, Alloc const &alloc = Alloc())
+    Vector(size_t n, T const &val, Alloc const &alloc = Alloc()) : Vector(alloc)
     {
-        m_data = m_alloc.allocate(n);
+        if (n == 0)
+            return;
+        m_data = AllocTraits::allocate(m_alloc, n);
         m_cap = n;
         m_size = n;
-        for (auto i = 0; i != n; ++i)
+        for (size_t i = 0; i != n; ++i)
         {
-            std::__construct_at(&m_data[i], val);
+            AllocTraits::construct(m_alloc, &m_data[i], val);
         }
     }
 
     template <std::random_access_iterator InputIt>
-    Vector(InputIt first, InputIt last, Alloc const &alloc = Alloc())
+    Vector(InputIt first, InputIt last, Alloc const &alloc = Alloc()) : Vector(alloc)
     {
-
-        m_size = last - first;
-        m_cap = m_size;
-        m_data = m_alloc.allocate(m_size);
-        for (auto i = 0; i < m_size; ++i)
+        size_t n = last - first;
+        if (n == 0)
+            return;
+        m_data = AllocTraits::allocate(m_alloc, n);
+        m_cap = m_size = n;
+        for (size_t i = 0; i < n; ++i)
         {
-            std::construct_at(&m_data[i], *first);
+            AllocTraits::construct(m_alloc, &m_data[i], *first);
             ++first;
         }
     }
@@ -78,7 +89,7 @@ struct Vector
     {
         for (size_t i = 0; i != m_size; i++)
         {
-            std::destroy_at(&m_data[i]);
+            AllocTraits::destroy(m_alloc, &m_data[i]);
         }
         m_size = 0;
     }
@@ -89,7 +100,7 @@ struct Vector
         {
             for (size_t i = n; i != m_size; i++)
             {
-                std::destroy_at(&m_data[i]);
+                AllocTraits::destroy(m_alloc, &m_data[i]);
             }
             m_size = n;
         }
@@ -98,7 +109,7 @@ struct Vector
             reserve(n);
             for (size_t i = m_size; i != n; i++)
             {
-                std::__construct_at(&m_data[i]);
+                AllocTraits::construct(m_alloc, &m_data[i]);
             }
         }
         m_size = n;
@@ -110,7 +121,7 @@ struct Vector
         {
             for (size_t i = n; i != m_size; i++)
             {
-                std::destroy_at(&m_data[i]);
+                AllocTraits::destroy(m_alloc, &m_data[i]);
             }
             m_size = n;
         }
@@ -119,7 +130,7 @@ struct Vector
             reserve(n);
             for (size_t i = m_size; i != n; i++)
             {
-                std::__construct_at(&m_data[i], val);
+                AllocTraits::construct(m_alloc, &m_data[i], val);
             }
         }
         m_size = n;
@@ -136,16 +147,16 @@ struct Vector
         }
         else
         {
-            m_data = m_alloc.allocate(m_size);
+            m_data = AllocTraits::allocate(m_alloc, m_size);
         }
         if (old_cap != 0) [[likely]]
         {
             for (size_t i = 0; i != m_size; i++)
             {
-                std::__construct_at(&m_data[i], std::move_if_noexcept(old_data[i])); // m_data[i] = std::move(old_data[i])
-                std::destroy_at(&old_data[i]);
+                AllocTraits::construct(m_alloc, &m_data[i], std::move_if_noexcept(old_data[i])); // m_data[i] = std::move(old_data[i])
+                AllocTraits::destroy(m_alloc, &old_data[i]);
             }
-            m_alloc.deallocate(old_data, old_cap);
+            AllocTraits::deallocate(m_alloc, old_data, old_cap);
         }
     }
 
@@ -154,15 +165,15 @@ struct Vector
         if (n <= m_cap)
             return;
         n = std::max(n, m_cap * 2);
-        T *new_data = m_alloc.allocate(n);
+        T *new_data = AllocTraits::allocate(m_alloc, n);
         for (size_t i = 0; i < m_size; ++i)
         {
-            std::construct_at(&new_data[i], std::move(m_data[i]));
-            std::destroy_at(&m_data[i]);
+            AllocTraits::construct(m_alloc, &new_data[i], std::move(m_data[i]));
+            AllocTraits::destroy(m_alloc, &m_data[i]);
         }
         if (m_data)
         {
-            m_alloc.deallocate(m_data, m_cap);
+            AllocTraits::deallocate(m_alloc, m_data, m_cap);
         }
         m_data = new_data;
         m_cap = n;
@@ -180,7 +191,7 @@ struct Vector
 
     [[nodiscard]] bool empty() const noexcept
     {
-        return m_data == nullptr;
+        return m_size == 0;
     }
 
     T const &operator[](size_t i) const noexcept
@@ -211,29 +222,48 @@ struct Vector
         that.m_cap = 0;
     }
 
-    Vector(Vector &&that, Alloc const &alloc) noexcept : m_data(that.m_data), m_size(that.m_size), m_cap(that.m_cap),
-                                                         m_alloc(alloc)
+    // Allocator-extended move: the buffer can only be stolen when `alloc` is able to free it,
+    // otherwise the elements are moved one by one into storage from `alloc`.
+    Vector(Vector &&that, Alloc const &alloc) noexcept(AllocTraits::is_always_equal::value)
+        : Vector(alloc)
     {
-        that.m_data = nullptr;
-        that.m_size = 0;
-        that.m_cap = 0;
+        if (AllocTraits::is_always_equal::value || m_alloc == that.m_alloc)
+        {
+            steal(that);
+        }
+        else if (that.m_size != 0)
+        {
+            move_from(that.m_data, that.m_size);
+            that.clear();
+        }
     }
-    Vector &operator=(Vector &&that) noexcept
+
+    Vector &operator=(Vector &&that) noexcept(AllocTraits::propagate_on_container_move_assignment::value ||
+                                              AllocTraits::is_always_equal::value)
     {
-        for (auto i = 0; i < m_size; ++i)
+        if (this == &that)
+            return *this;
+        if constexpr (!AllocTraits::propagate_on_container_move_assignment::value &&
+                      !AllocTraits::is_always_equal::value)
         {
-            std::destroy_at(&m_data[i]);
+            if (m_alloc != that.m_alloc)
+            {
+                clear();
+                move_from(that.m_data, that.m_size);
+                that.clear();
+                return *this;
+            }
         }
-        if (!m_cap)
+        clear();
+        if (m_cap)
         {
-            m_alloc.deallocate(m_data, m_cap);
+            AllocTraits::deallocate(m_alloc, m_data, m_cap);
         }
-        m_data = that.m_data;
-        m_size = that.m_size;
-        m_cap = that.m_cap;
-        that.m_data = nullptr;
-        that.m_size = 0;
-        that.m_cap = 0;
+        if constexpr (AllocTraits::propagate_on_container_move_assignment::value)
+        {
+            m_alloc = std::move(that.m_alloc);
+        }
+        steal(that);
         return *this;
     }
 
@@ -242,43 +272,41 @@ struct Vector
         std::swap(m_data, that.m_data);
         std::swap(m_size, that.m_size);
         std::swap(m_cap, that.m_cap);
-        std::swap(m_alloc, that.m_alloc);
+        if constexpr (AllocTraits::propagate_on_container_swap::value)
+        {
+            std::swap(m_alloc, that.m_alloc);
+        }
     }
 
     Vector(Vector const &that)
-        : m_alloc(that.m_alloc), m_size(that.m_size), m_cap(that.m_size), m_data(nullptr)
+        : Vector(that, AllocTraits::select_on_container_copy_construction(that.m_alloc))
     {
-        if (m_size != 0)
-        {
-            m_data = m_alloc.allocate(m_size);
-            std::uninitialized_copy(that.m_data, that.m_data + m_size, m_data);
-        }
     }
 
-    Vector(Vector const &that, Alloc const &alloc)
-        : m_alloc(alloc), m_size(that.m_size), m_cap(that.m_cap), m_data(nullptr)
+    Vector(Vector const &that, Alloc const &alloc) : Vector(that.begin(), that.end(), alloc)
     {
-        if (m_size != 0)
-        {
-            // 分配内存
-            m_data = m_alloc.allocate(m_size);
-
-            // 拷贝构造元素，提供异常安全性
-            for (size_t i = 0; i < m_size; ++i)
-            {
-                std::construct_at(&m_data[i], that.m_data[i]);
-            }
-        }
     }
 
-    Vector &operator=(Vector const &that) noexcept
+    Vector &operator=(Vector const &that)
     {
-        reserve(that.m_size);
-        m_size = that.m_size;
-        for (size_t i = 0; i != m_size; i++)
+        if (this == &that)
+            return *this;
+        if constexpr (AllocTraits::propagate_on_container_copy_assignment::value)
         {
-            std::construct_at(&m_data[i], that.m_data[i]);
+            if (m_alloc != that.m_alloc)
+            {
+                // the old buffer has to go back to the allocator that handed it out
+                clear();
+                if (m_cap)
+                {
+                    AllocTraits::deallocate(m_alloc, m_data, m_cap);
+                }
+                m_data = nullptr;
+                m_cap = 0;
+            }
+            m_alloc = that.m_alloc;
         }
+        assign(that.begin(), that.end());
         return *this;
     }
 
@@ -302,16 +330,43 @@ struct Vector
         return m_data[m_size - 1];
     }
 
+    template <class... Args>
+    T &emplace_back(Args &&...args)
+    {
+        if (m_size == m_cap)
+        {
+            // build the new element in the new buffer before moving the old ones out, so args may
+            // still refer to elements of this vector
+            size_t n = std::max<size_t>(m_cap * 2, 1);
+            T *new_data = AllocTraits::allocate(m_alloc, n);
+            AllocTraits::construct(m_alloc, &new_data[m_size], std::forward<Args>(args)...);
+            for (size_t i = 0; i < m_size; ++i)
+            {
+                AllocTraits::construct(m_alloc, &new_data[i], std::move_if_noexcept(m_data[i]));
+                AllocTraits::destroy(m_alloc, &m_data[i]);
+            }
+            if (m_cap)
+            {
+                AllocTraits::deallocate(m_alloc, m_data, m_cap);
+            }
+            m_data = new_data;
+            m_cap = n;
+        }
+        else
+        {
+            AllocTraits::construct(m_alloc, &m_data[m_size], std::forward<Args>(args)...);
+        }
+        return m_data[m_size++];
+    }
+
     void push_back(T const &val)
     {
-        std::construct_at(&m_data[m_size], std::move(val));
-        ++m_size;
+        emplace_back(val);
     }
 
     void push_back(T &&val)
     {
-        std::construct_at(&m_data[m_size], std::move(val));
-        ++m_size;
+        emplace_back(std::move(val));
     }
 
     T *data() noexcept
@@ -329,6 +384,56 @@ struct Vector
         return m_data;
     }
 
+    // Takes ownership of a buffer of `cap` slots obtained from get_allocator(), the first `size` of
+    // which hold constructed elements. The current contents are destroyed and freed first.
+    void adopt(T *data, size_t size, size_t cap)
+    {
+        clear();
+        if (m_cap)
+        {
+            AllocTraits::deallocate(m_alloc, m_data, m_cap);
+        }
+        m_data = data;
+        m_size = size;
+        m_cap = cap;
+    }
+
+    // Gives up ownership of the buffer without destroying the elements; read size() and capacity()
+    // beforehand, the caller must destroy and deallocate with get_allocator().
+    [[nodiscard]] T *release() noexcept
+    {
+        T *data = m_data;
+        m_data = nullptr;
+        m_size = 0;
+        m_cap = 0;
+        return data;
+    }
+
+    Alloc get_allocator() const noexcept
+    {
+        return m_alloc;
+    }
+
+    // std::vector cannot hand out or take over its buffer, so these move the elements across
+    // in a single allocation instead.
+    explicit Vector(std::vector<T, Alloc> &&that) : Vector(that.get_allocator())
+    {
+        move_from(that.data(), that.size());
+        that.clear();
+    }
+
+    std::vector<T, Alloc> to_std_vector() const &
+    {
+        return std::vector<T, Alloc>(begin(), end(), m_alloc);
+    }
+
+    std::vector<T, Alloc> to_std_vector() &&
+    {
+        std::vector<T, Alloc> ret(std::make_move_iterator(begin()), std::make_move_iterator(end()), m_alloc);
+        clear();
+        return ret;
+    }
+
     T *begin() noexcept
     {
         return m_data;
@@ -382,7 +487,7 @@ struct Vector
     void pop_back() noexcept
     {
         m_size -= 1;
-        std::destroy_at(&m_data[m_size]);
+        AllocTraits::destroy(m_alloc, &m_data[m_size]);
     }
 
     T *erase(T const *it) noexcept(std::is_nothrow_move_assignable_v<T>)
@@ -393,7 +498,7 @@ struct Vector
         {
             m_data[i] = std::move(m_data[i + 1]);
         }
-        std::destroy_at(&m_data[m_size]);
+        AllocTraits::destroy(m_alloc, &m_data[m_size]);
         return const_cast<T *>(it);
     }
     T *erase(const T *first, const T *last) noexcept(std::is_nothrow_move_assignable_v<T>)
@@ -407,7 +512,7 @@ struct Vector
         }
         for (size_t i = m_size - count; i < m_size; ++i)
         {
-            std::destroy_at(&m_data[i]);
+            AllocTraits::destroy(m_alloc, &m_data[i]);
         }
         m_size -= count;
         return const_cast<T *>(first);
@@ -420,7 +525,7 @@ struct Vector
         m_size = n;
         for (auto i = 0; i < n; ++i)
         {
-            std::construct_at(&m_data[i], val);
+            AllocTraits::construct(m_alloc, &m_data[i], val);
         }
     }
 
@@ -433,7 +538,7 @@ struct Vector
         m_size = n;
         for (auto i = 0; i < n; ++i)
         {
-            std::construct_at(&m_data[i], *first);
+            AllocTraits::construct(m_alloc, &m_data[i], *first);
             ++first;
         }
     }
@@ -449,38 +554,58 @@ struct Vector
         return *this;
     }
 
-    T *insert(T const *it, T &&val)
+    // The element is built before anything moves, so the arguments may refer to elements of the
+    // vector and a throwing constructor leaves it untouched. It is built through the allocator, in
+    // raw storage, so it gets the same allocator as the elements it joins.
+    template <class... Args>
+    T *emplace(T const *it, Args &&...args)
     {
-        auto idx = it - m_data;
-        if (m_size + 1 >= m_cap)
+        size_t idx = static_cast<size_t>(it - m_data);
+        if (idx == m_size)
         {
-            reserve(m_size + 1);
+            return &emplace_back(std::forward<Args>(args)...);
         }
-        for (auto i = m_size; i > idx; --i)
+        alignas(T) std::byte tmp_storage[sizeof(T)];
+        T *tmp = reinterpret_cast<T *>(tmp_storage);
+        AllocTraits::construct(m_alloc, tmp, std::forward<Args>(args)...);
+        size_t hole = m_size;
+        try
+        {
+            if (m_size + 1 > m_cap)
+            {
+                reserve(m_size + 1);
+            }
+            for (; hole > idx; --hole)
+            {
+                AllocTraits::construct(m_alloc, &m_data[hole], std::move(m_data[hole - 1]));
+                AllocTraits::destroy(m_alloc, &m_data[hole - 1]);
+            }
+            AllocTraits::construct(m_alloc, &m_data[idx], std::move(*tmp));
+        }
+        catch (...)
         {
-            std::construct_at(&m_data[i], std::move(m_data[i - 1]));
-            std::destroy_at(&m_data[i - 1]);
+            // a move constructor threw and left a hole; drop the elements above it
+            for (size_t i = hole + 1; i <= m_size; ++i)
+            {
+                AllocTraits::destroy(m_alloc, &m_data[i]);
+            }
+            m_size = hole;
+            AllocTraits::destroy(m_alloc, tmp);
+            throw;
         }
+        AllocTraits::destroy(m_alloc, tmp);
         m_size++;
-        std::construct_at(&m_data[idx], std::move(val));
         return m_data + idx;
     }
 
+    T *insert(T const *it, T &&val)
+    {
+        return emplace(it, std::move(val));
+    }
+
     T *insert(T const *it, T const &val)
     {
-        auto idx = it - m_data;
-        if (m_size + 1 >= m_cap)
-        {
-            reserve(m_size + 1);
-        }
-        for (auto i = m_size; i > idx; --i)
-        {
-            std::construct_at(&m_data[i], std::move(m_data[i - 1]));
-            std::destroy_at(&m_data[i - 1]);
-        }
-        m_size++;
-        std::construct_at(&m_data[idx], val);
-        return m_data + idx;
+        return emplace(it, val);
     }
 
     T *insert(T const *it, size_t n, T const &val)
@@ -495,15 +620,15 @@ struct Vector
 
         for (auto i = m_size; i > idx; --i)
         {
-            std::construct_at(&m_data[i + n - 1], std::move(m_data[i - 1]));
-            std::destroy_at(&m_data[i - 1]);
+            AllocTraits::construct(m_alloc, &m_data[i + n - 1], std::move(m_data[i - 1]));
+            AllocTraits::destroy(m_alloc, &m_data[i - 1]);
         }
 
         m_size += n;
 
         for (auto i = idx; i < idx + n; ++i)
         {
-            std::construct_at(&m_data[i], val);
+            AllocTraits::construct(m_alloc, &m_data[i], val);
         }
 
         return m_data + idx;
@@ -524,14 +649,14 @@ struct Vector
 
         for (auto i = m_size; i > idx; --i)
         {
-            std::construct_at(&m_data[i + num - 1], std::move(m_data[i - 1]));
-            std::destroy_at(&m_data[i - 1]);
+            AllocTraits::construct(m_alloc, &m_data[i + num - 1], std::move(m_data[i - 1]));
+            AllocTraits::destroy(m_alloc, &m_data[i - 1]);
         }
         m_size += num;
 
         for (auto i = idx; i < idx + num; ++i)
         {
-            std::construct_at(&m_data[i], *first);
+            AllocTraits::construct(m_alloc, &m_data[i], *first);
             ++first;
         }
 
@@ -543,15 +668,37 @@ struct Vector
         return insert(it, ilist.begin(), ilist.end());
     }
 
+private:
+    // moves n elements into this vector, which must be empty
+    void move_from(T *first, size_t n)
+    {
+        reserve(n);
+        for (; m_size < n; ++m_size)
+        {
+            AllocTraits::construct(m_alloc, &m_data[m_size], std::move(first[m_size]));
+        }
+    }
+
+    void steal(Vector &that) noexcept
+    {
+        m_data = that.m_data;
+        m_size = that.m_size;
+        m_cap = that.m_cap;
+        that.m_data = nullptr;
+        that.m_size = 0;
+        that.m_cap = 0;
+    }
+
+public:
     ~Vector()
     {
         for (auto i = 0; i != m_size; ++i)
         {
-            std::destroy_at(&m_data[i]);
+            AllocTraits::destroy(m_alloc, &m_data[i]);
         }
-        if (!m_cap)
+        if (m_cap)
         {
-            m_alloc.deallocate(m_data, m_cap);
+            AllocTraits::deallocate(m_alloc, m_data, m_cap);
         }
     }
 
@@ -0,0 +1,82 @@
+#include <catch2/catch_test_macros.hpp>
+#include <miniSTL/stl.hpp>
+#include <algorithm>
+#include <list>
+#include <memory_resource>
+#include <string>
+
+TEST_CASE("test compact list", "[compact_list]") {
+
+    SECTION("test constructor") {
+        CompactList<int> lst({0, 1, 2});
+        int i = 0;
+        for (auto item : lst)
+            REQUIRE(item == i++);
+        CompactList<int> copy(lst);
+        REQUIRE(copy == lst);
+        CompactList<int> moved(std::move(copy));
+        REQUIRE(moved == lst);
+        REQUIRE(copy.empty());
+    }
+
+    SECTION("test insert() erase() reuse free slots") {
+        CompactList<std::string> lst;
+        std::list<std::string> ref;
+        for (int i = 0; i < 100; i++) {
+            lst.push_back(std::to_string(i));
+            ref.push_back(std::to_string(i));
+        }
+        auto it = lst.begin();
+        auto ref_it = ref.begin();
+        while (it != lst.end()) {
+            it = lst.erase(it);
+            ref_it = ref.erase(ref_it);
+            if (it != lst.end()) {
+                ++it;
+                ++ref_it;
+            }
+        }
+        REQUIRE(lst.size() == 50);
+        REQUIRE(lst.arena_size() == 100);
+        for (int i = 0; i < 50; i++) {
+            lst.push_front(std::to_string(-i));
+            ref.push_front(std::to_string(-i));
+        }
+        REQUIRE(lst.arena_size() == 100);
+        REQUIRE(std::equal(lst.begin(), lst.end(), ref.begin(), ref.end()));
+        REQUIRE(std::equal(lst.rbegin(), lst.rend(), ref.rbegin(), ref.rend()));
+    }
+
+    SECTION("test compact()") {
+        CompactList<int> lst;
+        for (int i = 0; i < 10; i++)
+            lst.push_front(i);
+        lst.erase(lst.begin());
+        lst.pop_back();
+        lst.compact();
+        REQUIRE(lst.arena_size() == 8);
+        int i = 8;
+        for (auto item : lst)
+            REQUIRE(item == i--);
+        REQUIRE(lst.back() == 1);
+        lst.push_back(0);
+        REQUIRE(lst.arena_size() == 9);
+    }
+
+    SECTION("test pmr") {
+        std::pmr::monotonic_buffer_resource arena;
+        CompactList<std::pmr::string, std::pmr::polymorphic_allocator<std::pmr::string>> lst(&arena);
+        std::pmr::string val("a string long enough to skip the small buffer");
+        for (int i = 0; i < 100; i++) {
+            if (i % 2)
+                lst.push_back(val);
+            else
+                lst.emplace_front("another string long enough to skip the small buffer");
+        }
+        lst.erase(lst.begin());
+        lst.compact();
+        REQUIRE(lst.size() == 99);
+        for (auto const &item : lst)
+            REQUIRE(item.get_allocator().resource() == &arena);
+    }
+}
@@ -0,0 +1,163 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <miniSTL/stl.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+TEST_CASE("test concurrent hash map", "[concurrent_hash_map]") {
+
+    SECTION("test single thread") {
+        ConcurrentHashMap<std::string, int> map(3);
+        REQUIRE(map.shard_count() == 4);
+        REQUIRE(map.try_emplace("a", 1));
+        REQUIRE(!map.try_emplace("a", 2));
+        REQUIRE(!map.insert_or_assign("a", 3));
+        REQUIRE(map.insert_or_assign("b", 4));
+        REQUIRE(*map.find("a") == 3);
+        REQUIRE(!map.find("z"));
+        REQUIRE(map.update("b", [](int &v) { v *= 10; }));
+        int seen = 0;
+        REQUIRE(map.visit("b", [&](int const &v) { seen = v; }));
+        REQUIRE(seen == 40);
+        REQUIRE(map.compute_if_absent("c", [] { return 7; }) == 7);
+        REQUIRE(map.compute_if_absent("c", [] { return 8; }) == 7);
+        REQUIRE(map.size() == 3);
+        REQUIRE(map.erase("a") == 1);
+        REQUIRE(!map.contains("a"));
+        int total = 0;
+        map.for_each([&](std::string const &, int v) { total += v; });
+        REQUIRE(total == 47);
+        map.clear();
+        REQUIRE(map.empty());
+    }
+
+    SECTION("test many threads") {
+        ConcurrentHashMap<int, int> map(16);
+        std::atomic<int> created = 0;
+        std::atomic<int> missing = 0;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 8; t++) {
+            threads.emplace_back([&, t] {
+                for (int i = 0; i < 5000; i++) {
+                    map.compute_if_absent(i, [&] {
+                        created++;
+                        return i;
+                    });
+                    map.update(i, [](int &v) { v++; });
+                    map.insert_or_assign(100000 + t * 5000 + i, i);
+                    if (i % 2)
+                        map.erase(100000 + t * 5000 + i);
+                    if (!map.find(i))
+                        missing++;
+                }
+            });
+        }
+        for (auto &t : threads)
+            t.join();
+        REQUIRE(created == 5000);
+        REQUIRE(missing == 0);
+        REQUIRE(map.size() == 5000 + 8 * 2500);
+        for (int i = 0; i < 5000; i++)
+            REQUIRE(*map.find(i) == i + 8);
+    }
+
+    SECTION("test lock-free reads race writers") {
+        // readers must never see a torn pair, however the writers resize, update and erase
+        struct Pair {
+            uint64_t value;
+            uint64_t check;
+        };
+        ConcurrentHashMap<uint64_t, Pair> map(2);
+        std::atomic<bool> done = false;
+        std::atomic<int> torn = 0;
+        std::atomic<int> lost = 0;
+        map.try_emplace(0, Pair{0, ~uint64_t(0)});
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; t++) {
+            threads.emplace_back([&, t] {
+                for (uint64_t i = t; !done; i = (i + 7919) % 20000) {
+                    if (auto pair = map.find(i); pair && pair->check != ~pair->value)
+                        torn++;
+                    if (!map.contains(0))
+                        lost++;
+                }
+            });
+        }
+        for (int t = 0; t < 2; t++) {
+            threads.emplace_back([&, t] {
+                for (uint64_t i = 1; i < 20000; i++) {
+                    uint64_t key = t ? 20000 - i : i;
+                    map.insert_or_assign(key, Pair{key * t, ~(key * t)});
+                    map.update(key / 2, [](Pair &pair) { pair.check = ~++pair.value; });
+                    if (key % 3 == 0)
+                        map.erase(key);
+                }
+            });
+        }
+        threads[4].join();
+        threads[5].join();
+        done = true;
+        for (int t = 0; t < 4; t++)
+            threads[t].join();
+        REQUIRE(torn == 0);
+        REQUIRE(lost == 0);
+        map.for_each([](uint64_t, Pair const &pair) { REQUIRE(pair.check == ~pair.value); });
+    }
+
+    SECTION("test heterogeneous lookup") {
+        struct StringHash {
+            using is_transparent = void;
+            size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+        };
+        ConcurrentHashMap<std::string, int, StringHash, std::equal_to<>> map(4);
+        map.try_emplace("alpha", 1);
+        std::string_view key = "alpha";
+        REQUIRE(*map.find(key) == 1);
+        REQUIRE(map.contains("alpha"));
+        REQUIRE(map.count(std::string_view("beta")) == 0);
+        REQUIRE(map.update(key, [](int &v) { v++; }));
+        REQUIRE(map.visit(key, [](int v) { REQUIRE(v == 2); }));
+        REQUIRE(map.erase(key) == 1);
+        REQUIRE(map.empty());
+    }
+}
+
+TEST_CASE("benchmark concurrent hash map", "[.benchmark][concurrent_hash_map]") {
+    // find() reads through the seqlock, visit() takes the shard's shared lock
+    ConcurrentHashMap<uint64_t, uint64_t> map;
+    for (uint64_t i = 0; i < 100000; i++)
+        map.try_emplace(i, i);
+    unsigned thread_count = std::max(2u, std::thread::hardware_concurrency());
+    auto run = [&](unsigned threads, auto lookup) {
+        std::atomic<uint64_t> sum = 0;
+        std::vector<std::thread> pool;
+        for (unsigned t = 0; t < threads; t++) {
+            pool.emplace_back([&, t] {
+                uint64_t local = 0;
+                for (uint64_t i = t; i < 400000; i += threads)
+                    local += lookup(i * 7919 % 100000);
+                sum += local;
+            });
+        }
+        for (auto &thread : pool)
+            thread.join();
+        return sum.load();
+    };
+    auto by_find = [&](uint64_t key) { return *map.find(key); };
+    auto by_visit = [&](uint64_t key) {
+        uint64_t val = 0;
+        map.visit(key, [&](uint64_t v) { val = v; });
+        return val;
+    };
+
+    BENCHMARK("find, 1 thread") { return run(1, by_find); };
+    BENCHMARK("visit, 1 thread") { return run(1, by_visit); };
+    BENCHMARK("find, all threads") { return run(thread_count, by_find); };
+    BENCHMARK("visit, all threads") { return run(thread_count, by_visit); };
+}
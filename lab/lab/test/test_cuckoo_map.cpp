@@ -0,0 +1,166 @@
+#include <catch2/catch_test_macros.hpp>
+#include <miniSTL/stl.hpp>
+#include <array>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+TEST_CASE("test cuckoo map", "[cuckoo_map]") {
+
+    SECTION("test constructor") {
+        CuckooMap<std::string, int> map({{"a", 1}, {"b", 2}, {"a", 3}});
+        REQUIRE(map.size() == 2);
+        REQUIRE(map.at("a") == 1);
+        CuckooMap<std::string, int> copy(map);
+        REQUIRE(copy == map);
+        CuckooMap<std::string, int> moved(std::move(copy));
+        REQUIRE(moved == map);
+        REQUIRE(copy.empty());
+        copy = moved;
+        REQUIRE(copy == map);
+        REQUIRE_THROWS_AS(map.at("z"), std::out_of_range);
+    }
+
+    SECTION("test against std::unordered_map") {
+        CuckooMap<int, std::string> map;
+        std::unordered_map<int, std::string> ref;
+        std::mt19937 rng(7);
+        for (int i = 0; i < 200000; i++) {
+            int key = rng() % 4000;
+            switch (rng() % 3) {
+            case 0:
+                REQUIRE(map.try_emplace(key, std::to_string(i)).second == ref.try_emplace(key, std::to_string(i)).second);
+                break;
+            case 1:
+                map[key] += "x";
+                ref[key] += "x";
+                break;
+            default:
+                REQUIRE(map.erase(key) == ref.erase(key));
+            }
+        }
+        REQUIRE(map.size() == ref.size());
+        for (auto &[key, val] : ref)
+            REQUIRE(map.at(key) == val);
+        for (int key = 0; key < 4000; key++)
+            REQUIRE(map.contains(key) == ref.contains(key));
+    }
+
+    SECTION("test high load without growing") {
+        CuckooMap<int, int> map;
+        map.reserve(14000);
+        size_t capacity = map.capacity();
+        for (int i = 0; i < 14000; i++)
+            map[i * 64] = i;
+        REQUIRE(map.capacity() == capacity);
+        REQUIRE(map.load_factor() > 0.85f);
+        REQUIRE(map.stash_size() <= CuckooMap<int, int>::stash_capacity);
+        for (int i = 0; i < 14000; i++)
+            REQUIRE(map.at(i * 64) == i);
+        for (int i = 0; i < 14000; i += 2)
+            map.erase(i * 64);
+        for (int i = 0; i < 14000; i++)
+            REQUIRE(map.contains(i * 64) == (i % 2 == 1));
+    }
+
+    SECTION("test many keys sharing few hashes") {
+        struct BadHash {
+            size_t operator()(int key) const { return key % 16; }
+        };
+        CuckooMap<int, int, BadHash> map;
+        for (int i = 0; i < 100; i++)
+            map.emplace(i, i);
+        REQUIRE(map.size() == 100);
+        for (int i = 0; i < 100; i++)
+            REQUIRE(map.at(i) == i);
+    }
+
+    SECTION("test degenerate hash") {
+        struct ConstantHash {
+            size_t operator()(int) const { return 42; }
+        };
+        using Map = CuckooMap<int, int, ConstantHash>;
+        size_t const fit = 2 * Map::bucket_width + Map::stash_capacity;
+        Map map;
+        for (int i = 0; i < int(fit); i++)
+            map.emplace(i, i);
+        REQUIRE_THROWS_AS(map.emplace(int(fit), 0), std::length_error);
+        REQUIRE(map.bucket_count() * Map::bucket_width <= 16 * 2 * fit);
+        REQUIRE(map.size() == fit);
+        REQUIRE_FALSE(map.contains(int(fit)));
+        for (int i = 0; i < int(fit); i++)
+            REQUIRE(map.at(i) == i);
+        map.erase(0);
+        map.emplace(int(fit), 0);
+        REQUIRE(map.size() == fit);
+    }
+
+    SECTION("test erase() while iterating") {
+        CuckooMap<int, int> map;
+        for (int i = 0; i < 1000; i++)
+            map.emplace(i, i);
+        for (auto it = map.begin(); it != map.end();) {
+            if (it->first % 3 == 0)
+                it = map.erase(it);
+            else
+                ++it;
+        }
+        REQUIRE(map.size() == 666);
+        for (int i = 0; i < 1000; i++)
+            REQUIRE(map.contains(i) == (i % 3 != 0));
+    }
+
+    SECTION("test find_many() contains_many()") {
+        CuckooMap<int, int> map;
+        std::vector<int> keys;
+        for (int i = 0; i < 1000; i++) {
+            map.emplace(i * 3, i);
+            keys.push_back(i * 2);
+        }
+        std::vector<int *> found(keys.size());
+        map.find_many(keys, found);
+        std::vector<bool> flags;
+        REQUIRE(map.contains_many(keys, std::back_inserter(flags)) == 334);
+        REQUIRE(flags.size() == keys.size());
+        for (size_t i = 0; i < keys.size(); i++) {
+            REQUIRE(found[i] == (keys[i] % 3 == 0 ? &map.at(keys[i]) : nullptr));
+            REQUIRE(flags[i] == (keys[i] % 3 == 0));
+        }
+        CuckooMap<int, int> const &cmap = map;
+        std::vector<int const *> cfound(3);
+        cmap.find_many(std::vector<int>({0, 1, 3}), cfound);
+        REQUIRE(cfound == std::vector<int const *>({&map.at(0), nullptr, &map.at(3)}));
+        CuckooMap<int, int> empty;
+        empty.find_many(keys, found);
+        REQUIRE(found[0] == nullptr);
+        found.pop_back();
+        REQUIRE_THROWS_AS(map.find_many(keys, found), std::invalid_argument);
+        std::array<bool, 3> few;
+        REQUIRE(empty.contains_many(std::vector<int>({0, 1, 3}), few.begin()) == 0);
+        REQUIRE(few == std::array<bool, 3>{});
+    }
+
+    SECTION("test heterogeneous lookup") {
+        struct StringHash {
+            using is_transparent = void;
+            size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+        };
+        CuckooMap<std::string, int, StringHash, std::equal_to<>> map;
+        map["alpha"] = 1;
+        map["beta"] = 2;
+        std::string_view key = "alpha";
+        REQUIRE(map.find(key)->second == 1);
+        REQUIRE(map.contains("beta"));
+        REQUIRE(map.count(std::string_view("gamma")) == 0);
+        REQUIRE(map.find("gamma") == map.end());
+        REQUIRE(map.erase(key) == 1);
+        REQUIRE(map.erase("gamma") == 0);
+        REQUIRE(!map.contains(key));
+        REQUIRE(map.size() == 1);
+    }
+}
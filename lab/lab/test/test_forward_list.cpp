@@ -0,0 +1,107 @@
+#include <catch2/catch_test_macros.hpp>
+#include <miniSTL/stl.hpp>
+#include <stdexcept>
+#include <string>
+
+// throws from the copy constructor once `copies_left` copies have been made
+struct ThrowingCopy {
+    static inline int copies_left = 0;
+    static inline int live = 0;
+    std::string m_value = "a string long enough to skip the small buffer";
+
+    ThrowingCopy() { ++live; }
+    ThrowingCopy(ThrowingCopy const &that) : m_value(that.m_value) {
+        if (copies_left-- == 0)
+            throw std::runtime_error("copy");
+        ++live;
+    }
+    ~ThrowingCopy() { --live; }
+};
+
+TEST_CASE("test forward list", "[forward_list]") {
+
+    SECTION("test constructor") {
+        ForwardList<int> lst({0, 1, 2});
+        int i = 0;
+        for (auto item : lst)
+            REQUIRE(item == i++);
+        REQUIRE(i == 3);
+        ForwardList<int> copy(lst);
+        REQUIRE(copy == lst);
+        ForwardList<int> moved(std::move(copy));
+        REQUIRE(moved == lst);
+        REQUIRE(copy.empty());
+        REQUIRE(ForwardList<int>(3, 7) == ForwardList<int>({7, 7, 7}));
+    }
+
+    SECTION("test push_front() insert_after() erase_after()") {
+        ForwardList<std::string> lst;
+        lst.push_front("c");
+        lst.emplace_front("a");
+        auto it = lst.insert_after(lst.begin(), "b");
+        REQUIRE(*it == "b");
+        lst.insert_after(it, {"b1", "b2"});
+        REQUIRE(lst == ForwardList<std::string>({"a", "b", "b1", "b2", "c"}));
+        auto next = lst.erase_after(lst.begin());
+        REQUIRE(*next == "b1");
+        lst.erase_after(lst.begin(), lst.end());
+        REQUIRE(lst == ForwardList<std::string>({"a"}));
+        lst.pop_front();
+        REQUIRE(lst.empty());
+    }
+
+    SECTION("test splice_after()") {
+        ForwardList<int> a({0, 4});
+        ForwardList<int> b({1, 2, 3});
+        a.splice_after(a.begin(), b);
+        REQUIRE(a == ForwardList<int>({0, 1, 2, 3, 4}));
+        REQUIRE(b.empty());
+        b.splice_after(b.before_begin(), a, a.before_begin());
+        REQUIRE(b == ForwardList<int>({0}));
+        auto last = a.begin();
+        ++last;
+        ++last;
+        b.splice_after(b.begin(), a, a.before_begin(), last);
+        REQUIRE(b == ForwardList<int>({0, 1, 2}));
+        REQUIRE(a == ForwardList<int>({3, 4}));
+    }
+
+    SECTION("test sharing a NodePool with List") {
+        NodePool pool(sizeof(ListValueNode<int>), alignof(ListValueNode<int>), 16);
+        ForwardList<int, PoolAllocator<int>> fwd(&pool);
+        List<int, PoolAllocator<int>> lst(&pool);
+        for (int i = 0; i < 16; i++) {
+            fwd.push_front(i);
+            lst.push_back(i);
+        }
+        REQUIRE(pool.block_count() == 2);
+        fwd.clear();
+        for (int i = 0; i < 16; i++)
+            lst.push_back(i);
+        REQUIRE(pool.block_count() == 2);
+    }
+
+    SECTION("test throwing copies") {
+        {
+            ThrowingCopy val;
+            ThrowingCopy::copies_left = 2;
+            REQUIRE_THROWS_AS(ForwardList<ThrowingCopy>(5, val), std::runtime_error);
+            REQUIRE(ThrowingCopy::live == 1);
+
+            ForwardList<ThrowingCopy> src;
+            for (int i = 0; i < 4; i++)
+                src.emplace_front();
+            ThrowingCopy::copies_left = 2;
+            REQUIRE_THROWS_AS(ForwardList<ThrowingCopy>(src), std::runtime_error);
+            REQUIRE(ThrowingCopy::live == 5);
+
+            ForwardList<ThrowingCopy> dst;
+            dst.emplace_front();
+            ThrowingCopy::copies_left = 3;
+            REQUIRE_THROWS_AS(dst = src, std::runtime_error);
+            REQUIRE(std::distance(dst.begin(), dst.end()) == 3);
+            REQUIRE(ThrowingCopy::live == 8);
+        }
+        REQUIRE(ThrowingCopy::live == 0);
+    }
+}
@@ -0,0 +1,116 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <miniSTL/stl.hpp>
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+TEST_CASE("test hash", "[hash]") {
+
+    SECTION("test equal values hash equal") {
+        std::string str = "the quick brown fox jumps over the lazy dog";
+        for (size_t len = 0; len <= str.size(); len++) {
+            std::string_view view(str.data(), len);
+            REQUIRE(FastHash<std::string>()(std::string(view)) == FastHash<std::string_view>()(view));
+            REQUIRE(hash_bytes(view.data(), len) == hash_value(view));
+        }
+        REQUIRE(FastHash<std::string>()("abc") == FastHash<std::string>()(std::string_view("abc")));
+        REQUIRE(FastHash<double>()(0.0) == FastHash<double>()(-0.0));
+        REQUIRE(FastHash<std::pair<int, std::string>>()({1, "a"}) == hash_values(0, 1, std::string("a")));
+        REQUIRE(hash_values(0, 1, 2) != hash_values(0, 2, 1));
+    }
+
+    SECTION("test seeds change every hash") {
+        FastHash<int> a(1), b(2);
+        FastHash<std::string> c(1), d(2);
+        for (int i = 0; i < 100; i++) {
+            REQUIRE(a(i) != b(i));
+            REQUIRE(c(std::to_string(i)) != d(std::to_string(i)));
+        }
+        REQUIRE(random_hash_seed() == random_hash_seed());
+    }
+
+    SECTION("test avalanche") {
+        // flipping one input bit flips each output bit with probability close to 1/2
+        std::mt19937_64 rng(1);
+        for (int round = 0; round < 2; round++) {
+            double flipped = 0;
+            int trials = 0;
+            for (int i = 0; i < 2000; i++) {
+                uint64_t x = rng();
+                char bytes[24];
+                for (int j = 0; j < 24; j++)
+                    bytes[j] = static_cast<char>(rng());
+                for (int bit = 0; bit < 64; bit++) {
+                    uint64_t before, after;
+                    if (round == 0) {
+                        before = hash_int(x);
+                        after = hash_int(x ^ (uint64_t(1) << bit));
+                    } else {
+                        before = hash_bytes(bytes, sizeof(bytes));
+                        bytes[bit / 8] ^= static_cast<char>(1 << (bit % 8));
+                        after = hash_bytes(bytes, sizeof(bytes));
+                    }
+                    flipped += std::popcount(before ^ after);
+                    trials++;
+                }
+            }
+            double mean = flipped / trials;
+            REQUIRE(mean > 31.0);
+            REQUIRE(mean < 33.0);
+        }
+    }
+
+    SECTION("test low bits of strided integers") {
+        // a power-of-two table indexes with the low bits; strided keys must still fill it evenly
+        std::vector<int> buckets(1024);
+        for (uint64_t i = 0; i < 1024 * 16; i++)
+            buckets[hash_int(i * 4096) & 1023]++;
+        for (int n : buckets) {
+            REQUIRE(n > 0);
+            REQUIRE(n < 48);
+        }
+    }
+
+    SECTION("test as the default hasher") {
+        HashMap<std::pair<int, int>, int> map;
+        for (int i = 0; i < 100; i++)
+            map[{i, -i}] = i;
+        REQUIRE(map.at({42, -42}) == 42);
+        HashMap<std::string, int, FastHash<std::string>, std::equal_to<>> strings(0, FastHash<std::string>(random_hash_seed()));
+        strings["key"] = 1;
+        REQUIRE(strings.contains(std::string_view("key")));
+    }
+}
+
+TEST_CASE("benchmark hash", "[.benchmark][hash]") {
+    std::string short_str = "user:12345";
+    std::string long_str(4096, 'x');
+    std::vector<uint64_t> strided;
+    for (uint64_t i = 0; i < 1 << 16; i++)
+        strided.push_back(i << 12);
+
+    BENCHMARK("std::hash short string") { return std::hash<std::string>{}(short_str); };
+    BENCHMARK("FastHash short string") { return FastHash<std::string>{}(short_str); };
+    BENCHMARK("std::hash 4 KiB string") { return std::hash<std::string>{}(long_str); };
+    BENCHMARK("FastHash 4 KiB string") { return FastHash<std::string>{}(long_str); };
+
+    BENCHMARK("HashMap<uint64_t> strided keys, std::hash") {
+        HashMap<uint64_t, int, std::hash<uint64_t>> map;
+        for (uint64_t key : strided)
+            map[key] = 1;
+        return map.size();
+    };
+    BENCHMARK("HashMap<uint64_t> strided keys, FastHash") {
+        HashMap<uint64_t, int> map;
+        for (uint64_t key : strided)
+            map[key] = 1;
+        return map.size();
+    };
+}
@@ -0,0 +1,166 @@
+#include <catch2/catch_test_macros.hpp>
+#include <miniSTL/stl.hpp>
+#include <array>
+#include <functional>
+#include <iterator>
+#include <memory_resource>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+TEST_CASE("test hash map", "[hash_map]") {
+
+    SECTION("test constructor") {
+        HashMap<std::string, int> map({{"a", 1}, {"b", 2}, {"a", 3}});
+        REQUIRE(map.size() == 2);
+        REQUIRE(map.at("a") == 1);
+        HashMap<std::string, int> copy(map);
+        REQUIRE(copy == map);
+        HashMap<std::string, int> moved(std::move(copy));
+        REQUIRE(moved == map);
+        REQUIRE(copy.empty());
+        copy = moved;
+        REQUIRE(copy == map);
+        REQUIRE_THROWS_AS(map.at("z"), std::out_of_range);
+    }
+
+    SECTION("test against std::unordered_map") {
+        HashMap<int, int> map;
+        std::unordered_map<int, int> ref;
+        std::mt19937 rng(11);
+        for (int i = 0; i < 200000; i++) {
+            int key = rng() % 4000;
+            switch (rng() % 4) {
+            case 0:
+                REQUIRE(map.insert({key, i}).second == ref.insert({key, i}).second);
+                break;
+            case 1:
+                map.insert_or_assign(key, i);
+                ref.insert_or_assign(key, i);
+                break;
+            case 2:
+                map[key] += 1;
+                ref[key] += 1;
+                break;
+            default:
+                REQUIRE(map.erase(key) == ref.erase(key));
+            }
+        }
+        REQUIRE(map.size() == ref.size());
+        size_t seen = 0;
+        for (auto &[key, val] : map) {
+            REQUIRE(ref.at(key) == val);
+            seen++;
+        }
+        REQUIRE(seen == ref.size());
+        for (int key = 0; key < 4000; key++)
+            REQUIRE(map.contains(key) == ref.contains(key));
+    }
+
+    SECTION("test tombstones are rehashed in place") {
+        HashMap<int, int> map;
+        map.reserve(1000);
+        size_t capacity = map.capacity();
+        for (int round = 0; round < 50; round++) {
+            for (int i = 0; i < 800; i++)
+                map.try_emplace(round * 800 + i, i);
+            for (int i = 0; i < 800; i++)
+                REQUIRE(map.erase(round * 800 + i) == 1);
+        }
+        REQUIRE(map.empty());
+        REQUIRE(map.capacity() == capacity);
+    }
+
+    SECTION("test identity hash") {
+        // std::hash leaves these keys as they are: H2 would be 0 and H1 one group for all of them
+        // without the extra mixing step
+        HashMap<uint64_t, int, std::hash<uint64_t>> map;
+        for (uint64_t i = 0; i < 20000; i++)
+            REQUIRE(map.try_emplace(i << 40, int(i)).second);
+        REQUIRE(map.size() == 20000);
+        for (uint64_t i = 0; i < 20000; i++)
+            REQUIRE(map.at(i << 40) == int(i));
+        REQUIRE_FALSE(map.contains(uint64_t(1) << 39));
+        for (uint64_t i = 0; i < 20000; i += 2)
+            REQUIRE(map.erase(i << 40) == 1);
+        for (uint64_t i = 0; i < 20000; i++)
+            REQUIRE(map.contains(i << 40) == (i % 2 == 1));
+    }
+
+    SECTION("test erase() while iterating") {
+        HashMap<int, std::string> map;
+        for (int i = 0; i < 100; i++)
+            map.emplace(i, std::to_string(i));
+        for (auto it = map.begin(); it != map.end();) {
+            if (it->first % 2)
+                it = map.erase(it);
+            else
+                ++it;
+        }
+        REQUIRE(map.size() == 50);
+        REQUIRE(map.find(3) == map.end());
+        REQUIRE(map.find(4)->second == "4");
+    }
+
+    SECTION("test pmr") {
+        std::pmr::monotonic_buffer_resource arena;
+        HashMap<int, std::pmr::string, std::hash<int>, std::equal_to<int>,
+                std::pmr::polymorphic_allocator<std::pair<int const, std::pmr::string>>>
+            map(&arena);
+        for (int i = 0; i < 100; i++)
+            map.try_emplace(i, "a long enough string to leave the SSO buffer");
+        REQUIRE(map.at(42).get_allocator().resource() == &arena);
+    }
+
+    SECTION("test find_many() contains_many()") {
+        HashMap<int, int> map;
+        std::vector<int> keys;
+        for (int i = 0; i < 1000; i++) {
+            map.emplace(i * 3, i);
+            keys.push_back(i * 2);
+        }
+        std::vector<int *> found(keys.size());
+        map.find_many(keys, found);
+        std::vector<bool> flags;
+        REQUIRE(map.contains_many(keys, std::back_inserter(flags)) == 334);
+        REQUIRE(flags.size() == keys.size());
+        for (size_t i = 0; i < keys.size(); i++) {
+            REQUIRE(found[i] == (keys[i] % 3 == 0 ? &map.at(keys[i]) : nullptr));
+            REQUIRE(flags[i] == (keys[i] % 3 == 0));
+        }
+        HashMap<int, int> const &cmap = map;
+        std::vector<int const *> cfound(3);
+        cmap.find_many(std::vector<int>({0, 1, 3}), cfound);
+        REQUIRE(cfound == std::vector<int const *>({&map.at(0), nullptr, &map.at(3)}));
+        HashMap<int, int> empty;
+        empty.find_many(keys, found);
+        REQUIRE(found[0] == nullptr);
+        found.pop_back();
+        REQUIRE_THROWS_AS(map.find_many(keys, found), std::invalid_argument);
+        std::array<bool, 3> few;
+        REQUIRE(empty.contains_many(std::vector<int>({0, 1, 3}), few.begin()) == 0);
+        REQUIRE(few == std::array<bool, 3>{});
+    }
+
+    SECTION("test heterogeneous lookup") {
+        struct StringHash {
+            using is_transparent = void;
+            size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+        };
+        HashMap<std::string, int, StringHash, std::equal_to<>> map;
+        map["alpha"] = 1;
+        map["beta"] = 2;
+        std::string_view key = "alpha";
+        REQUIRE(map.find(key)->second == 1);
+        REQUIRE(map.contains("beta"));
+        REQUIRE(map.count(std::string_view("gamma")) == 0);
+        REQUIRE(map.find("gamma") == map.end());
+        REQUIRE(map.erase(key) == 1);
+        REQUIRE(map.erase("gamma") == 0);
+        REQUIRE(!map.contains(key));
+        REQUIRE(map.size() == 1);
+    }
+}
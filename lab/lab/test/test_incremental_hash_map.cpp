@@ -0,0 +1,138 @@
+#include <catch2/catch_test_macros.hpp>
+#include <miniSTL/stl.hpp>
+#include <functional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+TEST_CASE("test incremental hash map", "[incremental_hash_map]") {
+
+    SECTION("test migration is spread over later operations") {
+        IncrementalHashMap<int, int> map(4);
+        int i = 0;
+        while (!map.is_rehashing())
+            map[i++] = 0;
+        size_t old_size = map.size() - 1;
+        REQUIRE(old_size > 0);
+        int ops = 0;
+        while (map.is_rehashing()) {
+            map[i++] = 0;
+            ops++;
+        }
+        REQUIRE(ops == int((old_size + 3) / 4));
+        for (int j = 0; j < i; j++)
+            REQUIRE(map.contains(j));
+
+        while (!map.is_rehashing())
+            map[i++] = 0;
+        IncrementalHashMap<int, int> moved(std::move(map));
+        REQUIRE(moved.is_rehashing());
+        while (moved.is_rehashing())
+            moved.erase(-1);
+        REQUIRE(moved.size() == size_t(i));
+        map = std::move(moved);
+        REQUIRE(map.at(i - 1) == 0);
+    }
+
+    SECTION("test updating a key when the table is full") {
+        IncrementalHashMap<int, int> map;
+        int n = 0;
+        map[n++] = 0;
+        while (map.size() < map.capacity() - map.capacity() / 8)
+            map[n++] = 0;
+        REQUIRE_FALSE(map.is_rehashing());
+        size_t size = map.size();
+        map[0] = 42;
+        REQUIRE(map.size() == size);
+        REQUIRE(map.at(0) == 42);
+        REQUIRE_FALSE(map.try_emplace(1, 7).second);
+        REQUIRE_FALSE(map.insert_or_assign(2, 43).second);
+        REQUIRE(map.size() == size);
+        int zeros = 0;
+        for (auto &[key, val] : map)
+            zeros += key == 0;
+        REQUIRE(zeros == 1);
+        REQUIRE(map.at(2) == 43);
+    }
+
+    SECTION("test erase and insert churn never rehashes outside a migration") {
+        IncrementalHashMap<int, int> map;
+        int const live = 850;
+        for (int i = 0; i < live; i++)
+            map[i] = i;
+        int migrations = 0;
+        for (int i = live; i < 50000; i++) {
+            size_t capacity = map.capacity();
+            bool was_rehashing = map.is_rehashing();
+            map[i] = i;
+            if (map.capacity() != capacity) {
+                REQUIRE(map.is_rehashing());
+                migrations += !was_rehashing;
+            }
+            REQUIRE(map.erase(i - live) == 1);
+        }
+        REQUIRE(migrations > 0);
+        REQUIRE(map.capacity() <= 2048);
+        REQUIRE(map.size() == size_t(live));
+        for (int i = 50000 - live; i < 50000; i++)
+            REQUIRE(map.at(i) == i);
+    }
+
+    SECTION("test against std::unordered_map") {
+        IncrementalHashMap<int, std::string> map(2);
+        std::unordered_map<int, std::string> ref;
+        std::mt19937 rng(3);
+        bool saw_rehash = false;
+        for (int i = 0; i < 100000; i++) {
+            int key = rng() % 20000;
+            switch (rng() % 4) {
+            case 0:
+            case 1:
+                REQUIRE(map.try_emplace(key, std::to_string(i)).second == ref.try_emplace(key, std::to_string(i)).second);
+                break;
+            case 2:
+                map.insert_or_assign(key, "x");
+                ref.insert_or_assign(key, "x");
+                break;
+            default:
+                REQUIRE(map.erase(key) == ref.erase(key));
+            }
+            saw_rehash = saw_rehash || map.is_rehashing();
+            if (i % 1000 == 0) {
+                size_t seen = 0;
+                for (auto const &[k, v] : std::as_const(map)) {
+                    REQUIRE(ref.at(k) == v);
+                    seen++;
+                }
+                REQUIRE(seen == ref.size());
+            }
+        }
+        REQUIRE(saw_rehash);
+        REQUIRE(map.size() == ref.size());
+        for (auto &[k, v] : ref)
+            REQUIRE(map.at(k) == v);
+        IncrementalHashMap<int, std::string> copy(map);
+        REQUIRE(!copy.is_rehashing());
+        REQUIRE(copy.size() == ref.size());
+    }
+
+    SECTION("test heterogeneous lookup") {
+        struct StringHash {
+            using is_transparent = void;
+            size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+        };
+        IncrementalHashMap<std::string, int, StringHash, std::equal_to<>> map;
+        map["alpha"] = 1;
+        map["beta"] = 2;
+        std::string_view key = "alpha";
+        REQUIRE(map.find(key)->second == 1);
+        REQUIRE(map.contains("beta"));
+        REQUIRE(map.count(std::string_view("gamma")) == 0);
+        REQUIRE(map.find("gamma") == map.end());
+        REQUIRE(map.erase(key) == 1);
+        REQUIRE(map.erase("gamma") == 0);
+        REQUIRE(!map.contains(key));
+        REQUIRE(map.size() == 1);
+    }
+}
@@ -0,0 +1,81 @@
+#include <catch2/catch_test_macros.hpp>
+#include <miniSTL/stl.hpp>
+#include <memory>
+
+namespace {
+
+struct Order {
+    int m_id;
+    IntrusiveListHook<> m_by_time;
+    IntrusiveListHook<> m_by_price;
+
+    explicit Order(int id) : m_id(id) {}
+};
+
+using TimeList = IntrusiveList<Order, &Order::m_by_time>;
+using PriceList = IntrusiveList<Order, &Order::m_by_price>;
+
+}
+
+TEST_CASE("test intrusive list", "[intrusive_list]") {
+
+    SECTION("test push_back() push_front() on two hooks") {
+        Order a(0), b(1), c(2);
+        TimeList by_time;
+        PriceList by_price;
+        by_time.push_back(a);
+        by_time.push_back(b);
+        by_time.push_back(c);
+        by_price.push_front(a);
+        by_price.push_front(b);
+        by_price.push_front(c);
+
+        int i = 0;
+        for (auto &order : by_time)
+            REQUIRE(order.m_id == i++);
+        for (auto &order : by_price)
+            REQUIRE(order.m_id == --i);
+        REQUIRE(by_time.size() == 3);
+        REQUIRE(by_price.back().m_id == 0);
+    }
+
+    SECTION("test unlink() erase() and auto-unlink") {
+        TimeList by_time;
+        Order a(0), c(2);
+        by_time.push_back(a);
+        {
+            Order b(1);
+            by_time.push_back(b);
+            by_time.push_back(c);
+            REQUIRE(by_time.size() == 3);
+        }
+        REQUIRE(by_time.size() == 2);
+        REQUIRE((++by_time.begin())->m_id == 2);
+
+        TimeList::unlink(a);
+        REQUIRE_FALSE(a.m_by_time.is_linked());
+        REQUIRE(by_time.front().m_id == 2);
+
+        by_time.insert(TimeList::iterator_to(c), a);
+        REQUIRE(by_time.front().m_id == 0);
+        auto next = by_time.erase(by_time.begin());
+        REQUIRE(next->m_id == 2);
+        by_time.clear();
+        REQUIRE(by_time.empty());
+        REQUIRE_FALSE(c.m_by_time.is_linked());
+    }
+
+    SECTION("test move and swap") {
+        Order a(0), b(1);
+        TimeList first;
+        first.push_back(a);
+        first.push_back(b);
+        TimeList second(std::move(first));
+        REQUIRE(first.empty());
+        REQUIRE(second.size() == 2);
+        first.swap(second);
+        REQUIRE(second.empty());
+        REQUIRE(first.back().m_id == 1);
+        REQUIRE(std::prev(first.end())->m_id == 1);
+    }
+}
@@ -3,6 +3,10 @@
 #include <miniSTL/stl.hpp>
 #include <vector>
 #include <list>
+#include <algorithm>
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
 
 struct M_int {
     int m_value;
@@ -100,4 +104,261 @@ TEST_CASE("test list", "[list]") {
         REQUIRE(a == a);
         REQUIRE_FALSE(a == b);
     }
+
+    SECTION("test emplace_front() emplace_back() emplace()") {
+        List<M_int> lst;
+        lst.emplace_back(1);
+        lst.emplace_front(0);
+        REQUIRE(lst.emplace_back(3).m_value == 3);
+        auto it = lst.emplace(--lst.end(), 2);
+        REQUIRE((*it).m_value == 2);
+        REQUIRE(lst.size() == 4);
+        int i = 0;
+        for (auto item : lst)
+            REQUIRE(item.m_value == i++);
+    }
+
+    SECTION("test pmr allocator propagation") {
+        using PmrList = List<M_int, std::pmr::polymorphic_allocator<M_int>>;
+        std::pmr::monotonic_buffer_resource arena;
+        std::pmr::monotonic_buffer_resource other_arena;
+
+        PmrList a(tmp_list.begin(), tmp_list.end(), &arena);
+        REQUIRE(a.get_allocator().resource() == &arena);
+
+        PmrList copy(a);
+        REQUIRE(copy.get_allocator().resource() == std::pmr::get_default_resource());
+        PmrList moved(std::move(copy), &other_arena);
+        REQUIRE(moved.get_allocator().resource() == &other_arena);
+        REQUIRE(moved == a);
+        REQUIRE(copy.empty());
+
+        PmrList b(&arena);
+        b = std::move(moved);
+        REQUIRE(b.get_allocator().resource() == &arena);
+        REQUIRE(b == a);
+
+        b.swap(a);
+        REQUIRE(b.size() == 3);
+        PmrList empty(&arena);
+        empty.swap(b);
+        REQUIRE(b.empty());
+        REQUIRE(empty.size() == 3);
+        REQUIRE(empty.back().m_value == 2);
+
+        List<std::pmr::string, std::pmr::polymorphic_allocator<std::pmr::string>> strs(&arena);
+        strs.emplace_back("a string long enough to skip the small buffer");
+        REQUIRE(strs.front().get_allocator().resource() == &arena);
+    }
+
+    SECTION("test NodePool PoolAllocator") {
+        using PoolList = List<M_int, PoolAllocator<M_int>>;
+        NodePool pool(sizeof(ListValueNode<M_int>), alignof(ListValueNode<M_int>), 64);
+        {
+            PoolList a(&pool), b(&pool);
+            for (int i = 0; i < 100; i++) {
+                a.push_back(i);
+                b.push_front(i);
+            }
+            REQUIRE(pool.block_count() == 4);
+            REQUIRE(a.front().m_value == 0);
+            REQUIRE(b.front().m_value == 99);
+
+            a.clear();
+            for (int i = 0; i < 100; i++)
+                b.push_back(i);
+            REQUIRE(pool.block_count() == 4);
+
+            PoolList c(b);
+            REQUIRE(c == b);
+            REQUIRE(pool.block_count() == 5);
+        }
+        pool.release();
+        REQUIRE(pool.block_count() == 0);
+    }
+
+    SECTION("test splice() merge() sort()") {
+        List<int> a({0, 1, 2});
+        List<int> b({10, 11, 12});
+        a.splice(a.end(), b, b.begin());
+        REQUIRE(a.back() == 10);
+        REQUIRE(a.size() == 4);
+        REQUIRE(b.size() == 2);
+        a.splice(a.begin(), b, b.begin(), b.end());
+        REQUIRE(a == List<int>({11, 12, 0, 1, 2, 10}));
+        REQUIRE(b.empty());
+        a.splice(a.end(), a, a.begin(), ++(++a.begin()));
+        REQUIRE(a == List<int>({0, 1, 2, 10, 11, 12}));
+        b.splice(b.begin(), a);
+        REQUIRE(a.empty());
+        REQUIRE(b.size() == 6);
+
+        List<int> odd({1, 3, 5, 7});
+        List<int> even({0, 2, 4, 6, 8});
+        odd.merge(even);
+        REQUIRE(odd == List<int>({0, 1, 2, 3, 4, 5, 6, 7, 8}));
+        REQUIRE(even.empty());
+
+        List<std::pair<int, int>> stable;
+        std::list<std::pair<int, int>> ref;
+        for (int i = 0; i < 1000; i++) {
+            stable.push_back({(i * 37) % 17, i});
+            ref.push_back({(i * 37) % 17, i});
+        }
+        auto by_key = [](auto const &x, auto const &y) { return x.first < y.first; };
+        stable.sort(by_key);
+        ref.sort(by_key);
+        REQUIRE(stable.size() == ref.size());
+        REQUIRE(std::equal(stable.begin(), stable.end(), ref.begin(), ref.end()));
+        REQUIRE(std::equal(stable.rbegin(), stable.rend(), ref.rbegin(), ref.rend()));
+
+        for (int limit : {0, 1, 5, 100, 1500}) {
+            List<std::string> strs;
+            for (int i = 0; i < 300; i++)
+                strs.push_back(std::to_string((i * 7919) % 300));
+            int calls = 0;
+            auto throwing = [&](std::string const &x, std::string const &y) {
+                if (++calls > limit)
+                    throw std::runtime_error("comparator");
+                return x < y;
+            };
+            REQUIRE_THROWS_AS(strs.sort(throwing), std::runtime_error);
+            REQUIRE(strs.size() == 300);
+            REQUIRE(static_cast<size_t>(std::distance(strs.begin(), strs.end())) == 300);
+            REQUIRE(static_cast<size_t>(std::distance(strs.rbegin(), strs.rend())) == 300);
+            std::vector<std::string> seen(strs.begin(), strs.end());
+            std::sort(seen.begin(), seen.end());
+            for (int i = 0; i < 300; i++)
+                REQUIRE(std::binary_search(seen.begin(), seen.end(), std::to_string(i)));
+
+            List<std::string> more({"0", "5", "9"});
+            calls = std::max(limit - 2, 0);
+            REQUIRE_THROWS_AS(more.merge(strs, throwing), std::runtime_error);
+            REQUIRE(more.size() + strs.size() == 303);
+            REQUIRE(static_cast<size_t>(std::distance(more.begin(), more.end())) == more.size());
+            REQUIRE(static_cast<size_t>(std::distance(strs.begin(), strs.end())) == strs.size());
+        }
+    }
+
+    SECTION("test defragment()") {
+        using PoolList = List<int, PoolAllocator<int>>;
+        NodePool pool(sizeof(ListValueNode<int>), alignof(ListValueNode<int>), 32);
+        PoolList lst(&pool);
+        for (int i = 0; i < 200; i++) {
+            auto it = lst.begin();
+            for (int j = 0; j < (i * 7) % (i + 1); j++)
+                ++it;
+            lst.insert(it, i);
+            if (i % 3 == 0)
+                lst.erase(lst.begin());
+        }
+        List<int> before(lst.begin(), lst.end());
+
+        auto is_sequential = [&](PoolList &l) {
+            auto prev = reinterpret_cast<std::byte *>(&*l.begin());
+            for (auto it = ++l.begin(); it != l.end(); ++it) {
+                auto addr = reinterpret_cast<std::byte *>(&*it);
+                if (addr - prev != static_cast<ptrdiff_t>(pool.slot_size()))
+                    return false;
+                prev = addr;
+            }
+            return true;
+        };
+        REQUIRE_FALSE(is_sequential(lst));
+        lst.defragment();
+        REQUIRE(is_sequential(lst));
+        REQUIRE(std::equal(lst.begin(), lst.end(), before.begin(), before.end()));
+
+        List<int> plain(before);
+        auto it = plain.begin();
+        while (it != plain.end())
+            it = plain.defragment(it, 16);
+        REQUIRE(plain == before);
+    }
+
+    SECTION("test bulk insert()") {
+        List<int> lst({0, 5});
+        auto it = lst.insert(++lst.begin(), 3, 1);
+        REQUIRE(*it == 1);
+        REQUIRE(lst.size() == 5);
+        std::list<int> src({2, 3, 4});
+        it = lst.insert(--lst.end(), src.begin(), src.end());
+        REQUIRE(*it == 2);
+        REQUIRE(lst == List<int>({0, 1, 1, 1, 2, 3, 4, 5}));
+        REQUIRE(lst.size() == 8);
+        it = lst.insert(lst.end(), src.begin(), src.begin());
+        REQUIRE(it == lst.end());
+        REQUIRE(lst.size() == 8);
+
+        NodePool pool(sizeof(ListValueNode<int>), alignof(ListValueNode<int>), 16);
+        List<int, PoolAllocator<int>> pooled(&pool);
+        pooled.insert(pooled.end(), lst.begin(), lst.end());
+        pooled.insert(pooled.begin(), 1000, 7);
+        REQUIRE(pooled.size() == 1008);
+        REQUIRE(pool.block_count() == 2);
+    }
+
+    SECTION("test bulk clear() on pool and arena") {
+        NodePool pool(sizeof(ListValueNode<int>), alignof(ListValueNode<int>), 64);
+        {
+            List<int, PoolAllocator<int>> a(&pool), b(&pool);
+            for (int i = 0; i < 100; i++) {
+                a.push_back(i);
+                b.push_back(i);
+            }
+            a.clear();
+            REQUIRE(a.empty());
+            REQUIRE(pool.block_count() > 0);
+            REQUIRE(pool.live_count() == 100);
+            REQUIRE(b.back() == 99);
+
+            b.clear();
+            REQUIRE(pool.block_count() == 0);
+            b.push_back(1);
+            REQUIRE(b.front() == 1);
+        }
+        REQUIRE(pool.block_count() == 0);
+
+        std::pmr::monotonic_buffer_resource arena;
+        List<int, std::pmr::polymorphic_allocator<int>> lst(&arena);
+        for (int i = 0; i < 100; i++)
+            lst.push_back(i);
+        lst.clear();
+        REQUIRE(lst.empty());
+        lst.push_back(1);
+        REQUIRE(lst.size() == 1);
+    }
+
+    SECTION("test extract() and node handle insert()") {
+        List<std::string> a({"a", "b", "c"});
+        List<std::string> b({"x"});
+        auto *addr = &*std::next(a.begin());
+        auto nh = a.extract(std::next(a.begin()));
+        REQUIRE(a == List<std::string>({"a", "c"}));
+        REQUIRE(!nh.empty());
+        REQUIRE(nh.value() == "b");
+        auto it = b.insert(b.begin(), std::move(nh));
+        REQUIRE(nh.empty());
+        REQUIRE(&*it == addr);
+        REQUIRE(b == List<std::string>({"b", "x"}));
+        REQUIRE(b.insert(b.end(), List<std::string>::node_type{}) == b.end());
+        {
+            auto dropped = b.extract(b.begin());
+        }
+        REQUIRE(b.size() == 1);
+    }
+
+    SECTION("test cross-list splice with count and splice_if()") {
+        List<int> a({0, 1, 2, 3, 4, 5, 6, 7});
+        List<int> b;
+        b.splice(b.end(), a, std::next(a.begin(), 2), std::next(a.begin(), 5), 3);
+        REQUIRE(a == List<int>({0, 1, 5, 6, 7}));
+        REQUIRE(b == List<int>({2, 3, 4}));
+        size_t n = b.splice_if(b.begin(), a, [](int x) { return x % 2 == 1; });
+        REQUIRE(n == 3);
+        REQUIRE(b == List<int>({1, 5, 7, 2, 3, 4}));
+        REQUIRE(a == List<int>({0, 6}));
+        REQUIRE(a.size() == 2);
+        REQUIRE(b.size() == 6);
+    }
 }
@@ -0,0 +1,63 @@
+#include <catch2/catch_test_macros.hpp>
+#include <miniSTL/stl.hpp>
+#include <memory_resource>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_CASE("test mpsc queue", "[mpsc_queue]") {
+
+    SECTION("test push() try_pop() on one thread") {
+        MpscQueue<std::string> queue;
+        REQUIRE(queue.empty());
+        REQUIRE(!queue.try_pop());
+        queue.push("a");
+        queue.emplace(3, 'b');
+        REQUIRE(!queue.empty());
+        REQUIRE(*queue.try_pop() == "a");
+        queue.push("c");
+        REQUIRE(*queue.try_pop() == "bbb");
+        REQUIRE(*queue.try_pop() == "c");
+        REQUIRE(!queue.try_pop());
+        REQUIRE(queue.empty());
+        queue.push("left for the destructor");
+    }
+
+    SECTION("test drain() with a batch limit") {
+        MpscQueue<int> queue;
+        for (int i = 0; i < 10; i++)
+            queue.push(i);
+        std::vector<int> out;
+        REQUIRE(queue.drain([&](int x) { out.push_back(x); }, 4) == 4);
+        REQUIRE(queue.drain([&](int x) { out.push_back(x); }) == 6);
+        REQUIRE(out == std::vector<int>({0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+    }
+
+    SECTION("test many producers") {
+        constexpr int producers = 4;
+        constexpr int per_producer = 20000;
+        std::pmr::synchronized_pool_resource pool;
+        MpscQueue<std::pair<int, int>, std::pmr::polymorphic_allocator<std::pair<int, int>>> queue(&pool);
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; p++) {
+            threads.emplace_back([&queue, p] {
+                for (int i = 0; i < per_producer; i++)
+                    queue.push({p, i});
+            });
+        }
+        std::vector<int> next(producers, 0);
+        int received = 0;
+        bool in_order = true;
+        while (received < producers * per_producer) {
+            received += queue.drain([&](std::pair<int, int> item) {
+                in_order = in_order && item.second == next[item.first];
+                next[item.first] = item.second + 1;
+            }, 256);
+        }
+        for (auto &t : threads)
+            t.join();
+        REQUIRE(in_order);
+        REQUIRE(queue.empty());
+        REQUIRE(next == std::vector<int>(producers, per_producer));
+    }
+}
@@ -0,0 +1,97 @@
+#include <catch2/catch_test_macros.hpp>
+#include <miniSTL/stl.hpp>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+TEST_CASE("test perfect hash map", "[perfect_hash_map]") {
+
+    SECTION("test lookups of members and strangers") {
+        Vector<std::string> keys;
+        Vector<int> values;
+        for (int i = 0; i < 5000; i++) {
+            keys.push_back("key" + std::to_string(i));
+            values.push_back(i);
+        }
+        PerfectHashMap<std::string, int> map(keys, values);
+        REQUIRE(map.size() == 5000);
+        for (int i = 0; i < 5000; i++) {
+            REQUIRE(map.at("key" + std::to_string(i)) == i);
+            REQUIRE(map.keys()[map.index_of("key" + std::to_string(i))] == "key" + std::to_string(i));
+        }
+        for (int i = 5000; i < 10000; i++)
+            REQUIRE(!map.contains("key" + std::to_string(i)));
+        REQUIRE(map.find("nope") == nullptr);
+        REQUIRE_THROWS_AS(map.at("nope"), std::out_of_range);
+        REQUIRE(map.bits_per_key() < 10.0);
+    }
+
+    SECTION("test parallel build over many partitions") {
+        Vector<uint64_t> keys;
+        Vector<uint32_t> values;
+        std::mt19937_64 rng(3);
+        for (uint32_t i = 0; i < 200000; i++) {
+            keys.push_back(rng());
+            values.push_back(i);
+        }
+        PerfectHashMap<uint64_t, uint32_t> map(keys, values, {}, {}, 4);
+        for (uint32_t i = 0; i < 200000; i++)
+            REQUIRE(*map.find(keys[i]) == i);
+        PerfectHashMap<uint64_t, uint32_t> moved(std::move(map));
+        REQUIRE(map.empty());
+        REQUIRE(moved.at(keys[123]) == 123);
+    }
+
+    SECTION("test bad input") {
+        REQUIRE_THROWS_AS((PerfectHashMap<int, int>(Vector<int>({1, 2, 1}), Vector<int>({1, 2, 3}))),
+                          std::invalid_argument);
+        REQUIRE_THROWS_AS((PerfectHashMap<int, int>(Vector<int>({1, 2}), Vector<int>({1}))), std::invalid_argument);
+        PerfectHashMap<int, int> empty(Vector<int>{}, Vector<int>{});
+        REQUIRE(empty.empty());
+        REQUIRE(!empty.contains(0));
+    }
+
+    SECTION("test serialize() from_image()") {
+        Vector<int> keys;
+        Vector<double> values;
+        for (int i = 0; i < 40000; i++) {
+            keys.push_back(i * 7);
+            values.push_back(i * 0.5);
+        }
+        PerfectHashMap<int, double> map(keys, values);
+        std::ostringstream out;
+        map.serialize(out);
+        std::string bytes = out.str();
+        REQUIRE(bytes.size() == map.image_size());
+        auto image = std::make_unique<uint64_t[]>(bytes.size() / 8);
+        std::memcpy(image.get(), bytes.data(), bytes.size());
+        auto loaded = PerfectHashMap<int, double>::from_image({reinterpret_cast<std::byte const *>(image.get()), bytes.size()});
+        REQUIRE(loaded.size() == map.size());
+        for (int i = 0; i < 40000; i++)
+            REQUIRE(loaded.at(i * 7) == i * 0.5);
+        REQUIRE(!loaded.contains(1));
+        REQUIRE_THROWS_AS((PerfectHashMap<int, double>::from_image({reinterpret_cast<std::byte const *>(image.get()), 64})),
+                          std::invalid_argument);
+        REQUIRE_THROWS_AS((PerfectHashMap<int, int>::from_image({reinterpret_cast<std::byte const *>(image.get()), bytes.size()})),
+                          std::invalid_argument);
+    }
+
+    SECTION("test heterogeneous lookup") {
+        struct StringHash {
+            using is_transparent = void;
+            size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+        };
+        PerfectHashMap<std::string, int, StringHash, std::equal_to<>> map(Vector<std::string>({"alpha", "beta"}),
+                                                                          Vector<int>({1, 2}));
+        std::string_view key = "beta";
+        REQUIRE(*map.find(key) == 2);
+        REQUIRE(map.contains("alpha"));
+        REQUIRE(map.count(std::string_view("gamma")) == 0);
+        REQUIRE(map.keys()[map.index_of(key)] == "beta");
+        REQUIRE(map.index_of("gamma") == map.size());
+    }
+}
@@ -0,0 +1,175 @@
+#include <catch2/catch_test_macros.hpp>
+#include <miniSTL/stl.hpp>
+#include <array>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+TEST_CASE("test robin hood map", "[robin_hood_map]") {
+
+    SECTION("test constructor") {
+        RobinHoodMap<std::string, int> map({{"a", 1}, {"b", 2}, {"a", 3}});
+        REQUIRE(map.size() == 2);
+        REQUIRE(map.at("a") == 1);
+        RobinHoodMap<std::string, int> copy(map);
+        REQUIRE(copy == map);
+        RobinHoodMap<std::string, int> moved(std::move(copy));
+        REQUIRE(moved == map);
+        REQUIRE(copy.empty());
+        copy = moved;
+        REQUIRE(copy == map);
+        REQUIRE_THROWS_AS(map.at("z"), std::out_of_range);
+    }
+
+    SECTION("test against std::unordered_map") {
+        RobinHoodMap<int, std::string> map;
+        std::unordered_map<int, std::string> ref;
+        std::mt19937 rng(5);
+        for (int i = 0; i < 200000; i++) {
+            int key = rng() % 4000;
+            switch (rng() % 3) {
+            case 0:
+                REQUIRE(map.try_emplace(key, std::to_string(i)).second == ref.try_emplace(key, std::to_string(i)).second);
+                break;
+            case 1:
+                map[key] += "x";
+                ref[key] += "x";
+                break;
+            default:
+                REQUIRE(map.erase(key) == ref.erase(key));
+            }
+        }
+        REQUIRE(map.size() == ref.size());
+        for (auto &[key, val] : ref)
+            REQUIRE(map.at(key) == val);
+        for (int key = 0; key < 4000; key++)
+            REQUIRE(map.contains(key) == ref.contains(key));
+    }
+
+    SECTION("test load factor and probe length") {
+        RobinHoodMap<int, int> map;
+        map.reserve(9000);
+        size_t capacity = map.capacity();
+        for (int i = 0; i < 9000; i++)
+            map[i * 64] = i;
+        REQUIRE(map.capacity() == capacity);
+        REQUIRE(map.load_factor() > 0.5f);
+        REQUIRE(map.load_factor() <= map.max_load_factor());
+        REQUIRE(map.max_probe_length() < 64);
+
+        RobinHoodMap<int, int> small;
+        for (int i = 0; i < 8; i++) {
+            small[i] = i;
+            REQUIRE(small.size() < small.capacity());
+        }
+        for (int i = 0; i < 9000; i += 2)
+            map.erase(i * 64);
+        for (int i = 0; i < 9000; i++)
+            REQUIRE(map.contains(i * 64) == (i % 2 == 1));
+    }
+
+    SECTION("test degenerate hash") {
+        struct ConstantHash {
+            size_t operator()(int) const { return 42; }
+        };
+        RobinHoodMap<int, int, ConstantHash> map;
+        for (int i = 0; i < 255; i++)
+            map[i] = i;
+        REQUIRE(map.max_probe_length() == 255);
+        REQUIRE_THROWS_AS(map[255] = 255, std::length_error);
+        REQUIRE(map.capacity() <= 4096);
+        REQUIRE(map.size() == 255);
+        REQUIRE_FALSE(map.contains(255));
+        for (int i = 0; i < 255; i++)
+            REQUIRE(map.at(i) == i);
+        map.rehash(0);
+        REQUIRE(map.erase(0) == 1);
+        map[255] = 255;
+        REQUIRE(map.at(255) == 255);
+        REQUIRE(map.size() == 255);
+
+        // Fibonacci hashing sends these to home slots 1000 and 1100 of 4096, 125 and 137 of 512
+        struct TwoHashes {
+            size_t operator()(int key) const { return key < 135 ? 0x6480000000000000 : 0xa1c0000000000000; }
+        };
+        RobinHoodMap<int, int, TwoHashes> two;
+        two.reserve(3000);
+        REQUIRE(two.capacity() == 4096);
+        for (int i = 0; i < 270; i++)
+            two[i] = i;
+        two.rehash(0);
+        REQUIRE(two.capacity() == 1024);
+        REQUIRE(two.max_probe_length() < 255);
+        for (int i = 0; i < 270; i++)
+            REQUIRE(two.at(i) == i);
+    }
+
+    SECTION("test erase() while iterating") {
+        RobinHoodMap<int, int> map;
+        for (int i = 0; i < 1000; i++)
+            map.emplace(i, i);
+        for (auto it = map.begin(); it != map.end();) {
+            if (it->first % 3 == 0)
+                it = map.erase(it);
+            else
+                ++it;
+        }
+        REQUIRE(map.size() == 666);
+        for (int i = 0; i < 1000; i++)
+            REQUIRE(map.contains(i) == (i % 3 != 0));
+    }
+
+    SECTION("test find_many() contains_many()") {
+        RobinHoodMap<int, int> map;
+        std::vector<int> keys;
+        for (int i = 0; i < 1000; i++) {
+            map.emplace(i * 3, i);
+            keys.push_back(i * 2);
+        }
+        std::vector<int *> found(keys.size());
+        map.find_many(keys, found);
+        std::vector<bool> flags;
+        REQUIRE(map.contains_many(keys, std::back_inserter(flags)) == 334);
+        REQUIRE(flags.size() == keys.size());
+        for (size_t i = 0; i < keys.size(); i++) {
+            REQUIRE(found[i] == (keys[i] % 3 == 0 ? &map.at(keys[i]) : nullptr));
+            REQUIRE(flags[i] == (keys[i] % 3 == 0));
+        }
+        RobinHoodMap<int, int> const &cmap = map;
+        std::vector<int const *> cfound(3);
+        cmap.find_many(std::vector<int>({0, 1, 3}), cfound);
+        REQUIRE(cfound == std::vector<int const *>({&map.at(0), nullptr, &map.at(3)}));
+        RobinHoodMap<int, int> empty;
+        empty.find_many(keys, found);
+        REQUIRE(found[0] == nullptr);
+        found.pop_back();
+        REQUIRE_THROWS_AS(map.find_many(keys, found), std::invalid_argument);
+        std::array<bool, 3> few;
+        REQUIRE(empty.contains_many(std::vector<int>({0, 1, 3}), few.begin()) == 0);
+        REQUIRE(few == std::array<bool, 3>{});
+    }
+
+    SECTION("test heterogeneous lookup") {
+        struct StringHash {
+            using is_transparent = void;
+            size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+        };
+        RobinHoodMap<std::string, int, StringHash, std::equal_to<>> map;
+        map["alpha"] = 1;
+        map["beta"] = 2;
+        std::string_view key = "alpha";
+        REQUIRE(map.find(key)->second == 1);
+        REQUIRE(map.contains("beta"));
+        REQUIRE(map.count(std::string_view("gamma")) == 0);
+        REQUIRE(map.find("gamma") == map.end());
+        REQUIRE(map.erase(key) == 1);
+        REQUIRE(map.erase("gamma") == 0);
+        REQUIRE(!map.contains(key));
+        REQUIRE(map.size() == 1);
+    }
+}
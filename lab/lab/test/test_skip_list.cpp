@@ -0,0 +1,140 @@
+#include <catch2/catch_test_macros.hpp>
+#include <miniSTL/stl.hpp>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+TEST_CASE("test skip list", "[skip_list]") {
+
+    SECTION("test constructor") {
+        SkipList<int, std::string> map({{2, "b"}, {0, "a"}, {1, "c"}, {0, "x"}});
+        REQUIRE(map.size() == 3);
+        int i = 0;
+        for (auto &[key, val] : map)
+            REQUIRE(key == i++);
+        REQUIRE(map.at(0) == "a");
+        SkipList<int, std::string> copy(map);
+        REQUIRE(copy == map);
+        SkipList<int, std::string> moved(std::move(copy));
+        REQUIRE(moved == map);
+        REQUIRE(copy.empty());
+        copy = moved;
+        REQUIRE(copy == map);
+        REQUIRE_THROWS_AS(map.at(5), std::out_of_range);
+    }
+
+    SECTION("test against std::map") {
+        SkipList<int, int> map;
+        std::map<int, int> ref;
+        std::mt19937 rng(7);
+        for (int i = 0; i < 5000; i++) {
+            int key = rng() % 1000;
+            switch (rng() % 3) {
+            case 0:
+                REQUIRE(map.insert({key, i}).second == ref.insert({key, i}).second);
+                break;
+            case 1:
+                map.insert_or_assign(key, i);
+                ref.insert_or_assign(key, i);
+                break;
+            default:
+                REQUIRE(map.erase(key) == ref.erase(key));
+            }
+        }
+        map.reclaim();
+        REQUIRE(map.size() == ref.size());
+        REQUIRE(std::equal(map.begin(), map.end(), ref.begin(), ref.end()));
+        REQUIRE(std::equal(map.rbegin(), map.rend(), ref.rbegin(), ref.rend()));
+        for (int key = -1; key <= 1000; key++) {
+            auto it = map.lower_bound(key);
+            auto ref_it = ref.lower_bound(key);
+            REQUIRE((it == map.end()) == (ref_it == ref.end()));
+            if (ref_it != ref.end())
+                REQUIRE(it->first == ref_it->first);
+            REQUIRE(map.contains(key) == ref.contains(key));
+        }
+    }
+
+    SECTION("test range() erase()") {
+        SkipList<int, int> map;
+        for (int i = 0; i < 100; i++)
+            map[i] = i * i;
+        int expect = 10;
+        for (auto &[key, val] : map.range(10, 20))
+            REQUIRE(key == expect++);
+        REQUIRE(expect == 20);
+        auto it = map.erase(map.find(50), map.find(60));
+        REQUIRE(it->first == 60);
+        REQUIRE(map.size() == 90);
+        REQUIRE(map.lower_bound(50)->first == 60);
+        REQUIRE(map.upper_bound(60)->first == 61);
+    }
+
+    SECTION("test PoolAllocator") {
+        NodePool pool(64, alignof(std::max_align_t), 64);
+        {
+            SkipList<int, int, std::less<int>, PoolAllocator<std::pair<int const, int>>> map(&pool);
+            for (int i = 0; i < 1000; i++)
+                map.try_emplace(i, i);
+            REQUIRE(pool.live_count() >= 1000);
+            REQUIRE(map.find(999)->second == 999);
+        }
+        REQUIRE(pool.live_count() == 0);
+    }
+
+    SECTION("test readers alongside one writer") {
+        SkipList<int, int> map;
+        std::atomic<bool> done = false;
+        std::atomic<int> bad = 0;
+        std::vector<std::thread> readers;
+        for (int r = 0; r < 4; r++) {
+            readers.emplace_back([&] {
+                while (!done.load()) {
+                    int prev = -1;
+                    for (auto const &[key, val] : std::as_const(map)) {
+                        if (key <= prev || val != key * 2)
+                            bad++;
+                        prev = key;
+                    }
+                    auto it = std::as_const(map).lower_bound(prev / 2);
+                    if (it != map.cend() && it->second != it->first * 2)
+                        bad++;
+                }
+            });
+        }
+        for (int i = 0; i < 20000; i++) {
+            map.try_emplace((i * 7919) % 20000, (i * 7919) % 20000 * 2);
+            if (i % 3 == 0)
+                map.erase((i * 7919) % 20000);
+        }
+        done = true;
+        for (auto &t : readers)
+            t.join();
+        map.reclaim();
+        REQUIRE(bad == 0);
+        REQUIRE(map.size() == 20000 - 6667);
+    }
+
+    SECTION("test heterogeneous lookup") {
+        SkipList<std::string, int, std::less<>> list;
+        list["apple"] = 1;
+        list["banana"] = 2;
+        list["cherry"] = 3;
+        std::string_view key = "banana";
+        REQUIRE(list.find(key)->second == 2);
+        REQUIRE(list.contains("cherry"));
+        REQUIRE(list.count(std::string_view("date")) == 0);
+        REQUIRE(list.lower_bound("b")->first == "banana");
+        REQUIRE(list.upper_bound(key)->first == "cherry");
+        REQUIRE(list.equal_range("c").first == list.equal_range("c").second);
+        REQUIRE(list.erase(key) == 1);
+        REQUIRE(!list.contains(key));
+        REQUIRE(list.size() == 2);
+    }
+}
@@ -0,0 +1,169 @@
+#include <catch2/catch_test_macros.hpp>
+#include <miniSTL/stl.hpp>
+#include <array>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+TEST_CASE("test unordered map", "[unordered_map]") {
+
+    SECTION("test constructor") {
+        UnorderedMap<std::string, int> map({{"a", 1}, {"b", 2}, {"a", 3}});
+        REQUIRE(map.size() == 2);
+        REQUIRE(map.at("a") == 1);
+        UnorderedMap<std::string, int> copy(map);
+        REQUIRE(copy == map);
+        UnorderedMap<std::string, int> moved(std::move(copy));
+        REQUIRE(moved == map);
+        REQUIRE(copy.empty());
+        copy = moved;
+        REQUIRE(copy == map);
+        copy.swap(moved);
+        REQUIRE(copy == moved);
+        REQUIRE_THROWS_AS(map.at("z"), std::out_of_range);
+
+        UnorderedMap<int, int> empty;
+        REQUIRE(empty.bucket_count() == 0);
+        REQUIRE(empty.bucket_size(0) == 0);
+        REQUIRE(empty.bucket(1) == 0);
+    }
+
+    SECTION("test against std::unordered_map") {
+        UnorderedMap<int, std::string> map;
+        std::unordered_map<int, std::string> ref;
+        std::mt19937 rng(9);
+        for (int i = 0; i < 200000; i++) {
+            int key = rng() % 4000;
+            switch (rng() % 4) {
+            case 0:
+                REQUIRE(map.try_emplace(key, std::to_string(i)).second == ref.try_emplace(key, std::to_string(i)).second);
+                break;
+            case 1:
+                map[key] += "x";
+                ref[key] += "x";
+                break;
+            case 2:
+                REQUIRE(map.emplace(key, "e").second == ref.emplace(key, "e").second);
+                break;
+            default:
+                REQUIRE(map.erase(key) == ref.erase(key));
+            }
+        }
+        REQUIRE(map.size() == ref.size());
+        REQUIRE(static_cast<size_t>(std::distance(map.begin(), map.end())) == ref.size());
+        for (auto &[key, val] : ref)
+            REQUIRE(map.at(key) == val);
+        for (int key = 0; key < 4000; key++)
+            REQUIRE(map.contains(key) == ref.contains(key));
+        size_t total = 0;
+        for (size_t b = 0; b < map.bucket_count(); b++)
+            total += map.bucket_size(b);
+        REQUIRE(total == map.size());
+    }
+
+    SECTION("test references stay valid across rehashes") {
+        UnorderedMap<int, int> map;
+        std::vector<int *> refs;
+        for (int i = 0; i < 1000; i++)
+            refs.push_back(&map.try_emplace(i, i).first->second);
+        map.rehash(4096);
+        for (int i = 1000; i < 20000; i++)
+            map.emplace(i, i);
+        for (int i = 0; i < 1000; i += 2)
+            map.erase(i);
+        for (int i = 1; i < 1000; i += 2) {
+            REQUIRE(*refs[i] == i);
+            REQUIRE(&map.at(i) == refs[i]);
+        }
+        REQUIRE(map.load_factor() <= map.max_load_factor());
+    }
+
+    SECTION("test erase() while iterating") {
+        UnorderedMap<int, int> map;
+        for (int i = 0; i < 1000; i++)
+            map.emplace(i, i);
+        for (auto it = map.begin(); it != map.end();) {
+            if (it->first % 3 == 0)
+                it = map.erase(it);
+            else
+                ++it;
+        }
+        REQUIRE(map.size() == 666);
+        for (int i = 0; i < 1000; i++)
+            REQUIRE(map.contains(i) == (i % 3 != 0));
+        map.erase(map.begin(), map.end());
+        REQUIRE(map.empty());
+        REQUIRE(map.begin() == map.end());
+    }
+
+    SECTION("test NodePool PoolAllocator") {
+        using Pair = std::pair<int const, int>;
+        using PoolMap = UnorderedMap<int, int, std::hash<int>, std::equal_to<int>, PoolAllocator<Pair>>;
+        NodePool pool(sizeof(UnorderedMapNode<Pair>), alignof(UnorderedMapNode<Pair>), 64);
+        PoolMap map(&pool);
+        for (int i = 0; i < 500; i++)
+            map.emplace(i, i * 2);
+        REQUIRE(pool.live_count() == 500);
+        PoolMap copy(map);
+        REQUIRE(pool.live_count() == 1000);
+        REQUIRE(copy == map);
+        copy.clear();
+        for (int i = 0; i < 500; i++)
+            REQUIRE(map.at(i) == i * 2);
+        REQUIRE(pool.live_count() == 500);
+    }
+
+    SECTION("test find_many() contains_many()") {
+        UnorderedMap<int, int> map;
+        std::vector<int> keys;
+        for (int i = 0; i < 1000; i++) {
+            map.emplace(i * 3, i);
+            keys.push_back(i * 2);
+        }
+        std::vector<int *> found(keys.size());
+        map.find_many(keys, found);
+        std::vector<bool> flags;
+        REQUIRE(map.contains_many(keys, std::back_inserter(flags)) == 334);
+        REQUIRE(flags.size() == keys.size());
+        for (size_t i = 0; i < keys.size(); i++) {
+            REQUIRE(found[i] == (keys[i] % 3 == 0 ? &map.at(keys[i]) : nullptr));
+            REQUIRE(flags[i] == (keys[i] % 3 == 0));
+        }
+        UnorderedMap<int, int> const &cmap = map;
+        std::vector<int const *> cfound(3);
+        cmap.find_many(std::vector<int>({0, 1, 3}), cfound);
+        REQUIRE(cfound == std::vector<int const *>({&map.at(0), nullptr, &map.at(3)}));
+        UnorderedMap<int, int> empty;
+        empty.find_many(keys, found);
+        REQUIRE(found[0] == nullptr);
+        found.pop_back();
+        REQUIRE_THROWS_AS(map.find_many(keys, found), std::invalid_argument);
+        std::array<bool, 3> few;
+        REQUIRE(empty.contains_many(std::vector<int>({0, 1, 3}), few.begin()) == 0);
+        REQUIRE(few == std::array<bool, 3>{});
+    }
+
+    SECTION("test heterogeneous lookup") {
+        struct StringHash {
+            using is_transparent = void;
+            size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+        };
+        UnorderedMap<std::string, int, StringHash, std::equal_to<>> map;
+        map["alpha"] = 1;
+        map["beta"] = 2;
+        std::string_view key = "alpha";
+        REQUIRE(map.find(key)->second == 1);
+        REQUIRE(map.contains("beta"));
+        REQUIRE(map.count(std::string_view("gamma")) == 0);
+        REQUIRE(map.find("gamma") == map.end());
+        REQUIRE(map.erase(key) == 1);
+        REQUIRE(map.erase("gamma") == 0);
+        REQUIRE(!map.contains(key));
+        REQUIRE(map.size() == 1);
+    }
+}
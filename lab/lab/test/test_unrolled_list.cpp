@@ -0,0 +1,115 @@
+#include <catch2/catch_test_macros.hpp>
+#include <miniSTL/stl.hpp>
+#include <algorithm>
+#include <list>
+#include <stdexcept>
+#include <string>
+
+TEST_CASE("test unrolled list", "[unrolled_list]") {
+
+    SECTION("test constructor") {
+        UnrolledList<int, 4> lst({0, 1, 2, 3, 4, 5, 6, 7, 8});
+        REQUIRE(lst.size() == 9);
+        int i = 0;
+        for (auto item : lst)
+            REQUIRE(item == i++);
+        UnrolledList<int, 4> copy(lst);
+        REQUIRE(copy == lst);
+        UnrolledList<int, 4> moved(std::move(copy));
+        REQUIRE(moved == lst);
+        REQUIRE(copy.empty());
+    }
+
+    SECTION("test insert() erase() against std::list") {
+        UnrolledList<int, 4> lst;
+        std::list<int> ref;
+        for (int i = 0; i < 200; i++) {
+            int pos = (i * 7) % (ref.size() + 1);
+            auto it = lst.begin();
+            auto ref_it = ref.begin();
+            for (int j = 0; j < pos; j++) {
+                ++it;
+                ++ref_it;
+            }
+            REQUIRE(*lst.insert(it, i) == i);
+            ref.insert(ref_it, i);
+        }
+        REQUIRE(lst.size() == ref.size());
+        REQUIRE(std::equal(lst.begin(), lst.end(), ref.begin(), ref.end()));
+
+        for (int i = 0; i < 150; i++) {
+            int pos = (i * 13) % ref.size();
+            auto it = lst.begin();
+            auto ref_it = ref.begin();
+            for (int j = 0; j < pos; j++) {
+                ++it;
+                ++ref_it;
+            }
+            auto next = lst.erase(it);
+            auto ref_next = ref.erase(ref_it);
+            if (ref_next != ref.end())
+                REQUIRE(*next == *ref_next);
+            else
+                REQUIRE(next == lst.end());
+        }
+        REQUIRE(std::equal(lst.begin(), lst.end(), ref.begin(), ref.end()));
+        REQUIRE(std::equal(lst.rbegin(), lst.rend(), ref.rbegin(), ref.rend()));
+    }
+
+    SECTION("test push_front() push_back() pop_front() pop_back()") {
+        UnrolledList<std::string, 3> lst;
+        for (int i = 0; i < 10; i++) {
+            lst.push_back(std::to_string(i));
+            lst.emplace_front(std::to_string(-i));
+        }
+        REQUIRE(lst.front() == "-9");
+        REQUIRE(lst.back() == "9");
+        lst.pop_front();
+        lst.pop_back();
+        REQUIRE(lst.front() == "-8");
+        REQUIRE(lst.back() == "8");
+        REQUIRE(lst.size() == 18);
+    }
+
+    SECTION("test for_each_chunk()") {
+        UnrolledList<int, 8> lst;
+        for (int i = 0; i < 20; i++)
+            lst.push_back(i);
+        size_t total = 0;
+        int expected = 0;
+        lst.for_each_chunk([&](std::span<int> chunk) {
+            REQUIRE(chunk.size() <= 8);
+            for (int v : chunk)
+                REQUIRE(v == expected++);
+            total += chunk.size();
+        });
+        REQUIRE(total == 20);
+    }
+
+    SECTION("test emplace() with aliasing and throwing arguments") {
+        UnrolledList<std::string, 3> lst;
+        for (int i = 0; i < 7; i++)
+            lst.push_back(std::string(20, char('a' + i)));
+        lst.push_front(lst.front());
+        REQUIRE(lst.front() == std::string(20, 'a'));
+        auto pos = std::next(lst.begin(), 4);
+        lst.insert(pos, *pos);
+        REQUIRE(*std::next(lst.begin(), 4) == *std::next(lst.begin(), 5));
+        lst.insert(lst.end(), lst.back());
+        REQUIRE(lst.back() == std::string(20, 'g'));
+        REQUIRE(lst.size() == 10);
+
+        // std::string(str, pos) throws std::out_of_range for pos > str.size()
+        std::list<std::string> ref(lst.begin(), lst.end());
+        for (size_t i = 0; i <= lst.size(); i++) {
+            REQUIRE_THROWS_AS(lst.emplace(std::next(lst.cbegin(), i), std::string(), 1), std::out_of_range);
+            REQUIRE(lst.size() == ref.size());
+            REQUIRE(std::equal(lst.begin(), lst.end(), ref.begin(), ref.end()));
+            REQUIRE(std::equal(lst.rbegin(), lst.rend(), ref.rbegin(), ref.rend()));
+        }
+        UnrolledList<std::string, 3> empty;
+        REQUIRE_THROWS_AS(empty.emplace_back(std::string(), 1), std::out_of_range);
+        REQUIRE(empty.empty());
+        REQUIRE(empty.begin() == empty.end());
+    }
+}
@@ -3,6 +3,9 @@
 #include <miniSTL/stl.hpp>
 #include <vector>
 #include <list>
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
 
 struct M_int {
     int m_value;
@@ -102,4 +105,96 @@ TEST_CASE("test vector", "[vector]") {
         REQUIRE(a == a);
         REQUIRE_FALSE(a == b);
     }
+
+    SECTION("test adopt() release() to_std_vector()") {
+        Vector<M_int> m_vec({0, 1, 2});
+        size_t size = m_vec.size(), cap = m_vec.capacity();
+        M_int *buf = m_vec.release();
+        REQUIRE(m_vec.size() == 0);
+        REQUIRE(m_vec.data() == nullptr);
+
+        Vector<M_int> other;
+        other.adopt(buf, size, cap);
+        REQUIRE(other.data() == buf);
+        for (int i = 0; i < 3; i++)
+            REQUIRE(other[i].m_value == i);
+
+        std::vector<M_int> std_vec = std::move(other).to_std_vector();
+        REQUIRE(std_vec.size() == 3);
+        Vector<M_int> back(std::move(std_vec));
+        REQUIRE(back.size() == 3);
+        for (int i = 0; i < 3; i++)
+            REQUIRE(back[i].m_value == i);
+
+        std::pmr::monotonic_buffer_resource pool;
+        Vector<int, std::pmr::polymorphic_allocator<int>> pmr_vec({1, 2, 3}, &pool);
+        size_t pmr_size = pmr_vec.size(), pmr_cap = pmr_vec.capacity();
+        int *pmr_buf = pmr_vec.release();
+        Vector<int, std::pmr::polymorphic_allocator<int>> pmr_other(&pool);
+        pmr_other.adopt(pmr_buf, pmr_size, pmr_cap);
+        REQUIRE(pmr_other.size() == 3);
+        REQUIRE(pmr_other[2] == 3);
+    }
+
+    SECTION("test emplace_back() emplace()") {
+        Vector<M_int> m_vec;
+        for (int i = 0; i < 10; i++)
+            REQUIRE(m_vec.emplace_back(i).m_value == i);
+        REQUIRE(m_vec.size() == 10);
+        m_vec.emplace(m_vec.begin() + 5, -1);
+        REQUIRE(m_vec[5].m_value == -1);
+        REQUIRE(m_vec[6].m_value == 5);
+        m_vec.emplace(m_vec.end(), 100);
+        REQUIRE(m_vec.back().m_value == 100);
+        m_vec.emplace_back(m_vec[0]);
+        REQUIRE(m_vec.back().m_value == 0);
+        m_vec.emplace(m_vec.begin(), m_vec.back());
+        REQUIRE(m_vec.front().m_value == 0);
+
+        Vector<std::string> strs(4, std::string(32, 'x'));
+        REQUIRE_THROWS_AS(strs.emplace(strs.begin() + 1, std::string(), 1), std::out_of_range);
+        REQUIRE(strs.size() == 4);
+        for (auto const &str : strs)
+            REQUIRE(str == std::string(32, 'x'));
+    }
+
+    SECTION("test pmr allocator propagation") {
+        using PmrVector = Vector<M_int, std::pmr::polymorphic_allocator<M_int>>;
+        std::pmr::monotonic_buffer_resource arena;
+        std::pmr::monotonic_buffer_resource other_arena;
+
+        PmrVector a(tmp_vec.begin(), tmp_vec.end(), &arena);
+        REQUIRE(a.get_allocator().resource() == &arena);
+        PmrVector b(3, M_int(7), &arena);
+        REQUIRE(b.get_allocator().resource() == &arena);
+
+        PmrVector copy(a);
+        REQUIRE(copy.get_allocator().resource() == std::pmr::get_default_resource());
+        PmrVector moved(std::move(copy), &other_arena);
+        REQUIRE(moved.get_allocator().resource() == &other_arena);
+        REQUIRE(moved == a);
+
+        b = a;
+        REQUIRE(b.get_allocator().resource() == &arena);
+        REQUIRE(b == a);
+        b = std::move(moved);
+        REQUIRE(b.get_allocator().resource() == &arena);
+        REQUIRE(b == a);
+
+        Vector<std::pmr::string, std::pmr::polymorphic_allocator<std::pmr::string>> strs(&arena);
+        strs.emplace_back("a string long enough to skip the small buffer");
+        REQUIRE(strs[0].get_allocator().resource() == &arena);
+        // emplace() builds its temporary with the arena too, never the default resource
+        std::pmr::memory_resource *prev = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+        bool threw = false;
+        try {
+            strs.emplace(strs.begin(), "another string long enough to skip the small buffer");
+        } catch (std::bad_alloc const &) {
+            threw = true;
+        }
+        std::pmr::set_default_resource(prev);
+        REQUIRE_FALSE(threw);
+        REQUIRE(strs[0].get_allocator().resource() == &arena);
+        REQUIRE(strs[1] == "a string long enough to skip the small buffer");
+    }
 }